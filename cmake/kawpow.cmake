@@ -3,12 +3,16 @@ if (WITH_KAWPOW)
 
     list(APPEND HEADERS_CRYPTO
         src/crypto/kawpow/KPCache.h
+        src/crypto/kawpow/KPDag.h
         src/crypto/kawpow/KPHash.h
+        src/crypto/kawpow/KPProgram.h
     )
 
     list(APPEND SOURCES_CRYPTO
         src/crypto/kawpow/KPCache.cpp
+        src/crypto/kawpow/KPDag.cpp
         src/crypto/kawpow/KPHash.cpp
+        src/crypto/kawpow/KPProgram.cpp
     )
 
     add_subdirectory(src/3rdparty/libethash)
@@ -0,0 +1,23 @@
+if (WITH_MICROBENCH)
+    set(HEADERS_MICROBENCH
+        src/microbench/Microbench.h
+        )
+
+    set(SOURCES_MICROBENCH
+        src/microbench/Microbench.cpp
+        src/microbench/MicrobenchCases.cpp
+        src/microbench/microbench.cpp
+        )
+
+    # Same sources as the miner itself, only main() is replaced.
+    set(SOURCES_MICROBENCH_MINER ${SOURCES})
+    list(REMOVE_ITEM SOURCES_MICROBENCH_MINER src/xmrig.cpp)
+
+    add_executable(xmrig-microbench ${HEADERS_MICROBENCH} ${SOURCES_MICROBENCH} ${HEADERS} ${SOURCES_MICROBENCH_MINER} ${SOURCES_OS} ${HEADERS_CRYPTO} ${SOURCES_CRYPTO} ${SOURCES_SYSLOG} ${TLS_SOURCES} ${XMRIG_ASM_SOURCES})
+    target_link_libraries(xmrig-microbench ${XMRIG_ASM_LIBRARY} ${OPENSSL_LIBRARIES} ${UV_LIBRARIES} ${EXTRA_LIBS} ${CPUID_LIB} ${ARGON2_LIBRARY} ${ETHASH_LIBRARY} ${GHOSTRIDER_LIBRARY})
+
+    if (WITH_VULKAN)
+        target_include_directories(xmrig-microbench PUBLIC tart/include)
+        target_link_libraries(xmrig-microbench tart)
+    endif()
+endif()
@@ -23,6 +23,7 @@ if (WITH_RANDOMX)
         src/crypto/rx/RxCache.h
         src/crypto/rx/RxConfig.h
         src/crypto/rx/RxDataset.h
+        src/crypto/rx/RxDatasetSnapshot.h
         src/crypto/rx/RxQueue.h
         src/crypto/rx/RxSeed.h
         src/crypto/rx/RxVm.h
@@ -52,6 +53,7 @@ if (WITH_RANDOMX)
         src/crypto/rx/RxCache.cpp
         src/crypto/rx/RxConfig.cpp
         src/crypto/rx/RxDataset.cpp
+        src/crypto/rx/RxDatasetSnapshot.cpp
         src/crypto/rx/RxQueue.cpp
         src/crypto/rx/RxVm.cpp
     )
@@ -102,6 +104,18 @@ if (WITH_RANDOMX)
         endif()
     endif()
 
+    if (WITH_VAES)
+        list(APPEND SOURCES_CRYPTO
+             src/crypto/randomx/aes_hash_vaes.cpp
+             src/crypto/randomx/aes_hash_vaes512.cpp
+            )
+
+        if (CMAKE_C_COMPILER_ID MATCHES GNU OR CMAKE_C_COMPILER_ID MATCHES Clang)
+            set_source_files_properties(src/crypto/randomx/aes_hash_vaes.cpp PROPERTIES COMPILE_FLAGS "-O3 -mavx2 -mvaes")
+            set_source_files_properties(src/crypto/randomx/aes_hash_vaes512.cpp PROPERTIES COMPILE_FLAGS "-O3 -mavx512f -mvaes")
+        endif()
+    endif()
+
     if (CMAKE_CXX_COMPILER_ID MATCHES Clang)
         set_source_files_properties(src/crypto/randomx/jit_compiler_x86.cpp PROPERTIES COMPILE_FLAGS -Wno-unused-const-variable)
     endif()
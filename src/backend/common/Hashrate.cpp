@@ -18,6 +18,7 @@
  */
 
 
+#include <algorithm>
 #include <cassert>
 #include <memory.h>
 #include <cstdio>
@@ -44,15 +45,7 @@ inline static const char *format(std::pair<bool, double> h, char *buf, size_t si
 xmrig::Hashrate::Hashrate(size_t threads) :
     m_threads(threads + 1)
 {
-    m_counts     = new uint64_t*[m_threads];
-    m_timestamps = new uint64_t*[m_threads];
-    m_top        = new uint32_t[m_threads];
-
-    for (size_t i = 0; i < m_threads; i++) {
-        m_counts[i]     = new uint64_t[kBucketSize]();
-        m_timestamps[i] = new uint64_t[kBucketSize]();
-        m_top[i]        = 0;
-    }
+    m_data = new Data[m_threads];
 
     m_earliestTimestamp = std::numeric_limits<uint64_t>::max();
     m_totalCount = 0;
@@ -61,15 +54,7 @@ xmrig::Hashrate::Hashrate(size_t threads) :
 
 xmrig::Hashrate::~Hashrate()
 {
-    for (size_t i = 0; i < m_threads; i++) {
-        delete [] m_counts[i];
-        delete [] m_timestamps[i];
-    }
-
-    delete [] m_counts;
-    delete [] m_timestamps;
-    delete [] m_top;
-
+    delete [] m_data;
 }
 
 
@@ -120,6 +105,31 @@ rapidjson::Value xmrig::Hashrate::toJSON(size_t threadId, rapidjson::Document &d
 
     return out;
 }
+
+
+rapidjson::Value xmrig::Hashrate::statsToJSON(size_t threadId, rapidjson::Document &doc) const
+{
+    using namespace rapidjson;
+
+    const size_t index = threadId + 1;
+    if (index >= m_threads || m_data[index].samplesCount < 2) {
+        return Value(kNullType);
+    }
+
+    auto &allocator = doc.GetAllocator();
+
+    double percentiles[3];
+    double jitter;
+    stats(m_data[index], percentiles, jitter);
+
+    Value out(kObjectType);
+    out.AddMember("p5",     normalize({ true, percentiles[0] }), allocator);
+    out.AddMember("p50",    normalize({ true, percentiles[1] }), allocator);
+    out.AddMember("p95",    normalize({ true, percentiles[2] }), allocator);
+    out.AddMember("jitter", normalize({ true, jitter }), allocator);
+
+    return out;
+}
 #endif
 
 
@@ -130,47 +140,61 @@ std::pair<bool, double> xmrig::Hashrate::hashrate(size_t index, size_t ms) const
         return { false, 0.0 };
     }
 
-    uint64_t earliestHashCount = 0;
-    uint64_t earliestStamp     = 0;
-    bool haveFullSet           = false;
+    switch (ms) {
+    case ShortInterval:
+        return m_data[index].rates[0];
+
+    case MediumInterval:
+        return m_data[index].rates[1];
+
+    case LargeInterval:
+        return m_data[index].rates[2];
 
-    const uint64_t timeStampLimit = xmrig::Chrono::steadyMSecs() - ms;
-    uint64_t* timestamps          = m_timestamps[index];
-    uint64_t* counts              = m_counts[index];
+    default:
+        break;
+    }
+
+    return rate(m_data[index], ms);
+}
 
-    const size_t idx_start  = (m_top[index] - 1) & kBucketMask;
-    size_t idx              = idx_start;
 
-    uint64_t lastestStamp   = timestamps[idx];
-    uint64_t lastestHashCnt = counts[idx];
+std::pair<bool, double> xmrig::Hashrate::rate(const Data &data, size_t ms) const
+{
+    const Sample &latest = data.latest;
 
-    do {
-        if (timestamps[idx] < timeStampLimit) {
-            haveFullSet = (timestamps[idx] != 0);
-            if (idx != idx_start) {
-                idx = (idx + 1) & kBucketMask;
-                earliestStamp = timestamps[idx];
-                earliestHashCount = counts[idx];
-            }
+    if (latest.timestamp <= ms || data.earliest >= latest.timestamp - ms) {
+        return { false, 0.0 };
+    }
+
+    // The earliest sample newer than the window start is the first sample of the next bucket,
+    // buckets may be empty only if ticks were skipped, so the loop is normally a single lookup.
+    const uint64_t limit    = latest.timestamp - ms;
+    const uint64_t last     = latest.timestamp / kResolution;
+    uint64_t bucket         = limit / kResolution + 1;
+
+    const Sample *earliest = nullptr;
+    for (; bucket <= last; ++bucket) {
+        const Sample &sample = data.buckets[bucket % kBucketSize];
+        if (sample.timestamp / kResolution == bucket) {
+            earliest = &sample;
             break;
         }
-        idx = (idx - 1) & kBucketMask;
-    } while (idx != idx_start);
+    }
 
-    if (!haveFullSet || earliestStamp == 0 || lastestStamp == 0) {
+    if (!earliest || earliest->timestamp == 0 || earliest->count > latest.count) {
         return { false, 0.0 };
     }
 
-    if (lastestHashCnt == earliestHashCount) {
+    if (latest.count == earliest->count) {
         return { true, 0.0 };
     }
 
-    if (lastestStamp == earliestStamp) {
+    if (latest.timestamp == earliest->timestamp) {
         return { false, 0.0 };
     }
 
-    const auto hashes = static_cast<double>(lastestHashCnt - earliestHashCount);
-    const auto time   = static_cast<double>(lastestStamp - earliestStamp);
+    const auto hashes = static_cast<double>(latest.count - earliest->count);
+    const auto time   = static_cast<double>(latest.timestamp - earliest->timestamp);
 
     const auto hr = hashes * 1000.0 / time;
 
@@ -184,11 +208,30 @@ std::pair<bool, double> xmrig::Hashrate::hashrate(size_t index, size_t ms) const
 
 void xmrig::Hashrate::addData(size_t index, uint64_t count, uint64_t timestamp)
 {
-    const size_t top         = m_top[index];
-    m_counts[index][top]     = count;
-    m_timestamps[index][top] = timestamp;
+    Data &data            = m_data[index];
+    const uint64_t bucket = timestamp / kResolution;
+
+    if (data.earliest == 0) {
+        data.earliest = timestamp;
+    }
+
+    if (data.current.timestamp == 0 || data.current.timestamp / kResolution != bucket) {
+        // Hashrate between the first samples of two adjacent buckets feeds percentiles and jitter.
+        if (data.current.timestamp / kResolution + 1 == bucket && count >= data.current.count && timestamp > data.current.timestamp) {
+            addSample(data, (count - data.current.count) * 1000.0 / (timestamp - data.current.timestamp));
+        }
 
-    m_top[index] = (top + 1) & kBucketMask;
+        data.current.count                       = count;
+        data.current.timestamp                   = timestamp;
+        data.buckets[bucket % kBucketSize]       = data.current;
+    }
+
+    data.latest.count     = count;
+    data.latest.timestamp = timestamp;
+
+    data.rates[0] = rate(data, ShortInterval);
+    data.rates[1] = rate(data, MediumInterval);
+    data.rates[2] = rate(data, LargeInterval);
 
     if (index == 0) {
         if (m_earliestTimestamp == std::numeric_limits<uint64_t>::max()) {
@@ -197,3 +240,40 @@ void xmrig::Hashrate::addData(size_t index, uint64_t count, uint64_t timestamp)
         m_totalCount = count;
     }
 }
+
+
+void xmrig::Hashrate::addSample(Data &data, double value)
+{
+    data.samples[data.samplesTop] = value;
+    data.samplesTop               = (data.samplesTop + 1) % kStatsSize;
+    data.samplesCount             = std::min(data.samplesCount + 1, kStatsSize);
+}
+
+
+// 5th, 50th and 95th percentile of the samples and their standard deviation relative to the mean, %.
+void xmrig::Hashrate::stats(const Data &data, double percentiles[3], double &jitter) const
+{
+    const size_t count = data.samplesCount;
+
+    double sorted[kStatsSize];
+    std::copy(data.samples, data.samples + count, sorted);
+    std::sort(sorted, sorted + count);
+
+    percentiles[0] = sorted[(count - 1) * 5 / 100];
+    percentiles[1] = sorted[(count - 1) * 50 / 100];
+    percentiles[2] = sorted[(count - 1) * 95 / 100];
+
+    double mean = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        mean += sorted[i];
+    }
+    mean /= count;
+
+    double variance = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        variance += (sorted[i] - mean) * (sorted[i] - mean);
+    }
+    variance /= count;
+
+    jitter = mean > 0.0 ? std::sqrt(variance) * 100.0 / mean : 0.0;
+}
@@ -61,19 +61,42 @@ public:
 #   ifdef XMRIG_FEATURE_API
     rapidjson::Value toJSON(rapidjson::Document &doc) const;
     rapidjson::Value toJSON(size_t threadId, rapidjson::Document &doc) const;
+    rapidjson::Value statsToJSON(size_t threadId, rapidjson::Document &doc) const;
 #   endif
 
 private:
+    constexpr static size_t kResolution = 1000;
+    constexpr static size_t kBucketSize = LargeInterval / kResolution + 2;
+    constexpr static size_t kStatsSize  = MediumInterval / kResolution;
+
+    struct Sample
+    {
+        uint64_t count      = 0;
+        uint64_t timestamp  = 0;
+    };
+
+    // Per-thread state, updated only by addData(), so every read is a constant time lookup.
+    struct Data
+    {
+        Sample latest;
+        Sample current;                         // first sample of the current bucket
+        Sample buckets[kBucketSize];            // first sample of each bucket, indexed by (timestamp / kResolution) % kBucketSize
+        uint64_t earliest                   = 0;
+        std::pair<bool, double> rates[3]    = { { false, 0.0 }, { false, 0.0 }, { false, 0.0 } };
+
+        double samples[kStatsSize]          = {};   // per-bucket hashrate, ring buffer, percentiles and jitter are computed only when read
+        size_t samplesCount                 = 0;
+        size_t samplesTop                   = 0;
+    };
+
     std::pair<bool, double> hashrate(size_t index, size_t ms) const;
+    std::pair<bool, double> rate(const Data &data, size_t ms) const;
     void addData(size_t index, uint64_t count, uint64_t timestamp);
-
-    constexpr static size_t kBucketSize = 2 << 11;
-    constexpr static size_t kBucketMask = kBucketSize - 1;
+    void addSample(Data &data, double value);
+    void stats(const Data &data, double percentiles[3], double &jitter) const;
 
     size_t m_threads;
-    uint32_t* m_top;
-    uint64_t** m_counts;
-    uint64_t** m_timestamps;
+    Data *m_data;
 
     uint64_t m_earliestTimestamp;
     uint64_t m_totalCount;
@@ -0,0 +1,357 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "backend/common/JobSwitch.h"
+#include "backend/common/Tags.h"
+#include "base/io/log/Log.h"
+#include "base/net/stratum/Job.h"
+#include "base/tools/Chrono.h"
+
+
+#ifdef XMRIG_FEATURE_API
+#   include "3rdparty/rapidjson/document.h"
+#   include "base/api/Metrics.h"
+#endif
+
+
+#include <atomic>
+#include <cstdio>
+
+
+namespace xmrig {
+
+
+static const char *kBackendNames[Nonce::MAX]   = { "cpu", "opencl", "vulkan", "cuda" };
+static constexpr uint64_t kSequenceMask         = 0xFFFFFFFFFFFFULL;
+
+
+class JobSwitchHistogram
+{
+public:
+    static constexpr size_t kBuckets = 16;
+
+    inline uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    inline double avg() const     { const uint64_t n = count(); return n ? (m_sum.load(std::memory_order_relaxed) / 1000.0 / n) : 0.0; }
+
+    inline void add(double ms)
+    {
+        size_t i = 0;
+        while (i < kBuckets - 1 && ms > kBounds[i]) {
+            ++i;
+        }
+
+        m_counts[i].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(static_cast<uint64_t>(ms > 0.0 ? ms * 1000.0 : 0.0), std::memory_order_relaxed);
+    }
+
+
+    // Upper bound of the bucket containing the quantile, values in the last bucket are reported as the last bound.
+    double quantile(double q) const
+    {
+        const uint64_t n = count();
+        if (!n) {
+            return 0.0;
+        }
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBuckets - 1; ++i) {
+            total += m_counts[i].load(std::memory_order_relaxed);
+
+            if (total >= q * n) {
+                return kBounds[i];
+            }
+        }
+
+        return kBounds[kBuckets - 2];
+    }
+
+
+#   ifdef XMRIG_FEATURE_API
+    static rapidjson::Value bounds(rapidjson::Document &doc)
+    {
+        using namespace rapidjson;
+
+        Value out(kArrayType);
+        for (double bound : kBounds) {
+            out.PushBack(bound, doc.GetAllocator());
+        }
+
+        return out;
+    }
+
+
+    rapidjson::Value toJSON(rapidjson::Document &doc) const
+    {
+        using namespace rapidjson;
+        auto &allocator = doc.GetAllocator();
+
+        Value out(kObjectType);
+        out.AddMember("count",  count(), allocator);
+        out.AddMember("avg_ms", avg(), allocator);
+        out.AddMember("p50_ms", quantile(0.5), allocator);
+        out.AddMember("p99_ms", quantile(0.99), allocator);
+
+        Value counts(kArrayType);
+        for (const auto &value : m_counts) {
+            counts.PushBack(value.load(std::memory_order_relaxed), allocator);
+        }
+
+        out.AddMember("histogram", counts, allocator);
+
+        return out;
+    }
+
+
+    void toMetrics(Metrics &metrics, const char *backend) const
+    {
+        char labels[64];
+        uint64_t total = 0;
+
+        for (size_t i = 0; i < kBuckets; ++i) {
+            total += m_counts[i].load(std::memory_order_relaxed);
+
+            if (i < kBuckets - 1) {
+                snprintf(labels, sizeof(labels), "backend=\"%s\",le=\"%g\"", backend, kBounds[i] / 1000.0);
+            }
+            else {
+                snprintf(labels, sizeof(labels), "backend=\"%s\",le=\"+Inf\"", backend);
+            }
+
+            metrics.add(total, labels, "_bucket");
+        }
+
+        snprintf(labels, sizeof(labels), "backend=\"%s\"", backend);
+
+        metrics.add(m_sum.load(std::memory_order_relaxed) / 1e6, labels, "_sum");
+        metrics.add(total, labels, "_count");
+    }
+#   endif
+
+private:
+    static constexpr double kBounds[kBuckets - 1] = { 0.05, 0.1, 0.2, 0.5, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 5000 };
+
+    std::atomic<uint64_t> m_counts[kBuckets]{};
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<uint64_t> m_sum{ 0 };
+};
+
+
+constexpr double JobSwitchHistogram::kBounds[];
+
+
+// Written by the main thread in dispatch(), timestamps are published by the release store of the sequence.
+struct JobSwitchState
+{
+    std::atomic<double> dispatch{ 0.0 };
+    std::atomic<double> notify{ 0.0 };
+    std::atomic<uint32_t> workers{ 0 };
+    std::atomic<uint64_t> consumed{ 0 };
+    std::atomic<uint64_t> delay{ 0 };
+    std::atomic<uint64_t> hashed{ 0 };
+    std::atomic<uint64_t> sequence{ 0 };
+    std::atomic<uint64_t> switches{ 0 };
+    JobSwitchHistogram drain;
+    JobSwitchHistogram latency;
+};
+
+
+static JobSwitchState states[Nonce::MAX];
+
+
+} // namespace xmrig
+
+
+double xmrig::JobSwitch::timerCost()
+{
+    static const double cost = [] {
+        constexpr size_t count = 1000;
+
+        double sink         = 0.0;
+        const double start  = Chrono::highResolutionMSecs();
+
+        for (size_t i = 0; i < count; ++i) {
+            sink += Chrono::highResolutionMSecs();
+        }
+
+        return (Chrono::highResolutionMSecs() - start) * 1e6 / count + (sink < 0.0 ? 1.0 : 0.0);
+    }();
+
+    return cost;
+}
+
+
+void xmrig::JobSwitch::dispatch(const Job &job)
+{
+    const double now    = Chrono::highResolutionMSecs();
+    const double notify = job.timestamp() > 0.0 ? job.timestamp() : now;
+
+    for (uint32_t backend = 0; backend < Nonce::MAX; ++backend) {
+        auto &state             = states[backend];
+        const uint64_t current  = Nonce::sequence(static_cast<Nonce::Backend>(backend));
+
+        if (current == 0 || state.workers.load(std::memory_order_relaxed) == 0) {
+            state.sequence.store(0, std::memory_order_release);
+
+            continue;
+        }
+
+        // The caller increments the sequence right after this call, workers see the new job with sequence + 1.
+        const uint64_t sequence = current + 1;
+
+        state.notify.store(notify, std::memory_order_relaxed);
+        state.dispatch.store(now, std::memory_order_relaxed);
+        state.consumed.store((sequence & kSequenceMask) << 16, std::memory_order_relaxed);
+        state.hashed.store(0, std::memory_order_relaxed);
+        state.sequence.store(sequence, std::memory_order_release);
+
+        state.switches.fetch_add(1, std::memory_order_relaxed);
+        state.delay.fetch_add(static_cast<uint64_t>((now - notify) * 1000.0), std::memory_order_relaxed);
+    }
+}
+
+
+void xmrig::JobSwitch::print()
+{
+    for (uint32_t backend = 0; backend < Nonce::MAX; ++backend) {
+        const auto &state = states[backend];
+        if (!state.latency.count()) {
+            continue;
+        }
+
+        LOG_INFO("%s " WHITE_BOLD("job switch") " notify/first hash avg/p99 " CYAN_BOLD("%.2f/%.2f ms") " drain avg/p99 " CYAN_BOLD("%.2f/%.2f ms") BLACK_BOLD(" (%" PRIu64 " switches)"),
+                 backend_tag(backend),
+                 state.latency.avg(), state.latency.quantile(0.99),
+                 state.drain.avg(), state.drain.quantile(0.99),
+                 state.switches.load(std::memory_order_relaxed)
+                 );
+    }
+}
+
+
+void xmrig::JobSwitch::setWorkers(Nonce::Backend backend, size_t workers)
+{
+    timerCost();
+
+    states[backend].workers.store(static_cast<uint32_t>(workers), std::memory_order_relaxed);
+    states[backend].sequence.store(0, std::memory_order_release);
+}
+
+
+#ifdef XMRIG_FEATURE_API
+rapidjson::Value xmrig::JobSwitch::toJSON(rapidjson::Document &doc)
+{
+    using namespace rapidjson;
+    auto &allocator = doc.GetAllocator();
+
+    Value out(kObjectType);
+    out.AddMember("timer_ns",   timerCost(), allocator);
+    out.AddMember("bounds_ms",  JobSwitchHistogram::bounds(doc), allocator);
+
+    for (uint32_t backend = 0; backend < Nonce::MAX; ++backend) {
+        const auto &state       = states[backend];
+        const uint64_t switches = state.switches.load(std::memory_order_relaxed);
+        if (!switches) {
+            continue;
+        }
+
+        Value value(kObjectType);
+        value.AddMember("switches",     switches, allocator);
+        value.AddMember("workers",      state.workers.load(std::memory_order_relaxed), allocator);
+        value.AddMember("dispatch_ms",  state.delay.load(std::memory_order_relaxed) / 1000.0 / switches, allocator);
+        value.AddMember("first_hash",   state.latency.toJSON(doc), allocator);
+        value.AddMember("drain",        state.drain.toJSON(doc), allocator);
+
+        out.AddMember(StringRef(kBackendNames[backend]), value, allocator);
+    }
+
+    return out;
+}
+
+
+void xmrig::JobSwitch::toMetrics(Metrics &metrics)
+{
+    char labels[32];
+
+    for (uint32_t backend = 0; backend < Nonce::MAX; ++backend) {
+        const auto &state = states[backend];
+        if (!state.switches.load(std::memory_order_relaxed)) {
+            continue;
+        }
+
+        snprintf(labels, sizeof(labels), "backend=\"%s\"", kBackendNames[backend]);
+
+        metrics.set("xmrig_job_switches_total", Metrics::COUNTER, "Jobs dispatched to the backend workers.");
+        metrics.add(state.switches.load(std::memory_order_relaxed), labels);
+
+        metrics.set("xmrig_job_switch_latency_seconds", Metrics::HISTOGRAM, "Time from the pool job notification to the first hash on the new job.");
+        state.latency.toMetrics(metrics, kBackendNames[backend]);
+
+        metrics.set("xmrig_job_switch_drain_seconds", Metrics::HISTOGRAM, "Time from the job dispatch until the last worker dropped the old job.");
+        state.drain.toMetrics(metrics, kBackendNames[backend]);
+    }
+}
+#endif
+
+
+bool xmrig::JobSwitch::consumed(Nonce::Backend backend, uint64_t sequence)
+{
+    auto &state = states[backend];
+    if (state.sequence.load(std::memory_order_acquire) != sequence) {
+        return false;
+    }
+
+    // The counter is tagged with the sequence, so a late worker can't count towards the next job.
+    uint64_t value = state.consumed.load(std::memory_order_relaxed);
+    do {
+        if ((value >> 16) != (sequence & kSequenceMask)) {
+            return false;
+        }
+    }
+    while (!state.consumed.compare_exchange_weak(value, value + 1, std::memory_order_relaxed));
+
+    if ((value & 0xFFFF) + 1 == state.workers.load(std::memory_order_relaxed)) {
+        const double ms = Chrono::highResolutionMSecs() - state.dispatch.load(std::memory_order_relaxed);
+
+        if (state.sequence.load(std::memory_order_acquire) == sequence) {
+            state.drain.add(ms);
+        }
+    }
+
+    return true;
+}
+
+
+void xmrig::JobSwitch::hashed(Nonce::Backend backend, uint64_t sequence)
+{
+    auto &state = states[backend];
+    if (state.sequence.load(std::memory_order_acquire) != sequence) {
+        return;
+    }
+
+    uint64_t prev = state.hashed.load(std::memory_order_relaxed);
+    if (prev == sequence || !state.hashed.compare_exchange_strong(prev, sequence, std::memory_order_relaxed)) {
+        return;
+    }
+
+    const double ms = Chrono::highResolutionMSecs() - state.notify.load(std::memory_order_relaxed);
+
+    if (state.sequence.load(std::memory_order_acquire) == sequence) {
+        state.latency.add(ms);
+    }
+}
@@ -0,0 +1,90 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_JOBSWITCH_H
+#define XMRIG_JOBSWITCH_H
+
+
+#include "3rdparty/rapidjson/fwd.h"
+#include "crypto/common/Nonce.h"
+
+
+namespace xmrig {
+
+
+class Job;
+class Metrics;
+
+
+/**
+ * Job switch latency, tracked separately for each backend.
+ *
+ * Stages: the job is parsed from the pool notification (Job::timestamp()), dispatched to the workers by the miner,
+ * consumed by every worker and finally the first batch of hashes on the new job is done. Two histograms are kept:
+ * notification to the first hash and dispatch to the moment the last worker dropped the old job.
+ */
+class JobSwitch
+{
+public:
+    // Per worker state, hashed() is a single branch after the first batch on a job.
+    class Probe
+    {
+    public:
+        inline void consumed(Nonce::Backend backend, uint64_t sequence)
+        {
+            if (sequence != m_sequence) {
+                m_backend   = backend;
+                m_sequence  = sequence;
+                m_pending   = JobSwitch::consumed(backend, sequence);
+            }
+        }
+
+        inline void hashed()
+        {
+            if (m_pending) {
+                m_pending = false;
+                JobSwitch::hashed(m_backend, m_sequence);
+            }
+        }
+
+    private:
+        bool m_pending              = false;
+        Nonce::Backend m_backend    = Nonce::CPU;
+        uint64_t m_sequence         = 0;
+    };
+
+    static double timerCost();
+    static void dispatch(const Job &job);
+    static void print();
+    static void setWorkers(Nonce::Backend backend, size_t workers);
+
+#   ifdef XMRIG_FEATURE_API
+    static rapidjson::Value toJSON(rapidjson::Document &doc);
+    static void toMetrics(Metrics &metrics);
+#   endif
+
+private:
+    static bool consumed(Nonce::Backend backend, uint64_t sequence);
+    static void hashed(Nonce::Backend backend, uint64_t sequence);
+};
+
+
+} // namespace xmrig
+
+
+#endif // XMRIG_JOBSWITCH_H
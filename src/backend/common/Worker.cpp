@@ -19,6 +19,7 @@
 
 #include "backend/common/Worker.h"
 #include "base/kernel/Platform.h"
+#include "crypto/common/Nonce.h"
 #include "crypto/common/VirtualMemory.h"
 
 
@@ -27,6 +28,7 @@ xmrig::Worker::Worker(size_t id, int64_t affinity, int priority) :
     m_id(id)
 {
     m_node = VirtualMemory::bindToNUMANode(affinity);
+    Nonce::setNode(m_node);
 
     Platform::trySetThreadAffinity(affinity);
     Platform::setThreadPriority(priority);
@@ -21,6 +21,7 @@
 
 
 #include "backend/common/interfaces/IWorker.h"
+#include "backend/common/JobSwitch.h"
 
 
 namespace xmrig {
@@ -38,6 +39,7 @@ protected:
     inline size_t id() const override                       { return m_id; }
     inline uint32_t node() const                            { return m_node; }
 
+    JobSwitch::Probe m_switch;
     uint64_t m_count                = 0;
 
 private:
@@ -18,6 +18,7 @@
 
 #include "backend/common/Workers.h"
 #include "backend/common/Hashrate.h"
+#include "backend/common/JobSwitch.h"
 #include "backend/common/interfaces/IBackend.h"
 #include "backend/cpu/CpuWorker.h"
 #include "base/io/log/Log.h"
@@ -137,6 +138,7 @@ void xmrig::Workers<T>::stop()
 {
 #   ifdef XMRIG_MINER_PROJECT
     Nonce::stop(T::backend());
+    JobSwitch::setWorkers(T::backend(), 0);
 #   endif
 
     for (Thread<T> *worker : m_workers) {
@@ -213,6 +215,7 @@ void xmrig::Workers<T>::start(const std::vector<T> &data, bool /*sleep*/)
 
 #   ifdef XMRIG_MINER_PROJECT
     Nonce::touch(T::backend());
+    JobSwitch::setWorkers(T::backend(), m_workers.size());
 #   endif
 
     for (auto worker : m_workers) {
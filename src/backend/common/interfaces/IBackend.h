@@ -36,6 +36,7 @@ class Hashrate;
 class IApiRequest;
 class IWorker;
 class Job;
+class Metrics;
 class String;
 
 
@@ -64,6 +65,7 @@ public:
 #   ifdef XMRIG_FEATURE_API
     virtual rapidjson::Value toJSON(rapidjson::Document &doc) const     = 0;
     virtual void handleRequest(IApiRequest &request)                    = 0;
+    virtual void toMetrics(Metrics &metrics) const                      = 0;
 #   endif
 
 #   ifdef XMRIG_FEATURE_BENCHMARK
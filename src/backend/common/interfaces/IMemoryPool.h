@@ -21,6 +21,7 @@
 
 
 #include "base/tools/Object.h"
+#include "crypto/common/HugePagesInfo.h"
 
 
 #include <cstddef>
@@ -30,6 +31,33 @@
 namespace xmrig {
 
 
+class MemoryPoolInfo
+{
+public:
+    HugePagesInfo hugePages;
+    size_t blocks   = 0;    // live allocations
+    size_t largest  = 0;    // largest free block, summed over NUMA nodes
+    size_t misses   = 0;    // requests that didn't fit and fell back to regular allocation
+    size_t size     = 0;
+    size_t used     = 0;
+
+    inline size_t free() const              { return size - used; }
+    inline double fragmentation() const     { return free() == 0 ? 0.0 : (1.0 - static_cast<double>(largest) / free()) * 100.0; }
+
+    inline MemoryPoolInfo &operator+=(const MemoryPoolInfo &other)
+    {
+        hugePages += other.hugePages;
+        blocks    += other.blocks;
+        largest   += other.largest;
+        misses    += other.misses;
+        size      += other.size;
+        used      += other.used;
+
+        return *this;
+    }
+};
+
+
 class IMemoryPool
 {
 public:
@@ -38,9 +66,10 @@ public:
     IMemoryPool()           = default;
     virtual ~IMemoryPool()  = default;
 
-    virtual bool isHugePages(uint32_t node) const       = 0;
-    virtual uint8_t *get(size_t size, uint32_t node)    = 0;
-    virtual void release(uint32_t node)                 = 0;
+    virtual bool isHugePages(uint32_t node) const                   = 0;
+    virtual MemoryPoolInfo info() const                             = 0;
+    virtual uint8_t *get(size_t size, uint32_t node)                = 0;
+    virtual void release(uint8_t *ptr, size_t size, uint32_t node)  = 0;
 };
 
 
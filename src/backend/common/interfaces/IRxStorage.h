@@ -26,6 +26,7 @@
 #include "crypto/rx/RxConfig.h"
 
 
+#include <atomic>
 #include <cstdint>
 #include <utility>
 
@@ -36,6 +37,7 @@ namespace xmrig {
 class Job;
 class RxDataset;
 class RxSeed;
+class String;
 
 
 class IRxStorage
@@ -46,10 +48,12 @@ public:
     IRxStorage()            = default;
     virtual ~IRxStorage()   = default;
 
-    virtual bool isAllocated() const                                                                                            = 0;
-    virtual HugePagesInfo hugePages() const                                                                                     = 0;
-    virtual RxDataset *dataset(const Job &job, uint32_t nodeId) const                                                           = 0;
-    virtual void init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority) = 0;
+    virtual bool isAllocated() const                                                                                                                  = 0;
+    virtual bool isUsed() const                                                                                                                       = 0;
+    virtual HugePagesInfo hugePages() const                                                                                                           = 0;
+    virtual RxDataset *dataset(const Job &job, uint32_t nodeId) const                                                                                 = 0;
+    virtual void init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache, const std::atomic<bool> *abort) = 0;
+    virtual void saveSnapshot(const String &dir)                                                                                                      = 0;
 };
 
 
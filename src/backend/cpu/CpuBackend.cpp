@@ -22,10 +22,12 @@
 #include "backend/cpu/CpuBackend.h"
 #include "3rdparty/rapidjson/document.h"
 #include "backend/common/Hashrate.h"
+#include "backend/common/interfaces/IMemoryPool.h"
 #include "backend/common/interfaces/IWorker.h"
 #include "backend/common/Tags.h"
 #include "backend/common/Workers.h"
 #include "backend/cpu/Cpu.h"
+#include "backend/cpu/CpuSelfTest.h"
 #include "base/io/log/Log.h"
 #include "base/io/log/Tags.h"
 #include "base/net/stratum/Job.h"
@@ -40,6 +42,7 @@
 
 #ifdef XMRIG_FEATURE_API
 #   include "base/api/interfaces/IApiRequest.h"
+#   include "base/api/Metrics.h"
 #endif
 
 
@@ -48,6 +51,12 @@
 #endif
 
 
+#ifdef XMRIG_ALGO_KAWPOW
+#   include "crypto/kawpow/KPDag.h"
+#   include "crypto/kawpow/KPHash.h"
+#endif
+
+
 #ifdef XMRIG_FEATURE_BENCHMARK
 #   include "backend/common/benchmark/Benchmark.h"
 #   include "backend/common/benchmark/BenchState.h"
@@ -149,10 +158,10 @@ public:
                  profileName.data(),
                  threads.size(),
                  threads.size() > 1 ? "s" : "",
-                 algo.l3() / 1024
+                 scratchpad / 1024
                  );
 
-        status.start(threads, algo.l3());
+        status.start(threads, scratchpad);
 
 #       ifdef XMRIG_FEATURE_BENCHMARK
         workers.start(threads, benchmark);
@@ -162,6 +171,26 @@ public:
     }
 
 
+    // Running threads can take the new algorithm as is, if it fits the scratchpads and the self-test for its family
+    // has already passed with the same intensity, so only the job changes and the threads stay where they are.
+    bool isHotSwitch(const std::vector<CpuLaunchData> &next) const
+    {
+        if (threads.empty() || threads.size() != next.size() || !std::equal(threads.begin(), threads.end(), next.begin())) {
+            return false;
+        }
+
+        bool passed = false;
+
+        for (const auto &data : next) {
+            if (!CpuSelfTest::get(data.algorithm, data.intensity, data.av(), data.assembly, passed) || !passed) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
     size_t ways() const
     {
         std::lock_guard<std::mutex> lock(mutex);
@@ -170,7 +199,7 @@ public:
     }
 
 
-    rapidjson::Value hugePages(int version, rapidjson::Document &doc) const
+    HugePagesInfo hugePages() const
     {
         HugePagesInfo pages;
 
@@ -180,12 +209,26 @@ public:
         }
     #   endif
 
+    #   ifdef XMRIG_ALGO_KAWPOW
+        if (algo.family() == Algorithm::KAWPOW) {
+            pages += KPDag::hugePages();
+        }
+    #   endif
+
         mutex.lock();
 
         pages += status.hugePages();
 
         mutex.unlock();
 
+        return pages;
+    }
+
+
+    rapidjson::Value hugePages(int version, rapidjson::Document &doc) const
+    {
+        const auto pages = hugePages();
+
         rapidjson::Value hugepages;
 
         if (version > 1) {
@@ -206,6 +249,7 @@ public:
     CpuLaunchStatus status;
     std::vector<CpuLaunchData> threads;
     String profileName;
+    size_t scratchpad   = 0;
     Workers<CpuLaunchData> workers;
 
 #   ifdef XMRIG_FEATURE_BENCHMARK
@@ -257,6 +301,10 @@ xmrig::CpuBackend::CpuBackend(Controller *controller) :
 xmrig::CpuBackend::~CpuBackend()
 {
     delete d_ptr;
+
+#   ifdef XMRIG_ALGO_KAWPOW
+    KPDag::destroy();
+#   endif
 }
 
 
@@ -352,13 +400,36 @@ void xmrig::CpuBackend::printHealth()
 void xmrig::CpuBackend::setJob(const Job &job)
 {
     if (!isEnabled()) {
+#       ifdef XMRIG_ALGO_KAWPOW
+        KPDag::reset();
+#       endif
+
         return stop();
     }
 
     const auto &cpu = d_ptr->controller->config()->cpu();
 
-    auto threads = cpu.get(d_ptr->controller->miner(), job.algorithm());
-    if (!d_ptr->threads.empty() && d_ptr->threads.size() == threads.size() && std::equal(d_ptr->threads.begin(), d_ptr->threads.end(), threads.begin())) {
+    // Scratchpads only grow: once an algorithm with bigger memory was mined, switching back and forth doesn't restart threads.
+    auto threads = cpu.get(d_ptr->controller->miner(), job.algorithm(), d_ptr->scratchpad);
+
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (job.algorithm().family() == Algorithm::KAWPOW && !threads.empty()) {
+        KPDag::prepare(job.height() / KPHash::EPOCH_LENGTH, cpu.isHugePages());
+    }
+    else {
+        KPDag::reset();
+    }
+#   endif
+
+    if (d_ptr->isHotSwitch(threads)) {
+        if (d_ptr->algo != job.algorithm()) {
+            LOG_INFO("%s switch to " MAGENTA_BOLD("%s") " without restarting threads", Tags::cpu(), job.algorithm().name());
+
+            d_ptr->algo         = job.algorithm();
+            d_ptr->profileName  = cpu.threads().profileName(job.algorithm());
+            d_ptr->threads      = std::move(threads);
+        }
+
         return;
     }
 
@@ -373,6 +444,8 @@ void xmrig::CpuBackend::setJob(const Job &job)
 
     stop();
 
+    d_ptr->scratchpad = threads.front().scratchpad;
+
 #   ifdef XMRIG_FEATURE_BENCHMARK
     if (BenchState::size()) {
         d_ptr->benchmark = std::make_shared<Benchmark>(threads.size(), this);
@@ -443,7 +516,25 @@ rapidjson::Value xmrig::CpuBackend::toJSON(rapidjson::Document &doc) const
 #   endif
 
     out.AddMember("hugepages", d_ptr->hugePages(2, doc), allocator);
-    out.AddMember("memory",    static_cast<uint64_t>(d_ptr->algo.isValid() ? (d_ptr->ways() * d_ptr->algo.l3()) : 0), allocator);
+    out.AddMember("memory",    static_cast<uint64_t>(d_ptr->algo.isValid() ? (d_ptr->ways() * d_ptr->scratchpad) : 0), allocator);
+
+    const auto pool = VirtualMemory::poolInfo();
+    if (pool.size) {
+        Value memoryPool(kObjectType);
+        memoryPool.AddMember("size",            static_cast<uint64_t>(pool.size), allocator);
+        memoryPool.AddMember("used",            static_cast<uint64_t>(pool.used), allocator);
+        memoryPool.AddMember("blocks",          static_cast<uint64_t>(pool.blocks), allocator);
+        memoryPool.AddMember("largest-free",    static_cast<uint64_t>(pool.largest), allocator);
+        memoryPool.AddMember("fragmentation",   pool.fragmentation(), allocator);
+        memoryPool.AddMember("misses",          static_cast<uint64_t>(pool.misses), allocator);
+
+        Value hugepages(kArrayType);
+        hugepages.PushBack(static_cast<uint64_t>(pool.hugePages.allocated), allocator);
+        hugepages.PushBack(static_cast<uint64_t>(pool.hugePages.total), allocator);
+        memoryPool.AddMember("hugepages",       hugepages, allocator);
+
+        out.AddMember("memory-pool", memoryPool, allocator);
+    }
 
     if (d_ptr->threads.empty() || !hashrate()) {
         return out;
@@ -456,10 +547,11 @@ rapidjson::Value xmrig::CpuBackend::toJSON(rapidjson::Document &doc) const
     size_t i = 0;
     for (const CpuLaunchData &data : d_ptr->threads) {
         Value thread(kObjectType);
-        thread.AddMember("intensity",   data.intensity, allocator);
-        thread.AddMember("affinity",    data.affinity, allocator);
-        thread.AddMember("av",          data.av(), allocator);
-        thread.AddMember("hashrate",    hashrate()->toJSON(i, doc), allocator);
+        thread.AddMember("intensity",       data.intensity, allocator);
+        thread.AddMember("affinity",        data.affinity, allocator);
+        thread.AddMember("av",              data.av(), allocator);
+        thread.AddMember("hashrate",        hashrate()->toJSON(i, doc), allocator);
+        thread.AddMember("hashrate_stats",  hashrate()->statsToJSON(i, doc), allocator);
 
         i++;
         threads.PushBack(thread, allocator);
@@ -477,6 +569,35 @@ void xmrig::CpuBackend::handleRequest(IApiRequest &request)
         request.reply().AddMember("hugepages", d_ptr->hugePages(request.version(), request.doc()), request.doc().GetAllocator());
     }
 }
+
+
+void xmrig::CpuBackend::toMetrics(Metrics &metrics) const
+{
+    static const char *labels = "backend=\"cpu\"";
+
+    const auto pages = d_ptr->hugePages();
+
+    metrics.set("xmrig_hugepages_allocated", Metrics::GAUGE, "Huge pages backing mining memory.");
+    metrics.add(static_cast<uint64_t>(pages.allocated), labels);
+
+    metrics.set("xmrig_hugepages_total", Metrics::GAUGE, "Pages of mining memory that could be backed by huge pages.");
+    metrics.add(static_cast<uint64_t>(pages.total), labels);
+
+    metrics.set("xmrig_hugepages_coverage_ratio", Metrics::GAUGE, "Share of mining memory backed by huge pages.");
+    metrics.add(pages.total ? static_cast<double>(pages.allocated) / pages.total : 0.0, labels);
+
+    const auto pool = VirtualMemory::poolInfo();
+    if (pool.size) {
+        metrics.set("xmrig_memory_pool_bytes", Metrics::GAUGE, "Size of the preallocated memory pool.");
+        metrics.add(static_cast<uint64_t>(pool.size));
+
+        metrics.set("xmrig_memory_pool_used_bytes", Metrics::GAUGE, "Memory pool bytes in use.");
+        metrics.add(static_cast<uint64_t>(pool.used));
+
+        metrics.set("xmrig_memory_pool_misses_total", Metrics::COUNTER, "Allocations the memory pool could not satisfy.");
+        metrics.add(static_cast<uint64_t>(pool.misses));
+    }
+}
 #endif
 
 
@@ -96,14 +96,12 @@ size_t xmrig::CpuConfig::memPoolSize() const
 }
 
 
-std::vector<xmrig::CpuLaunchData> xmrig::CpuConfig::get(const Miner *miner, const Algorithm &algorithm) const
+std::vector<xmrig::CpuLaunchData> xmrig::CpuConfig::get(const Miner *miner, const Algorithm &algorithm, size_t scratchpad) const
 {
-    if (algorithm.family() == Algorithm::KAWPOW) {
-        return {};
-    }
-
     std::vector<CpuLaunchData> out;
-    const auto &threads = m_threads.get(algorithm);
+
+    // CPU KawPow is opt-in: it needs a multi-GB DAG, so only an explicit "kawpow" profile (not "*") enables it.
+    const auto &threads = m_threads.get(algorithm, algorithm.family() == Algorithm::KAWPOW);
 
     if (threads.isEmpty()) {
         return out;
@@ -120,7 +118,7 @@ std::vector<xmrig::CpuLaunchData> xmrig::CpuConfig::get(const Miner *miner, cons
     }
 
     for (const auto &thread : threads.data()) {
-        out.emplace_back(miner, algorithm, *this, thread, count, affinities);
+        out.emplace_back(miner, algorithm, *this, thread, count, affinities, scratchpad);
     }
 
     return out;
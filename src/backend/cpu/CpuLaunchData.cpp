@@ -32,7 +32,7 @@
 #include <algorithm>
 
 
-xmrig::CpuLaunchData::CpuLaunchData(const Miner *miner, const Algorithm &algorithm, const CpuConfig &config, const CpuThread &thread, size_t threads, const std::vector<int64_t>& affinities) :
+xmrig::CpuLaunchData::CpuLaunchData(const Miner *miner, const Algorithm &algorithm, const CpuConfig &config, const CpuThread &thread, size_t threads, const std::vector<int64_t>& affinities, size_t scratchpad) :
     algorithm(algorithm),
     assembly(config.assembly()),
     hugePages(config.isHugePages()),
@@ -41,6 +41,7 @@ xmrig::CpuLaunchData::CpuLaunchData(const Miner *miner, const Algorithm &algorit
     priority(config.priority()),
     affinity(thread.affinity()),
     miner(miner),
+    scratchpad(std::max(algorithm.l3(), scratchpad)),
     threads(threads),
     intensity(std::max<uint32_t>(std::min<uint32_t>(thread.intensity(), algorithm.maxIntensity()), algorithm.minIntensity())),
     affinities(affinities)
@@ -50,7 +51,7 @@ xmrig::CpuLaunchData::CpuLaunchData(const Miner *miner, const Algorithm &algorit
 
 bool xmrig::CpuLaunchData::isEqual(const CpuLaunchData &other) const
 {
-    return (algorithm.l3()      == other.algorithm.l3()
+    return (scratchpad          == other.scratchpad
             && assembly         == other.assembly
             && hugePages        == other.hugePages
             && hwAES            == other.hwAES
@@ -44,7 +44,7 @@ class Miner;
 class CpuLaunchData
 {
 public:
-    CpuLaunchData(const Miner *miner, const Algorithm &algorithm, const CpuConfig &config, const CpuThread &thread, size_t threads, const std::vector<int64_t>& affinities);
+    CpuLaunchData(const Miner *miner, const Algorithm &algorithm, const CpuConfig &config, const CpuThread &thread, size_t threads, const std::vector<int64_t>& affinities, size_t scratchpad = 0);
 
     bool isEqual(const CpuLaunchData &other) const;
     CnHash::AlgoVariant av() const;
@@ -64,6 +64,7 @@ public:
     const int priority;
     const int64_t affinity;
     const Miner *miner;
+    const size_t scratchpad;
     const size_t threads;
     const uint32_t intensity;
     const std::vector<int64_t> affinities;
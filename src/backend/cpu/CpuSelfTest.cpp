@@ -0,0 +1,62 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "backend/cpu/CpuSelfTest.h"
+
+
+#include <map>
+#include <mutex>
+
+
+namespace xmrig {
+
+
+static std::map<uint64_t, bool> results;
+static std::mutex mutex;
+
+
+static inline uint64_t selfTestKey(const Algorithm &algorithm, size_t intensity, CnHash::AlgoVariant av, const Assembly &assembly)
+{
+    return (static_cast<uint64_t>(algorithm.family()) << 32) | (static_cast<uint64_t>(intensity & 0xff) << 16) | (static_cast<uint64_t>(av & 0xff) << 8) | static_cast<uint64_t>(assembly.id() & 0xff);
+}
+
+
+} // namespace xmrig
+
+
+bool xmrig::CpuSelfTest::get(const Algorithm &algorithm, size_t intensity, CnHash::AlgoVariant av, const Assembly &assembly, bool &passed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto it = results.find(selfTestKey(algorithm, intensity, av, assembly));
+    if (it == results.end()) {
+        return false;
+    }
+
+    passed = it->second;
+
+    return true;
+}
+
+
+void xmrig::CpuSelfTest::set(const Algorithm &algorithm, size_t intensity, CnHash::AlgoVariant av, const Assembly &assembly, bool passed)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    results[selfTestKey(algorithm, intensity, av, assembly)] = passed;
+}
@@ -0,0 +1,49 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_CPUSELFTEST_H
+#define XMRIG_CPUSELFTEST_H
+
+
+#include "base/crypto/Algorithm.h"
+#include "crypto/cn/CnHash.h"
+#include "crypto/common/Assembly.h"
+
+
+namespace xmrig {
+
+
+/**
+ * Process wide cache of CPU worker self-test results.
+ *
+ * The self-test checks the whole algorithm family and depends only on the number of hashes per call, the algorithm
+ * variant and the assembly, so a family is verified once per configuration and later workers (or a hot algorithm
+ * switch of running workers) reuse the result.
+ */
+class CpuSelfTest
+{
+public:
+    static bool get(const Algorithm &algorithm, size_t intensity, CnHash::AlgoVariant av, const Assembly &assembly, bool &passed);
+    static void set(const Algorithm &algorithm, size_t intensity, CnHash::AlgoVariant av, const Assembly &assembly, bool passed);
+};
+
+
+} // namespace xmrig
+
+
+#endif /* XMRIG_CPUSELFTEST_H */
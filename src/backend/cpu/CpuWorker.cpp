@@ -22,6 +22,7 @@
 
 
 #include "backend/cpu/Cpu.h"
+#include "backend/cpu/CpuSelfTest.h"
 #include "backend/cpu/CpuWorker.h"
 #include "base/tools/Alignment.h"
 #include "base/tools/Chrono.h"
@@ -45,6 +46,13 @@
 #endif
 
 
+#ifdef XMRIG_ALGO_KAWPOW
+#   include "crypto/kawpow/KPCache.h"
+#   include "crypto/kawpow/KPDag.h"
+#   include "crypto/kawpow/KPHash.h"
+#endif
+
+
 #ifdef XMRIG_FEATURE_BENCHMARK
 #   include "backend/common/benchmark/BenchState.h"
 #endif
@@ -60,6 +68,44 @@ static std::mutex cn_heavyZen3MemoryMutex;
 VirtualMemory* cn_heavyZen3Memory = nullptr;
 #endif
 
+
+#ifdef XMRIG_ALGO_KAWPOW
+// Known answers for the hash loop shared with GPU share verification, light mode so only the epoch 0 cache is needed.
+static bool verifyKawPow()
+{
+    static std::mutex mutex;
+    static int result = -1;
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (result >= 0) {
+        return result == 1;
+    }
+
+    KPCache cache;
+    result = 0;
+
+    if (!cache.init(0)) {
+        return false;
+    }
+
+    for (const auto &test : kawpow_test_output) {
+        uint32_t output[8];
+        uint32_t mix_hash[8];
+
+        KPHash::calculate(cache, test.height, kawpow_test_header, kawpow_test_nonce, output, mix_hash);
+
+        if (memcmp(output, test.output, sizeof(output)) != 0 || memcmp(mix_hash, test.mix_hash, sizeof(mix_hash)) != 0) {
+            return false;
+        }
+    }
+
+    result = 1;
+
+    return true;
+}
+#endif
+
 } // namespace xmrig
 
 
@@ -73,6 +119,7 @@ xmrig::CpuWorker<N>::CpuWorker(size_t id, const CpuLaunchData &data) :
     m_yield(data.yield),
     m_av(data.av()),
     m_miner(data.miner),
+    m_scratchpad(data.scratchpad),
     m_threads(data.threads),
     m_ctx()
 {
@@ -94,7 +141,7 @@ xmrig::CpuWorker<N>::CpuWorker(size_t id, const CpuLaunchData &data) :
     else
 #   endif
     {
-        m_memory = new VirtualMemory(m_algorithm.l3() * N, data.hugePages, false, true, node());
+        m_memory = new VirtualMemory(m_scratchpad * N, data.hugePages, false, true, node());
     }
 
 #   ifdef XMRIG_ALGO_GHOSTRIDER
@@ -108,6 +155,11 @@ xmrig::CpuWorker<N>::~CpuWorker()
 {
 #   ifdef XMRIG_ALGO_RANDOMX
     RxVm::destroy(m_vm);
+    Rx::release(m_dataset);
+#   endif
+
+#   ifdef XMRIG_ALGO_KAWPOW
+    KPDag::release(m_kpDag);
 #   endif
 
     CnCtx::release(m_ctx, N);
@@ -129,16 +181,23 @@ xmrig::CpuWorker<N>::~CpuWorker()
 template<size_t N>
 void xmrig::CpuWorker<N>::allocateRandomX_VM()
 {
-    RxDataset *dataset = Rx::dataset(m_job.currentJob(), node());
+    RxDataset *dataset = nullptr;
 
-    while (dataset == nullptr) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // RxQueue wakes up waiters as soon as the dataset is ready.
+    Nonce::wait([this, &dataset] {
+        dataset = Rx::acquire(m_job.currentJob(), node());
 
-        if (Nonce::sequence(Nonce::CPU) == 0) {
-            return;
-        }
+        return dataset == nullptr && Nonce::sequence(Nonce::CPU) > 0;
+    });
+
+    if (dataset == nullptr) {
+        return;
+    }
 
-        dataset = Rx::dataset(m_job.currentJob(), node());
+    if (m_vm && dataset != m_dataset && (dataset->get() == nullptr) != (m_dataset->get() == nullptr)) {
+        // Double buffered dataset was switched to a slot with different mode (fast/light), VM must be recreated
+        RxVm::destroy(m_vm);
+        m_vm = nullptr;
     }
 
     if (!m_vm) {
@@ -146,17 +205,65 @@ void xmrig::CpuWorker<N>::allocateRandomX_VM()
         uint8_t* scratchpad = m_memory->isHugePages() ? m_memory->scratchpad() : dataset->tryAllocateScrathpad();
         m_vm = RxVm::create(dataset, scratchpad ? scratchpad : m_memory->scratchpad(), !m_hwAES, m_assembly, node());
     }
-    else if (!dataset->get() && (m_job.currentJob().seed() != m_seed)) {
+    else if (dataset->get() && dataset != m_dataset) {
+        // Switch RandomX VM to the dataset prepared in background
+        randomx_vm_set_dataset(m_vm, dataset->get());
+    }
+    else if (!dataset->get() && (dataset != m_dataset || m_job.currentJob().seed() != m_seed)) {
         // Update RandomX light VM with the new seed
         randomx_vm_set_cache(m_vm, dataset->cache()->get());
     }
-    m_seed = m_job.currentJob().seed();
+
+    // The VM no longer uses the previous dataset, RxQueue may reuse its storage for another seed.
+    Rx::release(m_dataset);
+
+    m_dataset = dataset;
+    m_seed    = m_job.currentJob().seed();
+}
+#endif
+
+
+#ifdef XMRIG_ALGO_KAWPOW
+template<size_t N>
+void xmrig::CpuWorker<N>::allocateKawPow_DAG()
+{
+    const uint32_t epoch = m_job.currentJob().height() / KPHash::EPOCH_LENGTH;
+
+    if (m_kpDag && m_kpDag->cache().epoch() == epoch) {
+        return;
+    }
+
+    // Release the previous epoch first, the shared DAG can't be rebuilt while any thread still uses it
+    KPDag::release(m_kpDag);
+    m_kpDag = nullptr;
+
+    // The DAG is built in background (see CpuBackend::setJob), if that failed keep waiting for the next job without hashing
+    while ((m_kpDag = KPDag::acquire(epoch)) == nullptr) {
+        if (Nonce::isOutdated(Nonce::CPU, m_job.sequence())) {
+            return;
+        }
+    }
 }
 #endif
 
 
 template<size_t N>
 bool xmrig::CpuWorker<N>::selfTest()
+{
+    bool passed = false;
+
+    if (!CpuSelfTest::get(m_algorithm, N, m_av, m_assembly, passed)) {
+        passed = testFamily();
+
+        CpuSelfTest::set(m_algorithm, N, m_av, m_assembly, passed);
+    }
+
+    return passed;
+}
+
+
+template<size_t N>
+bool xmrig::CpuWorker<N>::testFamily()
 {
 #   ifdef XMRIG_ALGO_RANDOMX
     if (m_algorithm.family() == Algorithm::RANDOM_X) {
@@ -164,6 +271,12 @@ bool xmrig::CpuWorker<N>::selfTest()
     }
 #   endif
 
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (m_algorithm.family() == Algorithm::KAWPOW) {
+        return (N == 1) && verifyKawPow();
+    }
+#   endif
+
     allocateCnCtx();
 
 #   ifdef XMRIG_ALGO_GHOSTRIDER
@@ -242,10 +355,7 @@ void xmrig::CpuWorker<N>::start()
 {
     while (Nonce::sequence(Nonce::CPU) > 0) {
         if (Nonce::isPaused()) {
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(20));
-            }
-            while (Nonce::isPaused() && Nonce::sequence(Nonce::CPU) > 0);
+            Nonce::wait([] { return Nonce::isPaused() && Nonce::sequence(Nonce::CPU) > 0; });
 
             if (Nonce::sequence(Nonce::CPU) == 0) {
                 break;
@@ -262,7 +372,8 @@ void xmrig::CpuWorker<N>::start()
         while (!Nonce::isOutdated(Nonce::CPU, m_job.sequence())) {
             const Job &job = m_job.currentJob();
 
-            if (job.algorithm().l3() != m_algorithm.l3()) {
+            // The backend restarts threads if the new algorithm doesn't fit the scratchpads.
+            if (job.algorithm().l3() > m_scratchpad) {
                 break;
             }
 
@@ -288,6 +399,12 @@ void xmrig::CpuWorker<N>::start()
 
             uint8_t miner_signature_saved[64];
 
+#           ifdef XMRIG_ALGO_KAWPOW
+            uint64_t kp_nonce = 0;
+            uint32_t kp_output[8]{};
+            uint32_t kp_mix_hash[8]{};
+#           endif
+
 #           ifdef XMRIG_ALGO_RANDOMX
             uint8_t* miner_signature_ptr = m_job.blob() + m_job.nonceOffset() + m_job.nonceSize();
             if (job.algorithm().family() == Algorithm::RANDOM_X) {
@@ -325,6 +442,25 @@ void xmrig::CpuWorker<N>::start()
                     break;
 #               endif
 
+#               ifdef XMRIG_ALGO_KAWPOW
+                case Algorithm::KAWPOW:
+                    if ((N == 1) && m_kpDag) {
+                        uint8_t header_hash[32];
+                        memcpy(header_hash, m_job.blob(), sizeof(header_hash));
+                        kp_nonce = readUnaligned(reinterpret_cast<const uint64_t*>(m_job.blob() + sizeof(header_hash)));
+
+                        KPHash::calculate(m_kpDag->cache(), m_kpDag->data(), job.height(), header_hash, kp_nonce, kp_output, kp_mix_hash);
+
+                        for (size_t i = 0; i < 32; ++i) {
+                            m_hash[i] = reinterpret_cast<const uint8_t*>(kp_output)[31 - i];
+                        }
+                    }
+                    else {
+                        valid = false;
+                    }
+                    break;
+#               endif
+
                 default:
                     fn(job.algorithm())(m_job.blob(), job.size(), m_hash, m_ctx, job.height());
                     break;
@@ -348,10 +484,17 @@ void xmrig::CpuWorker<N>::start()
                     else
 #                   endif
                     if (value < job.target()) {
+#                       ifdef XMRIG_ALGO_KAWPOW
+                        if (job.algorithm().family() == Algorithm::KAWPOW) {
+                            JobResults::submit(JobResult(job, kp_nonce, reinterpret_cast<const uint8_t*>(kp_output), job.blob(), reinterpret_cast<const uint8_t*>(kp_mix_hash)));
+                        }
+                        else
+#                       endif
                         JobResults::submit(job, current_job_nonces[i], m_hash + (i * 32), job.hasMinerSignature() ? miner_signature_saved : nullptr);
                     }
                 }
                 m_count += N;
+                m_switch.hashed();
             }
 
             if (m_yield) {
@@ -363,6 +506,11 @@ void xmrig::CpuWorker<N>::start()
             consumeJob();
         }
     }
+
+#   ifdef XMRIG_ALGO_KAWPOW
+    KPDag::release(m_kpDag);
+    m_kpDag = nullptr;
+#   endif
 }
 
 
@@ -493,7 +641,7 @@ void xmrig::CpuWorker<N>::allocateCnCtx()
         }
 #       endif
 
-        CnCtx::create(m_ctx, m_memory->scratchpad() + shift, m_algorithm.l3(), N);
+        CnCtx::create(m_ctx, m_memory->scratchpad() + shift, m_scratchpad, N);
     }
 }
 
@@ -515,12 +663,23 @@ void xmrig::CpuWorker<N>::consumeJob()
 #   endif
 
     m_job.add(job, count, Nonce::CPU);
+    m_switch.consumed(Nonce::CPU, m_job.sequence());
+
+    if (m_job.currentJob().algorithm() != m_algorithm) {
+        switchAlgorithm(m_job.currentJob().algorithm());
+    }
 
 #   ifdef XMRIG_ALGO_RANDOMX
     if (m_job.currentJob().algorithm().family() == Algorithm::RANDOM_X) {
         allocateRandomX_VM();
     }
     else
+#   endif
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (m_job.currentJob().algorithm().family() == Algorithm::KAWPOW) {
+        allocateKawPow_DAG();
+    }
+    else
 #   endif
     {
         allocateCnCtx();
@@ -528,6 +687,26 @@ void xmrig::CpuWorker<N>::consumeJob()
 }
 
 
+template<size_t N>
+void xmrig::CpuWorker<N>::switchAlgorithm(const Algorithm &algorithm)
+{
+#   ifdef XMRIG_ALGO_CN_HEAVY
+    // The shared Zen3 cn-heavy memory interleaves scratchpads of neighbour threads, other algorithms need private memory.
+    if (m_memory == cn_heavyZen3Memory && algorithm.family() != Algorithm::CN_HEAVY) {
+        CnCtx::release(m_ctx, N);
+
+        for (size_t i = 0; i < N; ++i) {
+            m_ctx[i] = nullptr;
+        }
+
+        m_memory = new VirtualMemory(m_scratchpad * N, cn_heavyZen3Memory->isHugePages(), false, true, node());
+    }
+#   endif
+
+    m_algorithm = algorithm;
+}
+
+
 namespace xmrig {
 
 template class CpuWorker<1>;
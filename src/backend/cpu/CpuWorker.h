@@ -35,6 +35,8 @@ class randomx_vm;
 namespace xmrig {
 
 
+class KPDag;
+class RxDataset;
 class RxVm;
 
 
@@ -77,19 +79,26 @@ private:
     void allocateRandomX_VM();
 #   endif
 
+#   ifdef XMRIG_ALGO_KAWPOW
+    void allocateKawPow_DAG();
+#   endif
+
     bool nextRound();
+    bool testFamily();
     bool verify(const Algorithm &algorithm, const uint8_t *referenceValue);
     bool verify2(const Algorithm &algorithm, const uint8_t *referenceValue);
     void allocateCnCtx();
     void consumeJob();
+    void switchAlgorithm(const Algorithm &algorithm);
 
     alignas(8) uint8_t m_hash[N * 32]{ 0 };
-    const Algorithm m_algorithm;
+    Algorithm m_algorithm;
     const Assembly m_assembly;
     const bool m_hwAES;
     const bool m_yield;
     const CnHash::AlgoVariant m_av;
     const Miner *m_miner;
+    const size_t m_scratchpad;
     const size_t m_threads;
     cryptonight_ctx *m_ctx[N];
     VirtualMemory *m_memory = nullptr;
@@ -97,6 +106,7 @@ private:
 
 #   ifdef XMRIG_ALGO_RANDOMX
     randomx_vm *m_vm        = nullptr;
+    RxDataset *m_dataset    = nullptr;
     Buffer m_seed;
 #   endif
 
@@ -104,6 +114,10 @@ private:
     ghostrider::HelperThread* m_ghHelper = nullptr;
 #   endif
 
+#   ifdef XMRIG_ALGO_KAWPOW
+    KPDag *m_kpDag          = nullptr;
+#   endif
+
 #   ifdef XMRIG_FEATURE_BENCHMARK
     uint32_t m_benchSize    = 0;
 #   endif
@@ -38,6 +38,7 @@
 #include "base/tools/String.h"
 #include "core/config/Config.h"
 #include "core/Controller.h"
+#include "crypto/common/Nonce.h"
 
 
 #ifdef XMRIG_ALGO_KAWPOW
@@ -471,6 +472,7 @@ void xmrig::CudaBackend::start(IWorker *worker, bool ready)
         d_ptr->status.print();
 
         CudaWorker::ready = true;
+        Nonce::notify();
     }
 
     mutex.unlock();
@@ -542,6 +544,7 @@ rapidjson::Value xmrig::CudaBackend::toJSON(rapidjson::Document &doc) const
     for (const auto &data : d_ptr->threads) {
         Value thread = data.thread.toJSON(doc);
         thread.AddMember("hashrate", hashrate()->toJSON(i, doc), allocator);
+        thread.AddMember("hashrate_stats", hashrate()->statsToJSON(i, doc), allocator);
 
         data.device.toJSON(thread, doc);
 
@@ -558,4 +561,9 @@ rapidjson::Value xmrig::CudaBackend::toJSON(rapidjson::Document &doc) const
 void xmrig::CudaBackend::handleRequest(IApiRequest &)
 {
 }
+
+
+void xmrig::CudaBackend::toMetrics(Metrics &) const
+{
+}
 #endif
@@ -62,6 +62,7 @@ protected:
 #   ifdef XMRIG_FEATURE_API
     rapidjson::Value toJSON(rapidjson::Document &doc) const override;
     void handleRequest(IApiRequest &request) override;
+    void toMetrics(Metrics &metrics) const override;
 #   endif
 
 #   ifdef XMRIG_FEATURE_BENCHMARK
@@ -124,10 +124,7 @@ void xmrig::CudaWorker::start()
 {
     while (Nonce::sequence(Nonce::CUDA) > 0) {
         if (!isReady()) {
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            }
-            while (!isReady() && Nonce::sequence(Nonce::CUDA) > 0);
+            Nonce::wait([] { return !isReady() && Nonce::sequence(Nonce::CUDA) > 0; });
 
             if (Nonce::sequence(Nonce::CUDA) == 0) {
                 break;
@@ -146,8 +143,10 @@ void xmrig::CudaWorker::start()
                 return;
             }
 
+            m_switch.hashed();
+
             if (foundCount) {
-                JobResults::submit(m_job.currentJob(), foundNonce, foundCount, m_deviceIndex);
+                JobResults::submit(m_job.currentJob(), foundNonce, foundCount, m_deviceIndex, node());
             }
 
             if (!Nonce::isOutdated(Nonce::CUDA, m_job.sequence()) && !m_job.nextRound(1, intensity())) {
@@ -172,6 +171,7 @@ bool xmrig::CudaWorker::consumeJob()
     }
 
     m_job.add(m_miner->job(), intensity(), Nonce::CUDA);
+    m_switch.consumed(Nonce::CUDA, m_job.sequence());
 
     return m_runner->set(m_job.currentJob(), m_job.blob());
 }
@@ -39,9 +39,11 @@
 #include "base/tools/String.h"
 #include "core/config/Config.h"
 #include "core/Controller.h"
+#include "crypto/common/Nonce.h"
 
 
 #ifdef XMRIG_ALGO_KAWPOW
+#   include "backend/opencl/runners/tools/OclKawPow.h"
 #   include "crypto/kawpow/KPCache.h"
 #   include "crypto/kawpow/KPHash.h"
 #endif
@@ -453,6 +455,7 @@ void xmrig::OclBackend::start(IWorker *worker, bool ready)
         d_ptr->status.print();
 
         OclWorker::ready = true;
+        Nonce::notify();
     }
 
     mutex.unlock();
@@ -505,6 +508,12 @@ rapidjson::Value xmrig::OclBackend::toJSON(rapidjson::Document &doc) const
 
     out.AddMember("hashrate", hashrate()->toJSON(doc), allocator);
 
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (d_ptr->algo.family() == Algorithm::KAWPOW) {
+        out.AddMember("kawpow", OclKawPow::toJSON(doc), allocator);
+    }
+#   endif
+
     Value threads(kArrayType);
 
     size_t i = 0;
@@ -512,6 +521,7 @@ rapidjson::Value xmrig::OclBackend::toJSON(rapidjson::Document &doc) const
         Value thread = data.thread.toJSON(doc);
         thread.AddMember("affinity", data.affinity, allocator);
         thread.AddMember("hashrate", hashrate()->toJSON(i, doc), allocator);
+        thread.AddMember("hashrate_stats", hashrate()->statsToJSON(i, doc), allocator);
 
         data.device.toJSON(thread, doc);
 
@@ -528,4 +538,16 @@ rapidjson::Value xmrig::OclBackend::toJSON(rapidjson::Document &doc) const
 void xmrig::OclBackend::handleRequest(IApiRequest &)
 {
 }
+
+
+void xmrig::OclBackend::toMetrics(Metrics &metrics) const
+{
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (d_ptr->algo.family() == Algorithm::KAWPOW) {
+        OclKawPow::toMetrics(metrics);
+    }
+#   else
+    (void) metrics;
+#   endif
+}
 #endif
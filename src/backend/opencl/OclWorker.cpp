@@ -148,10 +148,7 @@ void xmrig::OclWorker::start()
         if (!isReady()) {
             m_sharedData.setResumeCounter(0);
 
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            }
-            while (!isReady() && Nonce::sequence(Nonce::OPENCL) > 0);
+            Nonce::wait([] { return !isReady() && Nonce::sequence(Nonce::OPENCL) > 0; });
 
             if (Nonce::sequence(Nonce::OPENCL) == 0) {
                 break;
@@ -178,8 +175,10 @@ void xmrig::OclWorker::start()
                 return;
             }
 
+            m_switch.hashed();
+
             if (results[0xFF] > 0) {
-                JobResults::submit(m_job.currentJob(), results, results[0xFF], m_deviceIndex);
+                JobResults::submit(m_job.currentJob(), results, results[0xFF], m_deviceIndex, node());
             }
 
             if (!Nonce::isOutdated(Nonce::OPENCL, m_job.sequence()) && !m_job.nextRound(1, intensity())) {
@@ -204,6 +203,7 @@ bool xmrig::OclWorker::consumeJob()
     }
 
     m_job.add(m_miner->job(), intensity(), Nonce::OPENCL);
+    m_switch.consumed(Nonce::OPENCL, m_job.sequence());
 
     try {
         m_runner->set(m_job.currentJob(), m_job.blob());
@@ -68,6 +68,7 @@ OclKawPowRunner::~OclKawPowRunner()
 
     delete m_calculateDagKernel;
 
+    OclLib::release(m_searchKernel);
     OclLib::release(m_controlQueue);
     OclLib::release(m_stop);
 
@@ -117,7 +118,9 @@ void OclKawPowRunner::run(uint32_t nonce, uint32_t /*nonce_offset*/, uint32_t *h
 void OclKawPowRunner::set(const Job &job, uint8_t *blob)
 {
     m_blockHeight = static_cast<uint32_t>(job.height());
-    m_searchKernel = OclKawPow::get(*this, m_blockHeight, m_workGroupSize);
+    cl_kernel kernel = OclKawPow::get(*this, m_blockHeight, m_workGroupSize);
+    OclLib::release(m_searchKernel);
+    m_searchKernel = kernel;
 
     const uint32_t epoch = m_blockHeight / KPHash::EPOCH_LENGTH;
 
@@ -130,24 +133,23 @@ void OclKawPowRunner::set(const Job &job, uint8_t *blob)
     }
 
     if (epoch != m_epoch) {
-        m_epoch = epoch;
-
-        {
-            std::lock_guard<std::mutex> lock(KPCache::s_cacheMutex);
-
-            KPCache::s_cache.init(epoch);
+        const auto cache = KPCache::get(epoch);
+        if (!cache) {
+            throw std::runtime_error("KawPow light cache is not available for this epoch");
+        }
 
-            if (KPCache::s_cache.size() > m_lightCacheCapacity) {
-                OclLib::release(m_lightCache);
+        m_epoch = epoch;
 
-                m_lightCacheCapacity = VirtualMemory::align(KPCache::s_cache.size());
-                m_lightCache = OclLib::createBuffer(m_ctx, CL_MEM_READ_ONLY, m_lightCacheCapacity);
-            }
+        if (cache->size() > m_lightCacheCapacity) {
+            OclLib::release(m_lightCache);
 
-            m_lightCacheSize = KPCache::s_cache.size();
-            enqueueWriteBuffer(m_lightCache, CL_TRUE, 0, m_lightCacheSize, KPCache::s_cache.data());
+            m_lightCacheCapacity = VirtualMemory::align(cache->size());
+            m_lightCache = OclLib::createBuffer(m_ctx, CL_MEM_READ_ONLY, m_lightCacheCapacity);
         }
 
+        m_lightCacheSize = cache->size();
+        enqueueWriteBuffer(m_lightCache, CL_TRUE, 0, m_lightCacheSize, cache->data());
+
         const uint64_t start_ms = Chrono::steadyMSecs();
 
         const uint32_t dag_words = dag_size / sizeof(node);
@@ -17,8 +17,8 @@
  */
 
 #include "backend/opencl/runners/tools/OclKawPow.h"
-#include "3rdparty/libethash/data_sizes.h"
-#include "3rdparty/libethash/ethash_internal.h"
+#include "3rdparty/rapidjson/document.h"
+#include "base/api/Metrics.h"
 #include "backend/opencl/cl/kawpow/kawpow_cl.h"
 #include "backend/opencl/interfaces/IOclRunner.h"
 #include "backend/opencl/OclCache.h"
@@ -30,13 +30,12 @@
 #include "base/io/log/Tags.h"
 #include "base/tools/Baton.h"
 #include "base/tools/Chrono.h"
-#include "crypto/kawpow/KPHash.h"
+#include "crypto/kawpow/KPProgram.h"
 
 
+#include <atomic>
 #include <cstring>
 #include <mutex>
-#include <regex>
-#include <sstream>
 #include <string>
 #include <thread>
 #include <uv.h>
@@ -45,25 +44,33 @@
 namespace xmrig {
 
 
+// Periods compiled ahead of the current one, each period is only 3 blocks long so one is not always enough.
+static constexpr uint64_t kPrefetch = 2;
+
+// Programs kept per device: current period, the prefetched ones and one spare for the previous period.
+static constexpr size_t kCapacity   = kPrefetch + 2;
+
+
 class KawPowCacheEntry
 {
 public:
-    inline KawPowCacheEntry(const Algorithm &algo, uint64_t period, uint32_t worksize, uint32_t index, cl_program program, cl_kernel kernel) :
+    inline KawPowCacheEntry(const Algorithm &algo, uint64_t period, uint32_t worksize, uint32_t index, cl_program program, cl_kernel kernel, uint64_t used) :
         program(program),
         kernel(kernel),
+        used(used),
         m_algo(algo),
         m_index(index),
         m_period(period),
         m_worksize(worksize)
     {}
 
-    inline bool isExpired(uint64_t period) const                                                       { return m_period + 1 < period; }
+    inline uint32_t index() const                                                                      { return m_index; }
     inline bool match(const Algorithm &algo, uint64_t period, uint32_t worksize, uint32_t index) const { return m_algo == algo && m_period == period && m_worksize == worksize && m_index == index; }
-    inline bool match(const IOclRunner &runner, uint64_t period, uint32_t worksize) const              { return match(runner.algorithm(), period, worksize, runner.deviceIndex()); }
     inline void release() const                                                                        { OclLib::release(kernel); OclLib::release(program); }
 
     cl_program program;
     cl_kernel kernel;
+    uint64_t used;
 
 private:
     Algorithm m_algo;
@@ -78,35 +85,44 @@ class KawPowCache
 public:
     KawPowCache() = default;
 
+    inline bool has(const IOclRunner &runner, uint64_t period, uint32_t worksize)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        return find(runner.algorithm(), period, worksize, runner.deviceIndex(), false) != nullptr;
+    }
+
+
     inline cl_kernel search(const IOclRunner &runner, uint64_t period, uint32_t worksize) { return search(runner.algorithm(), period, worksize, runner.deviceIndex()); }
 
 
+    // The returned kernel is retained for the caller, so evicting or clearing its entry never frees a kernel a runner still enqueues.
     inline cl_kernel search(const Algorithm &algo, uint64_t period, uint32_t worksize, uint32_t index)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
 
-        for (const auto &entry : m_data) {
-            if (entry.match(algo, period, worksize, index)) {
-                return entry.kernel;
-            }
-        }
+        const auto entry = find(algo, period, worksize, index, true);
 
-        return nullptr;
+        return entry ? OclLib::retain(entry->kernel) : nullptr;
     }
 
 
     void add(const Algorithm &algo, uint64_t period, uint32_t worksize, uint32_t index, cl_program program, cl_kernel kernel)
     {
-        if (search(algo, period, worksize, index)) {
-            OclLib::release(kernel);
-            OclLib::release(program);
-            return;
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (const auto &entry : m_data) {
+            if (entry.match(algo, period, worksize, index)) {
+                OclLib::release(kernel);
+                OclLib::release(program);
+                return;
+            }
         }
 
-        std::lock_guard<std::mutex> lock(m_mutex);
+        evict(index);
 
-        gc(period);
-        m_data.emplace_back(algo, period, worksize, index, program, kernel);
+        // A prefetched program must not look older than the one in use, otherwise it is the first candidate for eviction.
+        m_data.emplace_back(algo, period, worksize, index, program, kernel, ++m_tick);
     }
 
 
@@ -122,37 +138,95 @@ public:
     }
 
 
+    void record(bool hit)
+    {
+        ++(hit ? m_hits : m_misses);
+    }
+
+
+    rapidjson::Value toJSON(rapidjson::Document &doc)
+    {
+        using namespace rapidjson;
+        auto &allocator = doc.GetAllocator();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Value out(kObjectType);
+        out.AddMember("programs",   static_cast<uint64_t>(m_data.size()), allocator);
+        out.AddMember("hits",       m_hits.load(), allocator);
+        out.AddMember("misses",     m_misses.load(), allocator);
+
+        return out;
+    }
+
+
+    void toMetrics(Metrics &metrics, const char *labels)
+    {
+        metrics.set("xmrig_kawpow_program_cache_hits_total", Metrics::COUNTER, "KawPow period programs that were ready when a job arrived.");
+        metrics.add(m_hits.load(), labels);
+
+        metrics.set("xmrig_kawpow_program_cache_misses_total", Metrics::COUNTER, "KawPow period programs compiled while the GPU was waiting.");
+        metrics.add(m_misses.load(), labels);
+    }
+
+
 private:
-    void gc(uint64_t period)
+    KawPowCacheEntry *find(const Algorithm &algo, uint64_t period, uint32_t worksize, uint32_t index, bool touch)
+    {
+        for (auto &entry : m_data) {
+            if (entry.match(algo, period, worksize, index)) {
+                if (touch) {
+                    entry.used = ++m_tick;
+                }
+
+                return &entry;
+            }
+        }
+
+        return nullptr;
+    }
+
+
+    void evict(uint32_t index)
     {
-        for (size_t i = 0; i < m_data.size();) {
-            auto& entry = m_data[i];
+        while (true) {
+            size_t count = 0;
+            size_t lru   = m_data.size();
+
+            for (size_t i = 0; i < m_data.size(); ++i) {
+                if (m_data[i].index() != index) {
+                    continue;
+                }
+
+                ++count;
 
-            if (entry.isExpired(period)) {
-                entry.release();
-                entry = m_data.back();
-                m_data.pop_back();
+                if (lru == m_data.size() || m_data[i].used < m_data[lru].used) {
+                    lru = i;
+                }
             }
-            else {
-                ++i;
+
+            if (count < kCapacity) {
+                return;
             }
+
+            m_data[lru].release();
+            m_data[lru] = m_data.back();
+            m_data.pop_back();
         }
     }
 
 
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
     std::mutex m_mutex;
     std::vector<KawPowCacheEntry> m_data;
+    uint64_t m_tick = 0;
 };
 
 
 static KawPowCache cache;
 
 
-#define rnd()       (kiss99(rnd_state))
-#define mix_src()   ("mix[" + std::to_string(rnd() % KPHash::REGS) + "]")
-#define mix_dst()   ("mix[" + std::to_string(mix_seq_dst[(mix_seq_dst_cnt++) % KPHash::REGS]) + "]")
-#define mix_cache() ("mix[" + std::to_string(mix_seq_cache[(mix_seq_cache_cnt++) % KPHash::REGS]) + "]")
-
 class KawPowBaton : public Baton<uv_work_t>
 {
 public:
@@ -194,7 +268,7 @@ public:
         }
 
         cl_int ret = 0;
-        const std::string source = getSource(period);
+        const std::string source = KPProgram::source(kawpow_cl, period);
         cl_device_id device      = runner.data().device.id();
         const char *s            = source.c_str();
 
@@ -204,11 +278,7 @@ public:
         }
 
         std::string options = " -DPROGPOW_DAG_ELEMENTS=";
-
-        const uint64_t epoch = (period * KPHash::PERIOD_LENGTH) / KPHash::EPOCH_LENGTH;
-        const uint64_t dag_elements = dag_sizes[epoch] / 256;
-
-        options += std::to_string(dag_elements);
+        options += std::to_string(KPProgram::dagElements(period));
 
         options += " -DGROUP_SIZE=";
         options += std::to_string(worksize);
@@ -230,172 +300,17 @@ public:
 
         LOG_INFO("%s " YELLOW("KawPow") " program for period " WHITE_BOLD("%" PRIu64) " compiled " BLACK_BOLD("(%" PRIu64 "ms)"), Tags::opencl(), period, Chrono::steadyMSecs() - ts);
 
-        cache.add(runner.algorithm(), period, worksize, runner.deviceIndex(), program, kernel);
+        cache.add(runner.algorithm(), period, worksize, runner.deviceIndex(), program, OclLib::retain(kernel));
 
         return kernel;
     }
 
 
 private:
+    // m_mutex serializes compilation, m_batonMutex only guards the queue so a runner never waits for a background compile to enqueue work.
     std::mutex m_mutex;
+    std::mutex m_batonMutex;
 
-    typedef struct {
-        uint32_t z, w, jsr, jcong;
-    } kiss99_t;
-
-
-    static std::string getSource(uint64_t prog_seed)
-    {
-        std::stringstream ret;
-
-        uint32_t seed0 = static_cast<uint32_t>(prog_seed);
-        uint32_t seed1 = static_cast<uint32_t>(prog_seed >> 32);
-
-        kiss99_t rnd_state;
-        uint32_t fnv_hash = 0x811c9dc5;
-        rnd_state.z = fnv1a(fnv_hash, seed0);
-        rnd_state.w = fnv1a(fnv_hash, seed1);
-        rnd_state.jsr = fnv1a(fnv_hash, seed0);
-        rnd_state.jcong = fnv1a(fnv_hash, seed1);
-
-        // Create a random sequence of mix destinations and cache sources
-        // Merge is a read-modify-write, guaranteeing every mix element is modified every loop
-        // Guarantee no cache load is duplicated and can be optimized away
-        int mix_seq_dst[KPHash::REGS];
-        int mix_seq_cache[KPHash::REGS];
-        int mix_seq_dst_cnt = 0;
-        int mix_seq_cache_cnt = 0;
-
-        for (uint32_t i = 0; i < KPHash::REGS; i++) {
-            mix_seq_dst[i] = i;
-            mix_seq_cache[i] = i;
-        }
-
-        for (int i = KPHash::REGS - 1; i > 0; i--) {
-            int j = 0;
-            j = rnd() % (i + 1);
-            std::swap(mix_seq_dst[i], mix_seq_dst[j]);
-            j = rnd() % (i + 1);
-            std::swap(mix_seq_cache[i], mix_seq_cache[j]);
-        }
-
-        for (int i = 0; (i < KPHash::CNT_CACHE) || (i < KPHash::CNT_MATH); ++i) {
-            if (i < KPHash::CNT_CACHE) {
-                // Cached memory access
-                // lanes access random locations
-                std::string src = mix_cache();
-                std::string dest = mix_dst();
-                uint32_t r = rnd();
-                ret << "offset = " << src << " % PROGPOW_CACHE_WORDS;\n";
-                ret << "data = c_dag[offset];\n";
-                ret << merge(dest, "data", r);
-            }
-
-            if (i < KPHash::CNT_MATH) {
-                // Random Math
-                // Generate 2 unique sources
-                int src_rnd = rnd() % ((KPHash::REGS - 1) * KPHash::REGS);
-                int src1 = src_rnd % KPHash::REGS; // 0 <= src1 < KPHash::REGS
-                int src2 = src_rnd / KPHash::REGS; // 0 <= src2 < KPHash::REGS - 1
-
-                if (src2 >= src1) {
-                    ++src2; // src2 is now any reg other than src1
-                }
-
-                std::string src1_str = "mix[" + std::to_string(src1) + "]";
-                std::string src2_str = "mix[" + std::to_string(src2) + "]";
-                uint32_t r1 = rnd();
-                std::string dest = mix_dst();
-                uint32_t r2 = rnd();
-                ret << math("data", src1_str, src2_str, r1);
-                ret << merge(dest, "data", r2);
-            }
-        }
-
-        std::string kernel = std::regex_replace(std::string(kawpow_cl), std::regex("XMRIG_INCLUDE_PROGPOW_RANDOM_MATH"), ret.str());
-        ret.str(std::string());
-
-        ret << merge("mix[0]", "data_dag.s[0]", rnd());
-
-        constexpr size_t num_words_per_lane = 256 / (sizeof(uint32_t) * KPHash::LANES);
-        for (size_t i = 1; i < num_words_per_lane; i++)
-        {
-            std::string dest = mix_dst();
-            uint32_t    r = rnd();
-            ret << merge(dest, "data_dag.s[" + std::to_string(i) + "]", r);
-        }
-
-        kernel = std::regex_replace(kernel, std::regex("XMRIG_INCLUDE_PROGPOW_DATA_LOADS"), ret.str());
-        return kernel;
-    }
-
-
-    static std::string merge(const std::string& a, const std::string& b, uint32_t r)
-    {
-        switch (r % 4)
-        {
-        case 0:
-            return a + " = (" + a + " * 33) + " + b + ";\n";
-        case 1:
-            return a + " = (" + a + " ^ " + b + ") * 33;\n";
-        case 2:
-            return a + " = ROTL32(" + a + ", " + std::to_string(((r >> 16) % 31) + 1) + ") ^ " + b + ";\n";
-        case 3:
-            return a + " = ROTR32(" + a + ", " + std::to_string(((r >> 16) % 31) + 1) + ") ^ " + b + ";\n";
-        }
-        return "#error\n";
-    }
-
-
-    static std::string math(const std::string& d, const std::string& a, const std::string& b, uint32_t r)
-    {
-        switch (r % 11)
-        {
-        case 0:
-            return d + " = " + a + " + " + b + ";\n";
-        case 1:
-            return d + " = " + a + " * " + b + ";\n";
-        case 2:
-            return d + " = mul_hi(" + a + ", " + b + ");\n";
-        case 3:
-            return d + " = min(" + a + ", " + b + ");\n";
-        case 4:
-            return d + " = ROTL32(" + a + ", " + b + " % 32);\n";
-        case 5:
-            return d + " = ROTR32(" + a + ", " + b + " % 32);\n";
-        case 6:
-            return d + " = " + a + " & " + b + ";\n";
-        case 7:
-            return d + " = " + a + " | " + b + ";\n";
-        case 8:
-            return d + " = " + a + " ^ " + b + ";\n";
-        case 9:
-            return d + " = clz(" + a + ") + clz(" + b + ");\n";
-        case 10:
-            return d + " = popcount(" + a + ") + popcount(" + b + ");\n";
-        }
-        return "#error\n";
-    }
-
-
-    static uint32_t fnv1a(uint32_t& h, uint32_t d)
-    {
-        return h = (h ^ d) * 0x1000193;
-    }
-
-    static uint32_t kiss99(kiss99_t& st)
-    {
-        st.z = 36969 * (st.z & 65535) + (st.z >> 16);
-        st.w = 18000 * (st.w & 65535) + (st.w >> 16);
-        uint32_t MWC = ((st.z << 16) + st.w);
-        st.jsr ^= (st.jsr << 17);
-        st.jsr ^= (st.jsr >> 13);
-        st.jsr ^= (st.jsr << 5);
-        st.jcong = 69069 * st.jcong + 1234567;
-        return ((MWC ^ st.jcong) + st.jsr);
-    }
-
-private:
     uv_loop_t* m_loop          = nullptr;
     uv_thread_t m_loopThread   = {};
     uv_async_t m_shutdownAsync = {};
@@ -417,7 +332,7 @@ static KawPowBuilder builder;
 
 void KawPowBuilder::build_async(const IOclRunner& runner, uint64_t period, uint32_t worksize)
 {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    std::lock_guard<std::mutex> lock(m_batonMutex);
 
     if (!m_loop) {
         m_loop = new uv_loop_t{};
@@ -436,12 +351,12 @@ void KawPowBuilder::build_async(const IOclRunner& runner, uint64_t period, uint3
                 {
                     KawPowBuilder* b = reinterpret_cast<KawPowBuilder*>(handle->data);
 
-                    std::lock_guard<std::mutex> lock(b->m_mutex);
+                    std::lock_guard<std::mutex> lock(b->m_batonMutex);
                     batons = std::move(b->m_batons);
                 }
 
                 for (const KawPowBaton& baton : batons) {
-                    builder.build(baton.runner, baton.period, baton.worksize);
+                    OclLib::release(builder.build(baton.runner, baton.period, baton.worksize));
                 }
             });
 
@@ -451,6 +366,12 @@ void KawPowBuilder::build_async(const IOclRunner& runner, uint64_t period, uint3
         uv_thread_create(&m_loopThread, loop, this);
     }
 
+    for (const KawPowBaton& baton : m_batons) {
+        if (&baton.runner == &runner && baton.period == period && baton.worksize == worksize) {
+            return;
+        }
+    }
+
     m_batons.emplace_back(runner, period, worksize);
     uv_async_send(&m_batonAsync);
 }
@@ -458,13 +379,17 @@ void KawPowBuilder::build_async(const IOclRunner& runner, uint64_t period, uint3
 
 cl_kernel OclKawPow::get(const IOclRunner &runner, uint64_t height, uint32_t worksize)
 {
-    const uint64_t period = height / KPHash::PERIOD_LENGTH;
+    const uint64_t period = KPProgram::period(height);
 
-    if (!cache.search(runner, period + 1, worksize)) {
-        builder.build_async(runner, period + 1, worksize);
+    for (uint64_t i = 1; i <= kPrefetch; ++i) {
+        if (!cache.has(runner, period + i, worksize)) {
+            builder.build_async(runner, period + i, worksize);
+        }
     }
 
     cl_kernel kernel = cache.search(runner, period, worksize);
+    cache.record(kernel != nullptr);
+
     if (kernel) {
         return kernel;
     }
@@ -478,4 +403,16 @@ void OclKawPow::clear()
     cache.clear();
 }
 
+
+rapidjson::Value OclKawPow::toJSON(rapidjson::Document &doc)
+{
+    return cache.toJSON(doc);
+}
+
+
+void OclKawPow::toMetrics(Metrics &metrics)
+{
+    cache.toMetrics(metrics, "backend=\"opencl\"");
+}
+
 } // namespace xmrig
@@ -20,6 +20,9 @@
 #define XMRIG_OCLKAWPOW_H
 
 
+#include "3rdparty/rapidjson/fwd.h"
+
+
 #include <cstddef>
 #include <cstdint>
 
@@ -31,13 +34,17 @@ namespace xmrig {
 
 
 class IOclRunner;
+class Metrics;
 
 
 class OclKawPow
 {
 public:
+    // The caller owns a reference to the returned kernel and drops it with OclLib::release().
     static cl_kernel get(const IOclRunner &runner, uint64_t height, uint32_t worksize);
     static void clear();
+    static rapidjson::Value toJSON(rapidjson::Document &doc);
+    static void toMetrics(Metrics &metrics);
 };
 
 
@@ -66,6 +66,7 @@ static const char *kReleaseDevice                    = "clReleaseDevice";
 static const char *kReleaseKernel                    = "clReleaseKernel";
 static const char *kReleaseMemObject                 = "clReleaseMemObject";
 static const char *kReleaseProgram                   = "clReleaseProgram";
+static const char *kRetainKernel                     = "clRetainKernel";
 static const char *kRetainMemObject                  = "clRetainMemObject";
 static const char *kRetainProgram                    = "clRetainProgram";
 static const char *kSetKernelArg                     = "clSetKernelArg";
@@ -101,6 +102,7 @@ typedef cl_int (CL_API_CALL *releaseDevice_t)(cl_device_id device);
 typedef cl_int (CL_API_CALL *releaseKernel_t)(cl_kernel);
 typedef cl_int (CL_API_CALL *releaseMemObject_t)(cl_mem);
 typedef cl_int (CL_API_CALL *releaseProgram_t)(cl_program);
+typedef cl_int (CL_API_CALL *retainKernel_t)(cl_kernel);
 typedef cl_int (CL_API_CALL *retainMemObject_t)(cl_mem);
 typedef cl_int (CL_API_CALL *retainProgram_t)(cl_program);
 typedef cl_int (CL_API_CALL *setKernelArg_t)(cl_kernel, cl_uint, size_t, const void *);
@@ -144,6 +146,7 @@ static releaseDevice_t pReleaseDevice                                       = nu
 static releaseKernel_t pReleaseKernel                                       = nullptr;
 static releaseMemObject_t pReleaseMemObject                                 = nullptr;
 static releaseProgram_t pReleaseProgram                                     = nullptr;
+static retainKernel_t pRetainKernel                                         = nullptr;
 static retainMemObject_t pRetainMemObject                                   = nullptr;
 static retainProgram_t pRetainProgram                                       = nullptr;
 static setKernelArg_t pSetKernelArg                                         = nullptr;
@@ -238,6 +241,7 @@ bool xmrig::OclLib::load()
         DLSYM(CreateSubBuffer);
         DLSYM(RetainProgram);
         DLSYM(RetainMemObject);
+        DLSYM(RetainKernel);
     } catch (std::exception &ex) {
         return false;
     }
@@ -684,6 +688,18 @@ cl_mem xmrig::OclLib::createSubBuffer(cl_mem buffer, cl_mem_flags flags, size_t
 }
 
 
+cl_kernel xmrig::OclLib::retain(cl_kernel kernel) noexcept
+{
+    assert(pRetainKernel != nullptr);
+
+    if (kernel != nullptr) {
+        pRetainKernel(kernel);
+    }
+
+    return kernel;
+}
+
+
 cl_mem xmrig::OclLib::retain(cl_mem memobj) noexcept
 {
     assert(pRetainMemObject != nullptr);
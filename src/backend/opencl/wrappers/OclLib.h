@@ -85,6 +85,7 @@ public:
     static cl_int unloadPlatformCompiler(cl_platform_id platform) noexcept;
     static cl_kernel createKernel(cl_program program, const char *kernel_name, cl_int *errcode_ret) noexcept;
     static cl_kernel createKernel(cl_program program, const char *kernel_name);
+    static cl_kernel retain(cl_kernel kernel) noexcept;
     static cl_mem createBuffer(cl_context context, cl_mem_flags flags, size_t size, void *host_ptr = nullptr);
     static cl_mem createBuffer(cl_context context, cl_mem_flags flags, size_t size, void *host_ptr, cl_int *errcode_ret) noexcept;
     static cl_mem createSubBuffer(cl_mem buffer, cl_mem_flags flags, size_t offset, size_t size, cl_int *errcode_ret) noexcept;
@@ -39,9 +39,11 @@
 #include "base/tools/String.h"
 #include "core/config/Config.h"
 #include "core/Controller.h"
+#include "crypto/common/Nonce.h"
 
 
 #ifdef XMRIG_ALGO_KAWPOW
+#   include "backend/vulkan/runners/tools/VkKawPow.h"
 #   include "crypto/kawpow/KPCache.h"
 #   include "crypto/kawpow/KPHash.h"
 #endif
@@ -464,6 +466,7 @@ void xmrig::VkBackend::start(IWorker *worker, bool ready)
         d_ptr->status.print();
 
         VkWorker::ready = true;
+        Nonce::notify();
     }
 
     mutex.unlock();
@@ -516,6 +519,12 @@ rapidjson::Value xmrig::VkBackend::toJSON(rapidjson::Document &doc) const
 
     out.AddMember("hashrate", hashrate()->toJSON(doc), allocator);
 
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (d_ptr->algo.family() == Algorithm::KAWPOW) {
+        out.AddMember("kawpow", VkKawPow::toJSON(doc), allocator);
+    }
+#   endif
+
     Value threads(kArrayType);
 
     size_t i = 0;
@@ -523,6 +532,7 @@ rapidjson::Value xmrig::VkBackend::toJSON(rapidjson::Document &doc) const
         Value thread = data.thread.toJSON(doc);
         thread.AddMember("affinity", data.affinity, allocator);
         thread.AddMember("hashrate", hashrate()->toJSON(i, doc), allocator);
+        thread.AddMember("hashrate_stats", hashrate()->statsToJSON(i, doc), allocator);
 
         data.device.toJSON(thread, doc);
 
@@ -539,4 +549,16 @@ rapidjson::Value xmrig::VkBackend::toJSON(rapidjson::Document &doc) const
 void xmrig::VkBackend::handleRequest(IApiRequest &)
 {
 }
+
+
+void xmrig::VkBackend::toMetrics(Metrics &metrics) const
+{
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (d_ptr->algo.family() == Algorithm::KAWPOW) {
+        VkKawPow::toMetrics(metrics);
+    }
+#   else
+    (void) metrics;
+#   endif
+}
 #endif
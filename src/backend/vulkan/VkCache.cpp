@@ -75,7 +75,7 @@ tart::cl_program_ptr xmrig::VkCache::build(const IVkRunner *runner)
 {
     std::lock_guard<std::mutex> lock(mutex);
 
-    if (Nonce::sequence(Nonce::OPENCL) == 0) {
+    if (Nonce::sequence(Nonce::VULKAN) == 0) {
         return nullptr;
     }
 
@@ -52,7 +52,7 @@ public:
 
     bool isEqual(const VkLaunchData &other) const;
 
-    inline constexpr static Nonce::Backend backend() { return Nonce::OPENCL; }
+    inline constexpr static Nonce::Backend backend() { return Nonce::VULKAN; }
 
     inline bool operator!=(const VkLaunchData &other) const    { return !isEqual(other); }
     inline bool operator==(const VkLaunchData &other) const    { return isEqual(other); }
@@ -144,16 +144,13 @@ void xmrig::VkWorker::start()
 {
     uint32_t results[0x100];
 
-    while (Nonce::sequence(Nonce::OPENCL) > 0) {
+    while (Nonce::sequence(Nonce::VULKAN) > 0) {
         if (!isReady()) {
             m_sharedData.setResumeCounter(0);
 
-            do {
-                std::this_thread::sleep_for(std::chrono::milliseconds(200));
-            }
-            while (!isReady() && Nonce::sequence(Nonce::OPENCL) > 0);
+            Nonce::wait([] { return !isReady() && Nonce::sequence(Nonce::VULKAN) > 0; });
 
-            if (Nonce::sequence(Nonce::OPENCL) == 0) {
+            if (Nonce::sequence(Nonce::VULKAN) == 0) {
                 break;
             }
 
@@ -164,7 +161,7 @@ void xmrig::VkWorker::start()
             }
         }
 
-        while (!Nonce::isOutdated(Nonce::OPENCL, m_job.sequence())) {
+        while (!Nonce::isOutdated(Nonce::VULKAN, m_job.sequence())) {
             m_sharedData.adjustDelay(id());
 
             const uint64_t t = Chrono::steadyMSecs();
@@ -178,11 +175,13 @@ void xmrig::VkWorker::start()
                 return;
             }
 
+            m_switch.hashed();
+
             if (results[0xFF] > 0) {
-                JobResults::submit(m_job.currentJob(), results, results[0xFF], m_deviceIndex);
+                JobResults::submit(m_job.currentJob(), results, results[0xFF], m_deviceIndex, node());
             }
 
-            if (!Nonce::isOutdated(Nonce::OPENCL, m_job.sequence()) && !m_job.nextRound(1, intensity())) {
+            if (!Nonce::isOutdated(Nonce::VULKAN, m_job.sequence()) && !m_job.nextRound(1, intensity())) {
                 JobResults::done(m_job.currentJob());
             }
 
@@ -199,11 +198,12 @@ void xmrig::VkWorker::start()
 
 bool xmrig::VkWorker::consumeJob()
 {
-    if (Nonce::sequence(Nonce::OPENCL) == 0) {
+    if (Nonce::sequence(Nonce::VULKAN) == 0) {
         return false;
     }
 
-    m_job.add(m_miner->job(), intensity(), Nonce::OPENCL);
+    m_job.add(m_miner->job(), intensity(), Nonce::VULKAN);
+    m_switch.consumed(Nonce::VULKAN, m_job.sequence());
 
     try {
         m_runner->set(m_job.currentJob(), m_job.blob());
@@ -127,24 +127,23 @@ void VkKawPowRunner::set(const Job &job, uint8_t *blob)
     }
 
     if (epoch != m_epoch) {
-        m_epoch = epoch;
-
-        {
-            std::lock_guard<std::mutex> lock(KPCache::s_cacheMutex);
-
-            KPCache::s_cache.init(epoch);
+        const auto cache = KPCache::get(epoch);
+        if (!cache) {
+            throw std::runtime_error("KawPow light cache is not available for this epoch");
+        }
 
-            if (KPCache::s_cache.size() > m_lightCacheCapacity) {
-                m_device->deallocateBuffer(m_lightCache);//VkLib::release(m_lightCache);
+        m_epoch = epoch;
 
-                m_lightCacheCapacity = VirtualMemory::align(KPCache::s_cache.size());
-                m_lightCache = m_device->allocateBuffer(m_lightCacheCapacity);//VkLib::createBuffer(m_device, 1, m_lightCacheCapacity);
-            }
+        if (cache->size() > m_lightCacheCapacity) {
+            m_device->deallocateBuffer(m_lightCache);//VkLib::release(m_lightCache);
 
-            m_lightCacheSize = KPCache::s_cache.size();
-            enqueueWriteBuffer(m_lightCache, true, 0, m_lightCacheSize, KPCache::s_cache.data());
+            m_lightCacheCapacity = VirtualMemory::align(cache->size());
+            m_lightCache = m_device->allocateBuffer(m_lightCacheCapacity);//VkLib::createBuffer(m_device, 1, m_lightCacheCapacity);
         }
 
+        m_lightCacheSize = cache->size();
+        enqueueWriteBuffer(m_lightCache, true, 0, m_lightCacheSize, cache->data());
+
         const uint64_t start_ms = Chrono::steadyMSecs();
 
         const uint32_t dag_words = dag_size / sizeof(node);
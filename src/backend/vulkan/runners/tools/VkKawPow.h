@@ -20,6 +20,9 @@
 #define XMRIG_VKKAWPOW_H
 
 
+#include "3rdparty/rapidjson/fwd.h"
+
+
 #include <cstddef>
 #include <cstdint>
 #include "tart.hpp"
@@ -31,6 +34,7 @@ namespace xmrig {
 
 
 class IVkRunner;
+class Metrics;
 
 
 class VkKawPow
@@ -38,6 +42,8 @@ class VkKawPow
 public:
     static tart::cl_kernel_ptr get(const IVkRunner &runner, uint64_t height, uint32_t worksize);
     static void clear();
+    static rapidjson::Value toJSON(rapidjson::Document &doc);
+    static void toMetrics(Metrics &metrics);
 };
 
 
@@ -29,6 +29,8 @@
 #include "base/io/log/Log.h"
 #include "base/io/log/Tags.h"
 #include "base/kernel/Base.h"
+#include "base/net/http/HttpData.h"
+#include "base/net/http/HttpResponse.h"
 #include "base/tools/Chrono.h"
 #include "base/tools/Cvt.h"
 #include "core/config/Config.h"
@@ -108,6 +110,31 @@ xmrig::Api::~Api()
 }
 
 
+void xmrig::Api::metrics(const HttpData &req)
+{
+    size_t rss = 0;
+    uv_resident_set_memory(&rss);
+
+    m_metrics.clear();
+
+    m_metrics.set("xmrig_uptime_seconds", Metrics::GAUGE, "Time since the miner was started.");
+    m_metrics.add((Chrono::currentMSecsSinceEpoch() - m_timestamp) / 1000);
+
+    m_metrics.set("xmrig_resident_memory_bytes", Metrics::GAUGE, "Resident set size of the miner process.");
+    m_metrics.add(static_cast<uint64_t>(rss));
+
+    for (IApiListener *listener : m_listeners) {
+        listener->onMetrics(m_metrics);
+    }
+
+    const auto &body = m_metrics.render();
+
+    HttpResponse response(req.id());
+    response.setHeader(HttpData::kContentType, "text/plain; version=0.0.4");
+    response.end(body.data(), body.size());
+}
+
+
 void xmrig::Api::request(const HttpData &req)
 {
     HttpApiRequest request(req, m_base->config()->http().isRestricted());
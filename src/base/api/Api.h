@@ -23,6 +23,7 @@
 #include <vector>
 
 
+#include "base/api/Metrics.h"
 #include "base/kernel/interfaces/IBaseListener.h"
 #include "base/tools/String.h"
 
@@ -50,6 +51,7 @@ public:
     inline const char *workerId() const             { return m_workerId; }
     inline void addListener(IApiListener *listener) { m_listeners.push_back(listener); }
 
+    void metrics(const HttpData &req);
     void request(const HttpData &req);
     void start();
     void stop();
@@ -67,6 +69,7 @@ private:
     char m_id[32]{};
     const uint64_t m_timestamp;
     Httpd *m_httpd  = nullptr;
+    Metrics m_metrics;
     std::vector<IApiListener *> m_listeners;
     String m_workerId;
     uint8_t m_ticks = 0;
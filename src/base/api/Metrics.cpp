@@ -0,0 +1,125 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/api/Metrics.h"
+
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+
+namespace xmrig {
+
+
+static const char *kTypes[] = { "counter", "gauge", "histogram", "summary" };
+
+
+} // namespace xmrig
+
+
+const std::string &xmrig::Metrics::render()
+{
+    m_out.clear();
+
+    for (const auto &family : m_families) {
+        if (family.samples.empty()) {
+            continue;
+        }
+
+        m_out.append("# HELP ").append(family.name).append(" ").append(family.help).append("\n");
+        m_out.append("# TYPE ").append(family.name).append(" ").append(kTypes[family.type]).append("\n");
+        m_out.append(family.samples);
+    }
+
+    return m_out;
+}
+
+
+void xmrig::Metrics::add(double value, const char *labels, const char *suffix)
+{
+    if (std::isnan(value)) {
+        return add("NaN", labels, suffix);
+    }
+
+    if (std::isinf(value)) {
+        return add(value > 0 ? "+Inf" : "-Inf", labels, suffix);
+    }
+
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.10g", value);
+
+    add(buf, labels, suffix);
+}
+
+
+void xmrig::Metrics::add(uint64_t value, const char *labels, const char *suffix)
+{
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%" PRIu64, value);
+
+    add(buf, labels, suffix);
+}
+
+
+void xmrig::Metrics::clear()
+{
+    for (auto &family : m_families) {
+        family.samples.clear();
+    }
+
+    m_family = nullptr;
+}
+
+
+void xmrig::Metrics::set(const char *name, Type type, const char *help)
+{
+    for (auto &family : m_families) {
+        if (family.name == name || strcmp(family.name, name) == 0) {
+            m_family = &family;
+
+            return;
+        }
+    }
+
+    m_families.push_back({ name, help, type, {} });
+    m_family = &m_families.back();
+}
+
+
+void xmrig::Metrics::add(const char *value, const char *labels, const char *suffix)
+{
+    if (!m_family) {
+        return;
+    }
+
+    auto &out = m_family->samples;
+
+    out.append(m_family->name);
+
+    if (suffix) {
+        out.append(suffix);
+    }
+
+    if (labels && *labels) {
+        out.append("{").append(labels).append("}");
+    }
+
+    out.append(" ").append(value).append("\n");
+}
@@ -0,0 +1,80 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_METRICS_H
+#define XMRIG_METRICS_H
+
+
+#include "base/tools/Object.h"
+
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace xmrig {
+
+
+/**
+ * Prometheus text exposition format writer.
+ *
+ * Samples may be added in any order, they are grouped by metric family on output. Buffers are reused between
+ * requests, so a steady state render does not allocate. Names and help strings must be string literals.
+ */
+class Metrics
+{
+public:
+    XMRIG_DISABLE_COPY_MOVE(Metrics)
+
+    enum Type : uint32_t {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM,
+        SUMMARY
+    };
+
+    Metrics() = default;
+
+    const std::string &render();
+    void add(double value, const char *labels = nullptr, const char *suffix = nullptr);
+    void add(uint64_t value, const char *labels = nullptr, const char *suffix = nullptr);
+    void clear();
+    void set(const char *name, Type type, const char *help);
+
+private:
+    struct Family
+    {
+        const char *name;
+        const char *help;
+        Type type;
+        std::string samples;
+    };
+
+    void add(const char *value, const char *labels, const char *suffix);
+
+    Family *m_family = nullptr;
+    std::string m_out;
+    std::vector<Family> m_families;
+};
+
+
+} // namespace xmrig
+
+
+#endif // XMRIG_METRICS_H
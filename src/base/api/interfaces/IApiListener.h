@@ -27,6 +27,7 @@ namespace xmrig {
 
 
 class IApiRequest;
+class Metrics;
 
 
 class IApiListener
@@ -38,6 +39,7 @@ public:
     virtual ~IApiListener() = default;
 
 #   ifdef XMRIG_FEATURE_API
+    virtual void onMetrics(Metrics &metrics)     = 0;
     virtual void onRequest(IApiRequest &request) = 0;
 #   endif
 };
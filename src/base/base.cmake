@@ -82,6 +82,7 @@ set(HEADERS_BASE
     src/base/tools/cryptonote/WalletAddress.h
     src/base/tools/Cvt.h
     src/base/tools/Handle.h
+    src/base/tools/MpscQueue.h
     src/base/tools/Span.h
     src/base/tools/String.h
     src/base/tools/Timer.h
@@ -187,6 +188,7 @@ if (WITH_HTTP)
         src/3rdparty/llhttp/llhttp.h
         src/base/api/Api.h
         src/base/api/Httpd.h
+        src/base/api/Metrics.h
         src/base/api/interfaces/IApiRequest.h
         src/base/api/requests/ApiRequest.h
         src/base/api/requests/HttpApiRequest.h
@@ -198,6 +200,7 @@ if (WITH_HTTP)
         src/base/net/http/HttpClient.h
         src/base/net/http/HttpContext.h
         src/base/net/http/HttpData.h
+        src/base/net/http/HttpPool.h
         src/base/net/http/HttpResponse.h
         src/base/net/stratum/DaemonClient.h
         src/base/net/stratum/SelfSelectClient.h
@@ -210,6 +213,7 @@ if (WITH_HTTP)
         src/3rdparty/llhttp/http.c
         src/base/api/Api.cpp
         src/base/api/Httpd.cpp
+        src/base/api/Metrics.cpp
         src/base/api/requests/ApiRequest.cpp
         src/base/api/requests/HttpApiRequest.cpp
         src/base/net/http/Fetch.cpp
@@ -218,6 +222,7 @@ if (WITH_HTTP)
         src/base/net/http/HttpContext.cpp
         src/base/net/http/HttpData.cpp
         src/base/net/http/HttpListener.cpp
+        src/base/net/http/HttpPool.cpp
         src/base/net/http/HttpResponse.cpp
         src/base/net/stratum/DaemonClient.cpp
         src/base/net/stratum/SelfSelectClient.cpp
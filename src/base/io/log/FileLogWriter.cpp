@@ -22,17 +22,58 @@
 
 
 #include <cassert>
+#include <string>
 
 
 namespace xmrig {
 
 
+// Open log file shared by its in-flight writes, a rotated file is closed only after the last of them completes.
+class FileLogWriter::File
+{
+public:
+    inline File(int fd) : fd(fd) {}
+
+    inline void close()
+    {
+        uv_fs_t req{};
+        uv_fs_close(uv_default_loop(), &req, fd, nullptr);
+        uv_fs_req_cleanup(&req);
+
+        delete this;
+    }
+
+    bool rotated    = false;
+    int fd;
+    size_t pending  = 0;
+};
+
+
+class FileLogWriteReq
+{
+public:
+    inline FileLogWriteReq(FileLogWriter::File *file) : file(file) { req.data = this; }
+
+    FileLogWriter::File *file;
+    std::vector<uv_buf_t> buffers;
+    uv_fs_t req{};
+};
+
+
 static void fsWriteCallback(uv_fs_t *req)
 {
-    delete [] static_cast<char *>(req->data);
+    auto write = static_cast<FileLogWriteReq *>(req->data);
+
+    for (const uv_buf_t &buf : write->buffers) {
+        delete [] buf.base;
+    }
+
+    if (--write->file->pending == 0 && write->file->rotated) {
+        write->file->close();
+    }
 
     uv_fs_req_cleanup(req);
-    delete req;
+    delete write;
 }
 
 
@@ -44,7 +85,8 @@ xmrig::FileLogWriter::FileLogWriter()
     init();
 }
 
-xmrig::FileLogWriter::FileLogWriter(const char* fileName)
+xmrig::FileLogWriter::FileLogWriter(const char* fileName, uint64_t maxSize) :
+    m_maxSize(maxSize)
 {
     init();
     open(fileName);
@@ -72,20 +114,30 @@ bool xmrig::FileLogWriter::open(const char *fileName)
         return false;
     }
 
+    m_fileName = Env::expand(fileName);
+    m_open     = open();
+
+    return m_open;
+}
+
+
+bool xmrig::FileLogWriter::open()
+{
     uv_fs_t req{};
-    const auto path = Env::expand(fileName);
-    m_file          = uv_fs_open(uv_default_loop(), &req, path, O_CREAT | O_WRONLY, 0644, nullptr);
+    const int fd = uv_fs_open(uv_default_loop(), &req, m_fileName, O_CREAT | O_WRONLY, 0644, nullptr);
 
-    if (req.result < 0 || !isOpen()) {
+    if (req.result < 0 || fd < 0) {
         uv_fs_req_cleanup(&req);
-        m_file = -1;
+        m_file = nullptr;
 
         return false;
     }
 
     uv_fs_req_cleanup(&req);
 
-    uv_fs_stat(uv_default_loop(), &req, path, nullptr);
+    m_file = new File(fd);
+
+    uv_fs_stat(uv_default_loop(), &req, m_fileName, nullptr);
     m_pos = req.statbuf.st_size;
     uv_fs_req_cleanup(&req);
 
@@ -139,14 +191,62 @@ void xmrig::FileLogWriter::flush()
 {
     uv_mutex_lock(&m_buffersLock);
 
-    for (uv_buf_t buf : m_buffers) {
-        uv_fs_t* req = new uv_fs_t;
-        req->data = buf.base;
+    if (m_buffers.empty()) {
+        uv_mutex_unlock(&m_buffersLock);
 
-        uv_fs_write(uv_default_loop(), req, m_file, &buf, 1, m_pos, fsWriteCallback);
+        return;
+    }
+
+    // The file could not be created again after rotation.
+    if (!m_file) {
+        for (const uv_buf_t &buf : m_buffers) {
+            delete [] buf.base;
+        }
+
+        m_buffers.clear();
+        uv_mutex_unlock(&m_buffersLock);
+
+        return;
+    }
+
+    // All lines queued since the last flush go to the file with a single vectored write.
+    auto write = new FileLogWriteReq(m_file);
+    write->buffers.swap(m_buffers);
+
+    ++m_file->pending;
+    uv_fs_write(uv_default_loop(), &write->req, m_file->fd, write->buffers.data(), static_cast<unsigned int>(write->buffers.size()), m_pos, fsWriteCallback);
+
+    for (const uv_buf_t &buf : write->buffers) {
         m_pos += buf.len;
     }
-    m_buffers.clear();
+
+    if (m_maxSize && m_pos >= static_cast<int64_t>(m_maxSize)) {
+        rotate();
+    }
 
     uv_mutex_unlock(&m_buffersLock);
 }
+
+
+void xmrig::FileLogWriter::rotate()
+{
+    // The full file is kept as FILE.1 and replaces the previous one, writes still in flight land in it through the old descriptor.
+    const std::string backup = std::string(m_fileName.data()) + ".1";
+
+    uv_fs_t req{};
+    const int rc = uv_fs_rename(uv_default_loop(), &req, m_fileName, backup.c_str(), nullptr);
+    uv_fs_req_cleanup(&req);
+
+    if (rc < 0) {
+        return;
+    }
+
+    File *file = m_file;
+    file->rotated = true;
+
+    if (file->pending == 0) {
+        file->close();
+    }
+
+    open();
+}
@@ -26,18 +26,23 @@
 #include <uv.h>
 
 
+#include "base/tools/String.h"
+
+
 namespace xmrig {
 
 
 class FileLogWriter
 {
 public:
+    class File;
+
     FileLogWriter();
-    FileLogWriter(const char* fileName);
+    FileLogWriter(const char* fileName, uint64_t maxSize = 0);
 
     ~FileLogWriter();
 
-    inline bool isOpen() const  { return m_file >= 0; }
+    inline bool isOpen() const  { return m_open; }
     inline int64_t pos() const  { return m_pos; }
 
     bool open(const char *fileName);
@@ -51,15 +56,20 @@ private:
     const char m_endl[2]  = {'\n', 0};
 #   endif
 
-    int m_file      = -1;
-    int64_t m_pos   = 0;
+    bool m_open         = false;
+    File *m_file        = nullptr;
+    int64_t m_pos       = 0;
+    String m_fileName;
+    uint64_t m_maxSize  = 0;      // rotate once the file grows over this size, 0 disables rotation
 
     uv_mutex_t m_buffersLock;
     std::vector<uv_buf_t> m_buffers;
 
     uv_async_t m_flushAsync;
 
+    bool open();
     void init();
+    void rotate();
 
     static void on_flush(uv_async_t* async) { reinterpret_cast<FileLogWriter*>(async->data)->flush(); }
     void flush();
@@ -24,11 +24,15 @@
 
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <uv.h>
 #include <vector>
 
@@ -36,6 +40,7 @@
 #include "base/io/log/Log.h"
 #include "base/kernel/interfaces/ILogBackend.h"
 #include "base/tools/Chrono.h"
+#include "base/tools/MpscQueue.h"
 #include "base/tools/Object.h"
 
 
@@ -70,35 +75,124 @@ public:
 
     inline ~LogPrivate()
     {
+        stop();
+
         for (auto backend : m_backends) {
             delete backend;
         }
     }
 
 
-    inline void add(ILogBackend *backend) { m_backends.push_back(backend); }
+    inline void add(ILogBackend *backend)
+    {
+        // The drain thread may already iterate the backends in write().
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_backends.push_back(backend);
+            m_hasBackends = true;
+        }
+
+        // Started with the first backend, after the process was forked into background.
+        if (!m_async) {
+            m_thread = std::thread(&LogPrivate::run, this);
+            m_async  = true;
+        }
+    }
 
 
     void print(Log::Level level, const char *fmt, va_list args)
     {
-        size_t size   = 0;
-        size_t offset = 0;
-
-        std::lock_guard<std::mutex> lock(m_mutex);
-
-        if (Log::isBackground() && m_backends.empty()) {
+        if (Log::isBackground() && !m_hasBackends) {
             return;
         }
 
-        const uint64_t ts = timestamp(level, size, offset);
-        color(level, size);
+        // The caller only formats the message, the timestamp, colors and backends are handled by the drain thread.
+        thread_local char buf[Log::kMaxBufferSize];
 
-        const int rc = vsnprintf(m_buf + size, sizeof (m_buf) - offset - 32, fmt, args);
+        const uint64_t ts = Chrono::currentMSecsSinceEpoch();
+        const int rc      = vsnprintf(buf, sizeof(buf), fmt, args);
         if (rc < 0) {
             return;
         }
 
-        size += std::min(static_cast<size_t>(rc), sizeof (m_buf) - offset - 32);
+        m_queue.push({ ts, level, std::string(buf, std::min(static_cast<size_t>(rc), sizeof(buf) - 1)) });
+
+        // Errors are written before returning, the caller may be about to terminate.
+        if (!m_async || (level != Log::NONE && level <= Log::ERR)) {
+            return flush();
+        }
+
+        if (!m_pending.exchange(true)) {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_wake.notify_one();
+        }
+    }
+
+
+    void flush()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_queue.consume([this](Record &&record) { write(record); });
+    }
+
+
+    void stop()
+    {
+        if (m_async) {
+            m_async = false;
+
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                m_stop = true;
+            }
+
+            m_wake.notify_one();
+            m_thread.join();
+        }
+
+        flush();
+    }
+
+
+private:
+    struct Record
+    {
+        uint64_t ts;
+        Log::Level level;
+        std::string text;
+    };
+
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+
+        while (!m_stop) {
+            m_wake.wait(lock, [this] { return m_stop || m_pending.load(); });
+
+            if (m_pending.exchange(false)) {
+                lock.unlock();
+                flush();
+                lock.lock();
+            }
+        }
+    }
+
+
+    void write(const Record &record)
+    {
+        const Log::Level level = record.level;
+        size_t size            = 0;
+        size_t offset          = 0;
+
+        timestamp(record.ts, level, size, offset);
+        color(level, size);
+
+        const size_t n = std::min(record.text.size(), sizeof (m_buf) - size - 32);
+        memcpy(m_buf + size, record.text.data(), n);
+
+        size += n;
         endl(size);
 
         std::string txt(m_buf);
@@ -109,8 +203,8 @@ public:
 
         if (!m_backends.empty()) {
             for (auto backend : m_backends) {
-                backend->print(ts, level, m_buf, offset, size, true);
-                backend->print(ts, level, txt.c_str(), offset ? (offset - 11) : 0, txt.size(), false);
+                backend->print(record.ts, level, m_buf, offset, size, true);
+                backend->print(record.ts, level, txt.c_str(), offset ? (offset - 11) : 0, txt.size(), false);
             }
         }
         else {
@@ -120,13 +214,10 @@ public:
     }
 
 
-private:
-    inline uint64_t timestamp(Log::Level level, size_t &size, size_t &offset)
+    inline void timestamp(uint64_t ms, Log::Level level, size_t &size, size_t &offset)
     {
-        const uint64_t ms = Chrono::currentMSecsSinceEpoch();
-
         if (level == Log::NONE) {
-            return ms;
+            return;
         }
 
         time_t now = ms / 1000;
@@ -151,8 +242,6 @@ private:
         if (rc > 0) {
             size = offset = static_cast<size_t>(rc);
         }
-
-        return ms;
     }
 
 
@@ -186,8 +275,16 @@ private:
     }
 
 
+    bool m_stop = false;
     char m_buf[Log::kMaxBufferSize]{};
+    MpscQueue<Record> m_queue;
+    std::atomic<bool> m_async{ false };
+    std::atomic<bool> m_hasBackends{ false };  // callers can't read m_backends without m_mutex
+    std::atomic<bool> m_pending{ false };
+    std::condition_variable m_wake;
     std::mutex m_mutex;
+    std::mutex m_wakeMutex;
+    std::thread m_thread;
     std::vector<ILogBackend*> m_backends;
 };
 
@@ -222,6 +319,16 @@ void xmrig::Log::destroy()
 void xmrig::Log::init()
 {
     d = new LogPrivate();
+
+    // Lines still queued for the drain thread are written out if the process exits without destroy().
+    static std::once_flag atexitOnce;
+    std::call_once(atexitOnce, [] {
+        std::atexit([] {
+            if (d) {
+                d->stop();
+            }
+        });
+    });
 }
 
 
@@ -25,8 +25,8 @@
 #include <cstring>
 
 
-xmrig::FileLog::FileLog(const char *fileName) :
-    m_writer(fileName)
+xmrig::FileLog::FileLog(const char *fileName, uint64_t maxSize) :
+    m_writer(fileName, maxSize)
 {
 }
 
@@ -37,6 +37,11 @@
 #include "version.h"
 
 
+#ifdef XMRIG_FEATURE_HTTP
+#   include "base/net/http/HttpPool.h"
+#endif
+
+
 #ifdef HAVE_SYSLOG_H
 #   include "base/io/log/backends/SysLog.h"
 #endif
@@ -197,7 +202,7 @@ int xmrig::Base::init()
     }
 
     if (config()->logFile()) {
-        Log::add(new FileLog(config()->logFile()));
+        Log::add(new FileLog(config()->logFile(), config()->logFileSize() * 1024ULL * 1024ULL));
     }
 
 #   ifdef HAVE_SYSLOG_H
@@ -232,6 +237,10 @@ void xmrig::Base::stop()
     api()->stop();
 #   endif
 
+#   ifdef XMRIG_FEATURE_HTTP
+    HttpPool::closeAll();
+#   endif
+
     delete d_ptr->watcher;
     d_ptr->watcher = nullptr;
 }
@@ -60,6 +60,8 @@ protected:
     void onFileChanged(const String &fileName) override;
 
 #   ifdef XMRIG_FEATURE_API
+    inline void onMetrics(Metrics &) override {}
+
     void onRequest(IApiRequest &request) override;
 #   endif
 
@@ -56,6 +56,7 @@ const char *BaseConfig::kColors         = "colors";
 const char *BaseConfig::kDryRun         = "dry-run";
 const char *BaseConfig::kHttp           = "http";
 const char *BaseConfig::kLogFile        = "log-file";
+const char *BaseConfig::kLogFileSize    = "log-file-size";
 const char *BaseConfig::kPrintTime      = "print-time";
 const char *BaseConfig::kSyslog         = "syslog";
 const char *BaseConfig::kTitle          = "title";
@@ -86,6 +87,7 @@ bool xmrig::BaseConfig::read(const IJsonReader &reader, const char *fileName)
     m_syslog            = reader.getBool(kSyslog, m_syslog);
     m_watch             = reader.getBool(kWatch, m_watch);
     m_logFile           = reader.getString(kLogFile);
+    m_logFileSize       = reader.getUint(kLogFileSize, m_logFileSize);
     m_userAgent         = reader.getString(kUserAgent);
     m_printTime         = std::min(reader.getUint(kPrintTime, m_printTime), 3600U);
     m_title             = reader.getValue(kTitle);
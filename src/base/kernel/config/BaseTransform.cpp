@@ -240,7 +240,11 @@ void xmrig::BaseTransform::transform(rapidjson::Document &doc, int key, const ch
 
     case IConfig::RetriesKey:       /* --retries */
     case IConfig::RetryPauseKey:    /* --retry-pause */
+    case IConfig::StandbyPoolsKey:  /* --standby-pools */
+    case IConfig::StallTimeoutKey:  /* --stall-timeout */
+    case IConfig::SubmitDelayKey:   /* --submit-delay */
     case IConfig::PrintTimeKey:     /* --print-time */
+    case IConfig::LogFileSizeKey:   /* --log-file-size */
     case IConfig::HttpPort:         /* --http-port */
     case IConfig::DonateLevelKey:   /* --donate-level */
     case IConfig::DaemonPollKey:    /* --daemon-poll-interval */
@@ -342,6 +346,15 @@ void xmrig::BaseTransform::transformUint64(rapidjson::Document &doc, int key, ui
     case IConfig::RetryPauseKey: /* --retry-pause */
         return set(doc, Pools::kRetryPause, arg);
 
+    case IConfig::StandbyPoolsKey: /* --standby-pools */
+        return set(doc, Pools::kStandby, arg);
+
+    case IConfig::StallTimeoutKey: /* --stall-timeout */
+        return set(doc, Pools::kStallTimeout, arg);
+
+    case IConfig::SubmitDelayKey: /* --submit-delay */
+        return set(doc, Pools::kSubmitDelay, arg);
+
     case IConfig::DonateLevelKey: /* --donate-level */
         return set(doc, Pools::kDonateLevel, arg);
 
@@ -355,6 +368,9 @@ void xmrig::BaseTransform::transformUint64(rapidjson::Document &doc, int key, ui
     case IConfig::PrintTimeKey: /* --print-time */
         return set(doc, BaseConfig::kPrintTime, arg);
 
+    case IConfig::LogFileSizeKey: /* --log-file-size */
+        return set(doc, BaseConfig::kLogFileSize, arg);
+
     case IConfig::DnsTtlKey: /* --dns-ttl */
         return set(doc, DnsConfig::kField, DnsConfig::kTTL, arg);
 
@@ -88,11 +88,15 @@ public:
         HugePagesJitKey      = 1057,
         RotationKey          = 1058,
         DaemonJobTimeoutKey  = 1059,
+        StandbyPoolsKey      = 1063,
+        StallTimeoutKey      = 1064,
+        SubmitDelayKey       = 1065,
 
         // xmrig common
         CPUPriorityKey       = 1021,
         NicehashKey          = 1006,
         PrintTimeKey         = 1007,
+        LogFileSizeKey       = 1066,
 
         // xmrig cpu
         CPUKey               = 1024,
@@ -113,6 +117,9 @@ public:
         YieldKey             = 1030,
         Argon2ImplKey        = 1039,
         RandomXCacheQoSKey   = 1040,
+        RandomXDoubleBufferKey = 1060,
+        RandomXDatasetCacheKey = 1061,
+        RandomXMemoryBudgetKey = 1062,
 
         // xmrig amd
         OclPlatformKey       = 1400,
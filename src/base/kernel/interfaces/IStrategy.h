@@ -27,6 +27,7 @@
 
 
 #include <cstdint>
+#include <functional>
 
 
 namespace xmrig {
@@ -41,17 +42,20 @@ class ProxyUrl;
 class IStrategy
 {
 public:
+    using ClientVisitor = std::function<void(const IClient *client, bool online)>;
+
     virtual ~IStrategy() = default;
 
-    virtual bool isActive() const                      = 0;
-    virtual IClient *client() const                    = 0;
-    virtual int64_t submit(const JobResult &result)    = 0;
-    virtual void connect()                             = 0;
-    virtual void resume()                              = 0;
-    virtual void setAlgo(const Algorithm &algo)        = 0;
-    virtual void setProxy(const ProxyUrl &proxy)       = 0;
-    virtual void stop()                                = 0;
-    virtual void tick(uint64_t now)                    = 0;
+    virtual bool isActive() const                                   = 0;
+    virtual IClient *client() const                                 = 0;
+    virtual int64_t submit(const JobResult &result)                 = 0;
+    virtual void connect()                                          = 0;
+    virtual void forEachClient(const ClientVisitor &visitor) const  = 0;
+    virtual void resume()                                           = 0;
+    virtual void setAlgo(const Algorithm &algo)                     = 0;
+    virtual void setProxy(const ProxyUrl &proxy)                    = 0;
+    virtual void stop()                                             = 0;
+    virtual void tick(uint64_t now)                                 = 0;
 };
 
 
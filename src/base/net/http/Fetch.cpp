@@ -21,12 +21,11 @@
 #include "3rdparty/rapidjson/stringbuffer.h"
 #include "3rdparty/rapidjson/writer.h"
 #include "base/io/log/Log.h"
-#include "base/net/http/HttpClient.h"
+#include "base/net/http/HttpData.h"
+#include "base/net/http/HttpPool.h"
 
 
-#ifdef XMRIG_FEATURE_TLS
-#   include "base/net/https/HttpsClient.h"
-#endif
+#include <cassert>
 
 
 xmrig::FetchRequest::FetchRequest(llhttp_method method, const String &host, uint16_t port, const String &path, bool tls, bool quiet, const char *data, size_t size, const char *contentType) :
@@ -105,18 +104,9 @@ void xmrig::fetch(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttp
     }
 #   endif
 
-    HttpClient *client = nullptr;
-#   ifdef XMRIG_FEATURE_TLS
-    if (req.tls) {
-        client = new HttpsClient(tag, std::move(req), listener);
-    }
-    else
-#   endif
-    {
-        client = new HttpClient(tag, std::move(req), listener);
+    if (req.keepAlive) {
+        return HttpPool::fetch(tag, std::move(req), listener, type, rpcId);
     }
 
-    client->userType = type;
-    client->rpcId    = rpcId;
-    client->connect();
+    HttpPool::connect(tag, std::move(req), listener, type, rpcId);
 }
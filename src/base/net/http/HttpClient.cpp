@@ -24,6 +24,7 @@
 #include "base/kernel/Platform.h"
 #include "base/net/dns/Dns.h"
 #include "base/net/dns/DnsRecords.h"
+#include "base/net/http/HttpPool.h"
 #include "base/net/tools/NetBuffer.h"
 #include "base/tools/Timer.h"
 
@@ -43,16 +44,21 @@ static const char *kCRLF = "\r\n";
 
 xmrig::HttpClient::HttpClient(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener) :
     HttpContext(HTTP_RESPONSE, listener),
-    m_tag(tag),
-    m_req(std::move(req))
+    m_req(std::move(req)),
+    m_tag(tag)
 {
-    method  = m_req.method;
-    url     = std::move(m_req.path);
-    body    = std::move(m_req.body);
-    headers = std::move(m_req.headers);
+    if (m_req.timeout || m_req.keepAlive) {
+        m_timer = std::make_shared<Timer>(this);
+    }
+
+    prepare();
+}
+
 
-    if (m_req.timeout) {
-        m_timer = std::make_shared<Timer>(this, m_req.timeout, 0);
+xmrig::HttpClient::~HttpClient()
+{
+    if (m_req.keepAlive) {
+        HttpPool::remove(this);
     }
 }
 
@@ -65,6 +71,64 @@ bool xmrig::HttpClient::connect()
 }
 
 
+void xmrig::HttpClient::close(int status)
+{
+    // The server may close an idle keep-alive connection at any moment, a request written to such connection
+    // that got no response at all is sent again once, instead of failing.
+    if (status < 0 && status != UV_ETIMEDOUT && m_reused && m_busy && !m_received && !isClosing()) {
+        const auto listener = this->listener();
+        m_busy = false;
+
+        setListener({});
+        HttpContext::close(status);
+
+        return HttpPool::fetch(m_tag, FetchRequest(m_req), listener, userType, rpcId);
+    }
+
+    HttpContext::close(status);
+}
+
+
+void xmrig::HttpClient::idle(uint64_t timeout)
+{
+    m_timer->start(timeout, 0);
+}
+
+
+void xmrig::HttpClient::send(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId)
+{
+    m_tag           = tag;
+    m_req           = std::move(req);
+    m_busy          = true;
+    m_received      = false;
+    m_reused        = true;
+    this->userType  = type;
+    this->rpcId     = rpcId;
+
+    setListener(listener);
+    prepare();
+
+    // TLS session (if any) is already established, so the request is written right away.
+    HttpClient::handshake();
+}
+
+
+void xmrig::HttpClient::onMessageComplete(bool keepAlive)
+{
+    m_busy = false;
+
+    if (!m_req.keepAlive) {
+        return;
+    }
+
+    if (!keepAlive) {
+        return close();
+    }
+
+    HttpPool::release(this);
+}
+
+
 void xmrig::HttpClient::onResolved(const DnsRecords &records, int status, const char *error)
 {
     this->status = status;
@@ -75,7 +139,7 @@ void xmrig::HttpClient::onResolved(const DnsRecords &records, int status, const
             LOG_ERR("%s " RED("DNS error: ") RED_BOLD("\"%s\""), tag(), error);
         }
 
-        return;
+        return close(status);
     }
 
     auto req  = new uv_connect_t;
@@ -94,7 +158,7 @@ void xmrig::HttpClient::onTimer(const Timer *)
 void xmrig::HttpClient::handshake()
 {
     headers.insert({ "Host",       host() });
-    headers.insert({ "Connection", "close" });
+    headers.insert({ "Connection", m_req.keepAlive ? "keep-alive" : "close" });
     headers.insert({ "User-Agent", Platform::userAgent().data() });
 
     if (!body.empty()) {
@@ -119,6 +183,8 @@ void xmrig::HttpClient::handshake()
 
 void xmrig::HttpClient::read(const char *data, size_t size)
 {
+    m_received = m_received || size > 0;
+
     if (!parse(data, size)) {
         close(UV_EPROTO);
     }
@@ -166,3 +232,22 @@ void xmrig::HttpClient::onConnect(uv_connect_t *req, int status)
 
     client->handshake();
 }
+
+
+void xmrig::HttpClient::prepare()
+{
+    // The request is copied rather than moved, so it can be sent again over another connection.
+    method  = m_req.method;
+    url     = m_req.path;
+    body    = m_req.body;
+    headers = m_req.headers;
+
+    if (m_timer) {
+        if (m_req.timeout) {
+            m_timer->start(m_req.timeout, 0);
+        }
+        else {
+            m_timer->stop();
+        }
+    }
+}
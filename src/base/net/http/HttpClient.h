@@ -41,32 +41,39 @@ public:
     XMRIG_DISABLE_COPY_MOVE_DEFAULT(HttpClient);
 
     HttpClient(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener);
-    ~HttpClient() override = default;
+    ~HttpClient() override;
 
     inline bool isQuiet() const                 { return m_req.quiet; }
     inline const char *host() const override    { return m_req.host; }
     inline const char *tag() const              { return m_tag; }
+    inline const FetchRequest &req() const      { return m_req; }
     inline uint16_t port() const override       { return m_req.port; }
 
     bool connect();
+    void close(int status = 0) override;
+    void idle(uint64_t timeout);
+    void send(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId);
 
 protected:
+    void onMessageComplete(bool keepAlive) override;
     void onResolved(const DnsRecords &records, int status, const char *error) override;
     void onTimer(const Timer *timer) override;
 
     virtual void handshake();
     virtual void read(const char *data, size_t size);
 
-protected:
-    inline const FetchRequest &req() const  { return m_req; }
-
 private:
     static void onConnect(uv_connect_t *req, int status);
 
-    const char *m_tag;
+    void prepare();
+
+    bool m_busy     = true;
+    bool m_received = false;
+    bool m_reused   = false;
     FetchRequest m_req;
     std::shared_ptr<DnsRequest> m_dns;
     std::shared_ptr<Timer> m_timer;
+    String m_tag;
 };
 
 
@@ -112,6 +112,12 @@ void xmrig::HttpContext::write(std::string &&data, bool close)
 }
 
 
+bool xmrig::HttpContext::isClosing() const
+{
+    return get(id()) == nullptr || uv_is_closing(handle());
+}
+
+
 bool xmrig::HttpContext::isRequest() const
 {
     return m_parser->type == HTTP_REQUEST;
@@ -273,6 +279,8 @@ void xmrig::HttpContext::attach(llhttp_settings_t *settings)
             ctx->m_listener.reset();
         }
 
+        ctx->onMessageComplete(llhttp_should_keep_alive(parser) == 1);
+
         return 0;
     };
 }
@@ -61,16 +61,22 @@ public:
 
     void write(std::string &&data, bool close) override;
 
+    bool isClosing() const;
     bool isRequest() const override;
     bool parse(const char *data, size_t size);
     std::string ip() const override;
     uint64_t elapsed() const;
-    void close(int status = 0);
+    virtual void close(int status = 0);
 
     static HttpContext *get(uint64_t id);
     static void closeAll();
 
 protected:
+    inline const std::weak_ptr<IHttpListener> &listener() const             { return m_listener; }
+    inline void setListener(const std::weak_ptr<IHttpListener> &listener)   { m_listener = listener; }
+
+    virtual void onMessageComplete(bool keepAlive)                          { (void) keepAlive; }
+
     uv_tcp_t *m_tcp;
 
 private:
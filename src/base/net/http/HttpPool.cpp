@@ -0,0 +1,199 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/net/http/HttpPool.h"
+#include "base/net/http/HttpClient.h"
+
+
+#ifdef XMRIG_FEATURE_TLS
+#   include "base/net/https/HttpsClient.h"
+#endif
+
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+
+namespace xmrig {
+
+
+class HttpPending
+{
+public:
+    inline HttpPending(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId) :
+        tag(tag),
+        req(std::move(req)),
+        listener(listener),
+        type(type),
+        rpcId(rpcId)
+    {}
+
+    String tag;
+    FetchRequest req;
+    std::weak_ptr<IHttpListener> listener;
+    int type;
+    uint64_t rpcId;
+};
+
+
+class HttpHost
+{
+public:
+    size_t connections = 0;
+    std::deque<HttpPending> pending;
+    std::vector<HttpClient *> idle;
+};
+
+
+static bool closing = false;
+static std::map<std::string, HttpHost> hosts;
+
+
+static std::string poolKey(const FetchRequest &req)
+{
+    std::string key = req.tls ? "https://" : "http://";
+    key += req.host.data();
+    key += ":" + std::to_string(req.port);
+
+    if (req.tls && !req.fingerprint.isNull()) {
+        key += "/";
+        key += req.fingerprint.data();
+    }
+
+    return key;
+}
+
+
+} // namespace xmrig
+
+
+xmrig::HttpClient *xmrig::HttpPool::connect(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId)
+{
+    HttpClient *client = nullptr;
+#   ifdef XMRIG_FEATURE_TLS
+    if (req.tls) {
+        client = new HttpsClient(tag, std::move(req), listener);
+    }
+    else
+#   endif
+    {
+        client = new HttpClient(tag, std::move(req), listener);
+    }
+
+    client->userType = type;
+    client->rpcId    = rpcId;
+    client->connect();
+
+    return client;
+}
+
+
+void xmrig::HttpPool::closeAll()
+{
+    closing = true;
+
+    for (auto &kv : hosts) {
+        kv.second.pending.clear();
+
+        // close() may call remove() later from the close callback, so work on a copy.
+        const auto idle = std::move(kv.second.idle);
+        kv.second.idle.clear();
+
+        for (auto client : idle) {
+            client->close();
+        }
+    }
+}
+
+
+void xmrig::HttpPool::fetch(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId)
+{
+    if (closing) {
+        return;
+    }
+
+    auto &host = hosts[poolKey(req)];
+
+    while (!host.idle.empty()) {
+        auto client = host.idle.back();
+        host.idle.pop_back();
+
+        if (!client->isClosing()) {
+            return client->send(tag, std::move(req), listener, type, rpcId);
+        }
+    }
+
+    if (host.connections < kMaxConnections) {
+        host.connections++;
+        connect(tag, std::move(req), listener, type, rpcId);
+
+        return;
+    }
+
+    host.pending.emplace_back(tag, std::move(req), listener, type, rpcId);
+}
+
+
+void xmrig::HttpPool::release(HttpClient *client)
+{
+    if (closing) {
+        return client->close();
+    }
+
+    auto &host = hosts[poolKey(client->req())];
+
+    if (!host.pending.empty()) {
+        auto pending = std::move(host.pending.front());
+        host.pending.pop_front();
+
+        return client->send(pending.tag, std::move(pending.req), pending.listener, pending.type, pending.rpcId);
+    }
+
+    host.idle.push_back(client);
+    client->idle(kIdleTimeout);
+}
+
+
+void xmrig::HttpPool::remove(HttpClient *client)
+{
+    const auto it = hosts.find(poolKey(client->req()));
+    if (it == hosts.end()) {
+        return;
+    }
+
+    auto &host = it->second;
+    host.idle.erase(std::remove(host.idle.begin(), host.idle.end(), client), host.idle.end());
+
+    if (host.connections) {
+        host.connections--;
+    }
+
+    if (!closing && !host.pending.empty()) {
+        auto pending = std::move(host.pending.front());
+        host.pending.pop_front();
+
+        host.connections++;
+        connect(pending.tag, std::move(pending.req), pending.listener, pending.type, pending.rpcId);
+    }
+    else if (host.connections == 0) {
+        hosts.erase(it);
+    }
+}
@@ -0,0 +1,60 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef XMRIG_HTTPPOOL_H
+#define XMRIG_HTTPPOOL_H
+
+
+#include <cstdint>
+#include <memory>
+
+
+namespace xmrig {
+
+
+class FetchRequest;
+class HttpClient;
+class IHttpListener;
+
+
+/**
+ * Keep-alive connections for outgoing HTTP requests, keyed by scheme, host, port and TLS fingerprint.
+ *
+ * A request takes an idle connection if there is one, otherwise opens a new one up to kMaxConnections per key,
+ * the rest wait in a FIFO queue and are written to the first connection that becomes idle.
+ * Requests are not pipelined, each connection carries one request at a time.
+ */
+class HttpPool
+{
+public:
+    constexpr static size_t kMaxConnections = 4;
+    constexpr static uint64_t kIdleTimeout  = 15000;
+
+    static HttpClient *connect(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId);
+    static void closeAll();
+    static void fetch(const char *tag, FetchRequest &&req, const std::weak_ptr<IHttpListener> &listener, int type, uint64_t rpcId);
+    static void release(HttpClient *client);
+    static void remove(HttpClient *client);
+};
+
+
+} // namespace xmrig
+
+
+#endif // XMRIG_HTTPPOOL_H
@@ -95,3 +95,23 @@ bool xmrig::BaseClient::handleSubmitResponse(int64_t id, const char *error)
 
     return false;
 }
+
+
+void xmrig::BaseClient::failResults(const char *error)
+{
+    if (m_results.empty()) {
+        return;
+    }
+
+    auto results = std::move(m_results);
+    m_results.clear();
+
+    if (!m_listener) {
+        return;
+    }
+
+    for (auto &kv : results) {
+        kv.second.done();
+        m_listener->onResultAccepted(this, kv.second, error);
+    }
+}
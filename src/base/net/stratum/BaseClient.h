@@ -80,6 +80,7 @@ protected:
 
     virtual bool handleResponse(int64_t id, const rapidjson::Value &result, const rapidjson::Value &error);
     bool handleSubmitResponse(int64_t id, const char *error = nullptr);
+    void failResults(const char *error);
 
     bool m_quiet                    = false;
     IClientListener *m_listener;
@@ -38,6 +38,7 @@
 #include "3rdparty/rapidjson/error/en.h"
 #include "3rdparty/rapidjson/stringbuffer.h"
 #include "3rdparty/rapidjson/writer.h"
+#include "base/io/Async.h"
 #include "base/io/json/Json.h"
 #include "base/io/json/JsonRequest.h"
 #include "base/io/log/Log.h"
@@ -62,6 +63,84 @@ namespace xmrig {
 
 Storage<Client> Client::m_storage;
 
+// Values and the parser stack share the client's parse allocator, so a message that fits into the parse buffer is decoded without heap allocations.
+using ParseDocument = rapidjson::GenericDocument<rapidjson::UTF8<>, rapidjson::MemoryPoolAllocator<>, rapidjson::MemoryPoolAllocator<>>;
+
+
+template<size_t N>
+static inline char *writeRaw(char *out, const char (&str)[N])
+{
+    memcpy(out, str, N - 1);
+
+    return out + N - 1;
+}
+
+
+static inline char *writeInt(char *out, int64_t value)
+{
+    char tmp[24];
+    size_t size = 0;
+    uint64_t v  = value < 0 ? (0 - static_cast<uint64_t>(value)) : static_cast<uint64_t>(value);
+
+    if (value < 0) {
+        *out++ = '-';
+    }
+
+    do {
+        tmp[size++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v);
+
+    while (size) {
+        *out++ = tmp[--size];
+    }
+
+    return out;
+}
+
+
+// Same escaping as rapidjson::Writer, worst case output is 6 bytes per input character plus quotes.
+static char *writeString(char *out, const char *str)
+{
+    static const char hex[] = "0123456789ABCDEF";
+
+    *out++ = '"';
+
+    for (const char *p = str; p && *p; ++p) {
+        const auto c = static_cast<uint8_t>(*p);
+
+        if (c == '"' || c == '\\') {
+            *out++ = '\\';
+            *out++ = static_cast<char>(c);
+        }
+        else if (c < 0x20) {
+            *out++ = '\\';
+
+            switch (c) {
+            case '\b': *out++ = 'b'; break;
+            case '\f': *out++ = 'f'; break;
+            case '\n': *out++ = 'n'; break;
+            case '\r': *out++ = 'r'; break;
+            case '\t': *out++ = 't'; break;
+
+            default:
+                out    = writeRaw(out, "u00");
+                *out++ = hex[c >> 4];
+                *out++ = hex[c & 0xF];
+                break;
+            }
+        }
+        else {
+            *out++ = static_cast<char>(c);
+        }
+    }
+
+    *out++ = '"';
+
+    return out;
+}
+
+
 } /* namespace xmrig */
 
 
@@ -80,9 +159,11 @@ static const char *states[] = {
 xmrig::Client::Client(int id, const char *agent, IClientListener *listener) :
     BaseClient(id, listener),
     m_agent(agent),
-    m_sendBuf(1024),
-    m_tempBuf(256)
+    m_parseBuf(kParseBufferSize),
+    m_sendBuf(1024)
 {
+    m_parseAllocator = new rapidjson::MemoryPoolAllocator<>(m_parseBuf.data(), m_parseBuf.size());
+    m_flushAsync     = std::make_shared<Async>([this] { flush(); });
     m_reader.setListener(this);
     m_key = m_storage.add(this);
 }
@@ -90,6 +171,7 @@ xmrig::Client::Client(int id, const char *agent, IClientListener *listener) :
 
 xmrig::Client::~Client()
 {
+    delete m_parseAllocator;
     delete m_socket;
 }
 
@@ -190,56 +272,25 @@ int64_t xmrig::Client::submit(const JobResult &result)
         return -1;
     }
 
-    using namespace rapidjson;
-
-#   ifdef XMRIG_PROXY_PROJECT
-    const char *nonce = result.nonce;
-    const char *data  = result.result;
-#   else
-    char *nonce = m_tempBuf.data();
-    char *data  = m_tempBuf.data() + 16;
-    char *signature = m_tempBuf.data() + 88;
-
-    Cvt::toHex(nonce, sizeof(uint32_t) * 2 + 1, reinterpret_cast<const uint8_t *>(&result.nonce), sizeof(uint32_t));
-    Cvt::toHex(data, 65, result.result(), 32);
-
-    if (result.minerSignature()) {
-        Cvt::toHex(signature, 129, result.minerSignature(), 64);
-    }
-#   endif
-
-    Document doc(kObjectType);
-    auto &allocator = doc.GetAllocator();
-
-    Value params(kObjectType);
-    params.AddMember("id",     StringRef(m_rpcId.data()), allocator);
-    params.AddMember("job_id", StringRef(result.jobId.data()), allocator);
-    params.AddMember("nonce",  StringRef(nonce), allocator);
-    params.AddMember("result", StringRef(data), allocator);
+    // The line is formatted straight into the pending batch, the unused tail of the worst case estimate is cut off.
+    const size_t offset = m_batch.size();
+    const size_t size   = writeSubmit(result, m_batch, offset);
+    m_batch.resize(offset + size);
 
-#   ifndef XMRIG_PROXY_PROJECT
-    if (result.minerSignature()) {
-        params.AddMember("sig", StringRef(signature), allocator);
-    }
-#   else
-    if (result.sig) {
-        params.AddMember("sig", StringRef(result.sig), allocator);
-    }
-#   endif
+    if (size == 0) {
+        LOG_ERR("%s " RED("send failed: ") RED_BOLD("\"max send buffer size exceeded\""), tag());
+        close();
 
-    if (has<EXT_ALGO>() && result.algorithm.isValid()) {
-        params.AddMember("algo", StringRef(result.algorithm.name()), allocator);
+        return -1;
     }
 
-    JsonRequest::create(doc, m_sequence, "submit", params);
-
 #   ifdef XMRIG_PROXY_PROJECT
     m_results[m_sequence] = SubmitResult(m_sequence, result.diff, result.actualDiff(), result.id, 0);
 #   else
     m_results[m_sequence] = SubmitResult(m_sequence, result.diff, result.actualDiff(), 0, result.backend);
 #   endif
 
-    return send(doc);
+    return enqueue(offset, size);
 }
 
 
@@ -333,6 +384,11 @@ void xmrig::Client::onResolved(const DnsRecords &records, int status, const char
 
 bool xmrig::Client::close()
 {
+    m_batch.clear();
+
+    // Nothing sent so far gets a response after reconnect, including ids handed out for a batch that was never written.
+    failResults("connection closed");
+
     if (m_state == ClosingState) {
         return m_socket != nullptr;
     }
@@ -354,6 +410,147 @@ bool xmrig::Client::close()
 }
 
 
+size_t xmrig::Client::writeSubmit(const JobResult &result, std::vector<char> &buf, size_t offset)
+{
+#   ifdef XMRIG_PROXY_PROJECT
+    size_t strings = m_rpcId.size() + result.jobId.size() + strlen(result.nonce) + strlen(result.result) + (result.sig ? strlen(result.sig) : 0);
+#   else
+    size_t strings = m_rpcId.size() + result.jobId.size();
+#   endif
+
+    if (has<EXT_ALGO>() && result.algorithm.isValid()) {
+        strings += strlen(result.algorithm.name());
+    }
+
+    // The submit line is formatted straight into the send buffer, no document or intermediate string buffer is built.
+    const size_t maxSize = strings * 6 + 512;
+    if (maxSize > kMaxSendBufferSize) {
+        return writeSubmitJson(result, buf, offset);
+    }
+
+    if (offset + maxSize > buf.size()) {
+        buf.resize(offset + maxSize);
+    }
+
+    char *out = buf.data() + offset;
+
+    out = writeRaw(out, "{\"id\":");
+    out = writeInt(out, m_sequence);
+    out = writeRaw(out, ",\"jsonrpc\":\"2.0\",\"method\":\"submit\",\"params\":{\"id\":");
+    out = writeString(out, m_rpcId.data());
+    out = writeRaw(out, ",\"job_id\":");
+    out = writeString(out, result.jobId.data());
+
+#   ifdef XMRIG_PROXY_PROJECT
+    out = writeRaw(out, ",\"nonce\":");
+    out = writeString(out, result.nonce);
+    out = writeRaw(out, ",\"result\":");
+    out = writeString(out, result.result);
+
+    if (result.sig) {
+        out = writeRaw(out, ",\"sig\":");
+        out = writeString(out, result.sig);
+    }
+#   else
+    out = writeRaw(out, ",\"nonce\":\"");
+    Cvt::toHex(out, sizeof(uint32_t) * 2 + 1, reinterpret_cast<const uint8_t *>(&result.nonce), sizeof(uint32_t));
+    out += sizeof(uint32_t) * 2;
+
+    out = writeRaw(out, "\",\"result\":\"");
+    Cvt::toHex(out, 65, result.result(), 32);
+    out += 64;
+    *out++ = '"';
+
+    if (result.minerSignature()) {
+        out = writeRaw(out, ",\"sig\":\"");
+        Cvt::toHex(out, 129, result.minerSignature(), 64);
+        out += 128;
+        *out++ = '"';
+    }
+#   endif
+
+    if (has<EXT_ALGO>() && result.algorithm.isValid()) {
+        out = writeRaw(out, ",\"algo\":");
+        out = writeString(out, result.algorithm.name());
+    }
+
+    out  = writeRaw(out, "}}\n");
+    *out = '\0';
+
+    const auto size = static_cast<size_t>(out - buf.data()) - offset;
+    assert(size < maxSize);
+
+    return size;
+}
+
+
+// Generic path for ids too long for the worst case estimate of writeSubmit(), the real size is checked instead.
+size_t xmrig::Client::writeSubmitJson(const JobResult &result, std::vector<char> &buf, size_t offset)
+{
+    using namespace rapidjson;
+
+#   ifdef XMRIG_PROXY_PROJECT
+    const char *nonce = result.nonce;
+    const char *data  = result.result;
+#   else
+    char nonce[9];
+    char data[65];
+    char signature[129];
+
+    Cvt::toHex(nonce, sizeof(nonce), reinterpret_cast<const uint8_t *>(&result.nonce), sizeof(uint32_t));
+    Cvt::toHex(data, sizeof(data), result.result(), 32);
+
+    if (result.minerSignature()) {
+        Cvt::toHex(signature, sizeof(signature), result.minerSignature(), 64);
+    }
+#   endif
+
+    Document doc(kObjectType);
+    auto &allocator = doc.GetAllocator();
+
+    Value params(kObjectType);
+    params.AddMember("id",     StringRef(m_rpcId.data()), allocator);
+    params.AddMember("job_id", StringRef(result.jobId.data()), allocator);
+    params.AddMember("nonce",  StringRef(nonce), allocator);
+    params.AddMember("result", StringRef(data), allocator);
+
+#   ifndef XMRIG_PROXY_PROJECT
+    if (result.minerSignature()) {
+        params.AddMember("sig", StringRef(signature), allocator);
+    }
+#   else
+    if (result.sig) {
+        params.AddMember("sig", StringRef(result.sig), allocator);
+    }
+#   endif
+
+    if (has<EXT_ALGO>() && result.algorithm.isValid()) {
+        params.AddMember("algo", StringRef(result.algorithm.name()), allocator);
+    }
+
+    JsonRequest::create(doc, m_sequence, "submit", params);
+
+    StringBuffer buffer(nullptr, 512);
+    Writer<StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    const size_t size = buffer.GetSize();
+    if (size + 2 > kMaxSendBufferSize) {
+        return 0;
+    }
+
+    if (offset + size + 2 > buf.size()) {
+        buf.resize(offset + size + 2);
+    }
+
+    memcpy(buf.data() + offset, buffer.GetString(), size);
+    buf[offset + size]     = '\n';
+    buf[offset + size + 1] = '\0';
+
+    return size + 1;
+}
+
+
 bool xmrig::Client::parseJob(const rapidjson::Value &params, int *code)
 {
     if (!params.IsObject()) {
@@ -417,6 +614,8 @@ bool xmrig::Client::parseJob(const rapidjson::Value &params, int *code)
         return false;
     }
 
+    job.setNextSeedHash(Json::getString(params, "next_seed_hash"));
+
     job.setSigKey(Json::getString(params, "sig_key"));
 
     m_job.setClientId(m_rpcId);
@@ -528,10 +727,34 @@ int xmrig::Client::resolve(const String &host)
 }
 
 
+int64_t xmrig::Client::enqueue(size_t offset, size_t size)
+{
+    LOG_DEBUG("[%s] enqueue (%d bytes): \"%.*s\"", url(), size, static_cast<int>(size) - 1, m_batch.data() + offset);
+
+    if (state() != ConnectedState) {
+        LOG_DEBUG_ERR("[%s] send failed, invalid state: %d", url(), m_state);
+        m_batch.resize(offset);
+
+        return -1;
+    }
+
+    // Shares submitted during the same event loop pass go out with a single write (and a single TLS record).
+    if (offset == 0) {
+        m_flushAsync->send();
+    }
+
+    m_expire = Chrono::steadyMSecs() + kResponseTimeout;
+    return m_sequence++;
+}
+
+
 int64_t xmrig::Client::send(size_t size)
 {
     LOG_DEBUG("[%s] send (%d bytes): \"%.*s\"", url(), size, static_cast<int>(size) - 1, m_sendBuf.data());
 
+    // Keep requests on the wire in sequence order.
+    flush();
+
 #   ifdef XMRIG_FEATURE_TLS
     if (isTLS()) {
         if (!m_tls->send(m_sendBuf.data(), size)) {
@@ -558,6 +781,33 @@ int64_t xmrig::Client::send(size_t size)
 }
 
 
+void xmrig::Client::flush()
+{
+    if (m_batch.empty()) {
+        return;
+    }
+
+    bool ok = false;
+
+#   ifdef XMRIG_FEATURE_TLS
+    if (isTLS()) {
+        ok = m_tls->send(m_batch.data(), m_batch.size());
+    }
+    else
+#   endif
+    if (state() == ConnectedState && uv_is_writable(stream())) {
+        ok = write(uv_buf_init(m_batch.data(), static_cast<unsigned int>(m_batch.size())));
+    }
+
+    m_batch.clear();
+
+    // Batched results never reached the pool, reconnect so they are reported as failed now instead of after the response timeout.
+    if (!ok) {
+        close();
+    }
+}
+
+
 void xmrig::Client::connect(const sockaddr *addr)
 {
     setState(ConnectingState);
@@ -673,7 +923,10 @@ void xmrig::Client::parse(char *line, size_t len)
         return;
     }
 
-    rapidjson::Document doc;
+    // Everything allocated for the previous message is released at once, extra chunks beyond the parse buffer are freed here.
+    m_parseAllocator->Clear();
+
+    ParseDocument doc(m_parseAllocator, 1024, m_parseAllocator);
     if (doc.ParseInsitu(line).HasParseError()) {
         if (!isQuiet()) {
             LOG_ERR("%s " RED("JSON decode failed: ") RED_BOLD("\"%s\""), tag(), rapidjson::GetParseError_En(doc.GetParseError()));
@@ -44,6 +44,7 @@ using BIO = struct bio_st;
 namespace xmrig {
 
 
+class Async;
 class DnsRequest;
 class IClientListener;
 class JobResult;
@@ -57,6 +58,7 @@ public:
     constexpr static uint64_t kConnectTimeout   = 20 * 1000;
     constexpr static uint64_t kResponseTimeout  = 20 * 1000;
     constexpr static size_t kMaxSendBufferSize  = 1024 * 16;
+    constexpr static size_t kParseBufferSize    = 1024 * 16;
 
     Client(int id, const char *agent, IClientListener *listener);
     ~Client() override;
@@ -91,6 +93,8 @@ protected:
     virtual void parseNotification(const char* method, const rapidjson::Value& params, const rapidjson::Value& error);
 
     bool close();
+    size_t writeSubmit(const JobResult &result, std::vector<char> &buf, size_t offset);
+    size_t writeSubmitJson(const JobResult &result, std::vector<char> &buf, size_t offset);
     virtual void onClose();
 
 private:
@@ -102,8 +106,10 @@ private:
     bool verifyAlgorithm(const Algorithm &algorithm, const char *algo) const;
     bool write(const uv_buf_t &buf);
     int resolve(const String &host);
+    int64_t enqueue(size_t offset, size_t size);
     int64_t send(size_t size);
     void connect(const sockaddr *addr);
+    void flush();
     void handshake();
     void parse(char *line, size_t len);
     void parseExtensions(const rapidjson::Value &result);
@@ -128,11 +134,14 @@ private:
 
     const char *m_agent;
     LineReader m_reader;
+    rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator> *m_parseAllocator = nullptr;
     Socks5 *m_socks5            = nullptr;
     std::bitset<EXT_MAX> m_extensions;
+    std::shared_ptr<Async> m_flushAsync;
     std::shared_ptr<DnsRequest> m_dns;
+    std::vector<char> m_batch;
+    std::vector<char> m_parseBuf;
     std::vector<char> m_sendBuf;
-    std::vector<char> m_tempBuf;
     String m_rpcId;
     Tls *m_tls                  = nullptr;
     uint64_t m_expire           = 0;
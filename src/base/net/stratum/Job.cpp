@@ -30,6 +30,7 @@
 #include "base/net/stratum/Job.h"
 #include "base/tools/Alignment.h"
 #include "base/tools/Buffer.h"
+#include "base/tools/Chrono.h"
 #include "base/tools/Cvt.h"
 #include "base/tools/cryptonote/BlockTemplate.h"
 #include "base/tools/cryptonote/Signatures.h"
@@ -39,6 +40,7 @@
 xmrig::Job::Job(bool nicehash, const Algorithm &algorithm, const String &clientId) :
     m_algorithm(algorithm),
     m_nicehash(nicehash),
+    m_timestamp(Chrono::highResolutionMSecs()),
     m_clientId(clientId)
 {
 }
@@ -92,6 +94,20 @@ bool xmrig::Job::setBlob(const char *blob)
 }
 
 
+bool xmrig::Job::setNextSeedHash(const char *hash)
+{
+    if (!hash || (strlen(hash) != kMaxSeedSize * 2)) {
+        m_nextSeed.clear();
+
+        return false;
+    }
+
+    m_nextSeed = Cvt::fromHex(hash, kMaxSeedSize * 2);
+
+    return !m_nextSeed.empty();
+}
+
+
 bool xmrig::Job::setSeedHash(const char *hash)
 {
     if (!hash || (strlen(hash) != kMaxSeedSize * 2)) {
@@ -115,20 +131,17 @@ bool xmrig::Job::setTarget(const char *target)
             return strtoull(target, nullptr, 16);
         }
 
-        const auto raw = Cvt::fromHex(target, size);
+        alignas(8) uint8_t raw[8] = {};
 
-        switch (raw.size()) {
-        case 4:
-            return 0xFFFFFFFFFFFFFFFFULL / (0xFFFFFFFFULL / uint64_t(*reinterpret_cast<const uint32_t *>(raw.data())));
-
-        case 8:
-            return *reinterpret_cast<const uint64_t *>(raw.data());
+        if ((size != 8 && size != 16) || !Cvt::fromHex(raw, sizeof(raw), target, size)) {
+            return 0;
+        }
 
-        default:
-            break;
+        if (size == 8) {
+            return 0xFFFFFFFFFFFFFFFFULL / (0xFFFFFFFFULL / uint64_t(*reinterpret_cast<const uint32_t *>(raw)));
         }
 
-        return 0;
+        return *reinterpret_cast<const uint64_t *>(raw);
     };
 
     const size_t size = target ? strlen(target) : 0;
@@ -232,6 +245,7 @@ void xmrig::Job::copy(const Job &other)
 {
     m_algorithm  = other.m_algorithm;
     m_nicehash   = other.m_nicehash;
+    m_timestamp  = other.m_timestamp;
     m_size       = other.m_size;
     m_clientId   = other.m_clientId;
     m_id         = other.m_id;
@@ -241,6 +255,7 @@ void xmrig::Job::copy(const Job &other)
     m_target     = other.m_target;
     m_index      = other.m_index;
     m_seed       = other.m_seed;
+    m_nextSeed   = other.m_nextSeed;
     m_extraNonce = other.m_extraNonce;
     m_poolWallet = other.m_poolWallet;
 
@@ -283,6 +298,7 @@ void xmrig::Job::move(Job &&other)
 {
     m_algorithm  = other.m_algorithm;
     m_nicehash   = other.m_nicehash;
+    m_timestamp  = other.m_timestamp;
     m_size       = other.m_size;
     m_clientId   = std::move(other.m_clientId);
     m_id         = std::move(other.m_id);
@@ -292,6 +308,7 @@ void xmrig::Job::move(Job &&other)
     m_target     = other.m_target;
     m_index      = other.m_index;
     m_seed       = std::move(other.m_seed);
+    m_nextSeed   = std::move(other.m_nextSeed);
     m_extraNonce = std::move(other.m_extraNonce);
     m_poolWallet = std::move(other.m_poolWallet);
 
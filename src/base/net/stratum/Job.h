@@ -59,6 +59,7 @@ public:
     bool isEqual(const Job &other) const;
     bool isEqualBlob(const Job &other) const;
     bool setBlob(const char *blob);
+    bool setNextSeedHash(const char *hash);
     bool setSeedHash(const char *hash);
     bool setTarget(const char *target);
     size_t nonceOffset() const;
@@ -67,8 +68,10 @@ public:
 
     inline bool isNicehash() const                      { return m_nicehash; }
     inline bool isValid() const                         { return (m_size > 0 && m_diff > 0) || !m_poolWallet.isEmpty(); }
+    inline double timestamp() const                     { return m_timestamp; }
     inline bool setId(const char *id)                   { return (m_id = id); }
     inline const Algorithm &algorithm() const           { return m_algorithm; }
+    inline const Buffer &nextSeed() const               { return m_nextSeed; }
     inline const Buffer &seed() const                   { return m_seed; }
     inline const String &clientId() const               { return m_clientId; }
     inline const String &extraNonce() const             { return m_extraNonce; }
@@ -149,7 +152,9 @@ private:
 
     Algorithm m_algorithm;
     bool m_nicehash     = false;
+    Buffer m_nextSeed;
     Buffer m_seed;
+    double m_timestamp  = 0;
     size_t m_size       = 0;
     String m_clientId;
     String m_extraNonce;
@@ -27,7 +27,14 @@
 #include "base/tools/Chrono.h"
 
 
+#ifdef XMRIG_FEATURE_API
+#   include "base/api/Metrics.h"
+#endif
+
+
 #include <algorithm>
+#include <cctype>
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
 #include <uv.h>
@@ -37,6 +44,24 @@
 namespace xmrig {
 
 
+// Pools have no common error code for a share that arrived after the job was replaced, so match the usual wording.
+static bool isStale(const char *error)
+{
+    static const char *patterns[] = { "stale", "expired", "job not found", "outdated" };
+
+    std::string str(error);
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+    for (const char *pattern : patterns) {
+        if (str.find(pattern) != std::string::npos) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 inline static void printCount(uint64_t accepted, uint64_t rejected)
 {
     float percent   = 100.0;
@@ -114,7 +139,7 @@ xmrig::NetworkState::NetworkState(IStrategyListener *listener) : StrategyProxy(l
 
 
 #ifdef XMRIG_FEATURE_API
-rapidjson::Value xmrig::NetworkState::getConnection(rapidjson::Document &doc, int version) const
+rapidjson::Value xmrig::NetworkState::getConnection(rapidjson::Document &doc, int version, const IStrategy *strategy) const
 {
     using namespace rapidjson;
     auto &allocator = doc.GetAllocator();
@@ -137,6 +162,24 @@ rapidjson::Value xmrig::NetworkState::getConnection(rapidjson::Document &doc, in
     connection.AddMember("avg_time_ms",     avgTime(), allocator);
     connection.AddMember("hashes_total",    m_hashes, allocator);
 
+    const IClient *current = strategy->isActive() ? strategy->client() : nullptr;
+    const double now       = Chrono::highResolutionMSecs();
+    Value pools(kArrayType);
+
+    strategy->forEachClient([&](const IClient *client, bool online) {
+        const Job &job = client->job();
+
+        Value pool(kObjectType);
+        pool.AddMember("url",        Value(client->pool().url().data(), allocator), allocator);
+        pool.AddMember("state",      StringRef(client == current ? "active" : (online ? "standby" : "offline")), allocator);
+        pool.AddMember("height",     online ? job.height() : 0, allocator);
+        pool.AddMember("job_age_ms", online && job.isValid() ? Value(static_cast<uint64_t>(now - job.timestamp())) : Value(kNullType), allocator);
+
+        pools.PushBack(pool, allocator);
+    });
+
+    connection.AddMember("pools",           pools, allocator);
+
     if (version == 1) {
         connection.AddMember("error_log", Value(kArrayType), allocator);
     }
@@ -174,6 +217,52 @@ rapidjson::Value xmrig::NetworkState::getResults(rapidjson::Document &doc, int v
 
     return results;
 }
+
+
+void xmrig::NetworkState::toMetrics(Metrics &metrics, const IStrategy *strategy) const
+{
+    metrics.set("xmrig_pool_connected", Metrics::GAUGE, "Whether there is an active pool connection.");
+    metrics.add(static_cast<uint64_t>(m_active));
+
+    metrics.set("xmrig_pool_failures_total", Metrics::COUNTER, "Pool connections lost or failed.");
+    metrics.add(m_failures);
+
+    metrics.set("xmrig_pool_difficulty", Metrics::GAUGE, "Difficulty of the current job.");
+    metrics.add(m_diff);
+
+    metrics.set("xmrig_shares_accepted_total", Metrics::COUNTER, "Shares accepted by the pool.");
+    metrics.add(m_accepted);
+
+    metrics.set("xmrig_shares_rejected_total", Metrics::COUNTER, "Shares rejected by the pool, including stale shares.");
+    metrics.add(m_rejected);
+
+    metrics.set("xmrig_shares_stale_total", Metrics::COUNTER, "Shares rejected by the pool because the job was outdated.");
+    metrics.add(m_stale);
+
+    metrics.set("xmrig_hashes_total", Metrics::COUNTER, "Sum of the difficulty of accepted shares.");
+    metrics.add(m_hashes);
+
+    metrics.set("xmrig_share_latency_seconds", Metrics::SUMMARY, "Time from share submission to the pool response.");
+    metrics.add(m_latencySum / 1000.0, nullptr, "_sum");
+    metrics.add(m_accepted, nullptr, "_count");
+
+    const double now = Chrono::highResolutionMSecs();
+    char labels[300];
+
+    metrics.set("xmrig_pool_up", Metrics::GAUGE, "Whether the pool connection is logged in, including standby pools.");
+    strategy->forEachClient([&](const IClient *client, bool online) {
+        snprintf(labels, sizeof(labels), "pool=\"%s\"", client->pool().url().data());
+        metrics.add(static_cast<uint64_t>(online), labels);
+    });
+
+    metrics.set("xmrig_pool_job_age_seconds", Metrics::GAUGE, "Time since the last job received from the pool.");
+    strategy->forEachClient([&](const IClient *client, bool online) {
+        if (online && client->job().isValid()) {
+            snprintf(labels, sizeof(labels), "pool=\"%s\"", client->pool().url().data());
+            metrics.add((now - client->job().timestamp()) / 1000.0, labels);
+        }
+    });
+}
 #endif
 
 
@@ -330,6 +419,11 @@ void xmrig::NetworkState::add(const SubmitResult &result, const char *error)
 {
     if (error) {
         m_rejected++;
+
+        if (isStale(error)) {
+            m_stale++;
+        }
+
         return;
     }
 
@@ -342,6 +436,7 @@ void xmrig::NetworkState::add(const SubmitResult &result, const char *error)
         std::sort(m_topDiff.rbegin(), m_topDiff.rend());
     }
 
+    m_latencySum += result.elapsed;
     m_latency.push_back(result.elapsed > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(result.elapsed));
 }
 
@@ -33,6 +33,9 @@
 namespace xmrig {
 
 
+class Metrics;
+
+
 class NetworkState : public StrategyProxy
 {
 public:
@@ -43,8 +46,9 @@ public:
     inline uint64_t rejected() const            { return m_rejected; }
 
 #   ifdef XMRIG_FEATURE_API
-    rapidjson::Value getConnection(rapidjson::Document &doc, int version) const;
+    rapidjson::Value getConnection(rapidjson::Document &doc, int version, const IStrategy *strategy) const;
     rapidjson::Value getResults(rapidjson::Document &doc, int version) const;
+    void toMetrics(Metrics &metrics, const IStrategy *strategy) const;
 #   endif
 
     void printConnection() const;
@@ -79,7 +83,9 @@ private:
     uint64_t m_diff             = 0;
     uint64_t m_failures         = 0;
     uint64_t m_hashes           = 0;
+    uint64_t m_latencySum       = 0;
     uint64_t m_rejected         = 0;
+    uint64_t m_stale            = 0;
 };
 
 
@@ -45,6 +45,9 @@ const char *Pools::kDonateOverProxy = "donate-over-proxy";
 const char *Pools::kPools           = "pools";
 const char *Pools::kRetries         = "retries";
 const char *Pools::kRetryPause      = "retry-pause";
+const char *Pools::kStallTimeout    = "stall-timeout";
+const char *Pools::kStandby         = "standby-pools";
+const char *Pools::kSubmitDelay     = "submit-delay";
 
 
 } // namespace xmrig
@@ -62,7 +65,8 @@ xmrig::Pools::Pools() :
 
 bool xmrig::Pools::isEqual(const Pools &other) const
 {
-    if (m_data.size() != other.m_data.size() || m_retries != other.m_retries || m_retryPause != other.m_retryPause) {
+    if (m_data.size() != other.m_data.size() || m_retries != other.m_retries || m_retryPause != other.m_retryPause ||
+        m_standby != other.m_standby || m_stallTimeout != other.m_stallTimeout) {
         return false;
     }
 
@@ -97,6 +101,8 @@ xmrig::IStrategy *xmrig::Pools::createStrategy(IStrategyListener *listener) cons
         }
     }
 
+    strategy->setStandby(standby(), stallTimeout());
+
     return strategy;
 }
 
@@ -162,6 +168,9 @@ void xmrig::Pools::load(const IJsonReader &reader)
     setProxyDonate(reader.getInt(kDonateOverProxy, PROXY_DONATE_AUTO));
     setRetries(reader.getInt(kRetries));
     setRetryPause(reader.getInt(kRetryPause));
+    setStandby(reader.getInt(kStandby));
+    setStallTimeout(reader.getInt(kStallTimeout));
+    setSubmitDelay(reader.getInt(kSubmitDelay));
 }
 
 
@@ -212,6 +221,9 @@ void xmrig::Pools::toJSON(rapidjson::Value &out, rapidjson::Document &doc) const
     out.AddMember(StringRef(kPools),            toJSON(doc), allocator);
     doc.AddMember(StringRef(kRetries),          retries(), allocator);
     doc.AddMember(StringRef(kRetryPause),       retryPause(), allocator);
+    doc.AddMember(StringRef(kStandby),          standby(), allocator);
+    doc.AddMember(StringRef(kStallTimeout),     stallTimeout(), allocator);
+    doc.AddMember(StringRef(kSubmitDelay),      submitDelay(), allocator);
 }
 
 
@@ -251,3 +263,27 @@ void xmrig::Pools::setRetryPause(int retryPause)
         m_retryPause = retryPause;
     }
 }
+
+
+void xmrig::Pools::setStallTimeout(int stallTimeout)
+{
+    if (stallTimeout >= 0 && stallTimeout <= 3600) {
+        m_stallTimeout = stallTimeout;
+    }
+}
+
+
+void xmrig::Pools::setStandby(int standby)
+{
+    if (standby >= 0 && standby <= 16) {
+        m_standby = standby;
+    }
+}
+
+
+void xmrig::Pools::setSubmitDelay(int submitDelay)
+{
+    if (submitDelay >= 0 && submitDelay <= 1000) {
+        m_submitDelay = submitDelay;
+    }
+}
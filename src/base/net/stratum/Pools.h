@@ -48,6 +48,9 @@ public:
     static const char *kPools;
     static const char *kRetries;
     static const char *kRetryPause;
+    static const char *kStallTimeout;
+    static const char *kStandby;
+    static const char *kSubmitDelay;
 
     enum ProxyDonate {
         PROXY_DONATE_NONE,
@@ -66,6 +69,9 @@ public:
     inline const std::vector<Pool> &data() const        { return m_data; }
     inline int retries() const                          { return m_retries; }
     inline int retryPause() const                       { return m_retryPause; }
+    inline int stallTimeout() const                     { return m_stallTimeout; }
+    inline int standby() const                          { return m_standby; }
+    inline int submitDelay() const                      { return m_submitDelay; }
     inline ProxyDonate proxyDonate() const              { return m_proxyDonate; }
 
     inline bool operator!=(const Pools &other) const    { return !isEqual(other); }
@@ -86,10 +92,16 @@ private:
     void setProxyDonate(int value);
     void setRetries(int retries);
     void setRetryPause(int retryPause);
+    void setStallTimeout(int stallTimeout);
+    void setStandby(int standby);
+    void setSubmitDelay(int submitDelay);
 
     int m_donateLevel;
     int m_retries               = 5;
     int m_retryPause            = 5;
+    int m_stallTimeout          = 0;
+    int m_standby               = 0;
+    int m_submitDelay           = 0;
     ProxyDonate m_proxyDonate   = PROXY_DONATE_AUTO;
     std::vector<Pool> m_data;
 
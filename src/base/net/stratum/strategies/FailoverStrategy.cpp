@@ -20,8 +20,15 @@
 #include "base/net/stratum/strategies/FailoverStrategy.h"
 #include "3rdparty/rapidjson/document.h"
 #include "base/kernel/interfaces/IClient.h"
+#include "base/io/log/Log.h"
+#include "base/io/log/Tags.h"
 #include "base/kernel/interfaces/IStrategyListener.h"
 #include "base/kernel/Platform.h"
+#include "base/net/stratum/Job.h"
+#include "base/tools/Chrono.h"
+
+
+#include <algorithm>
 
 
 xmrig::FailoverStrategy::FailoverStrategy(const std::vector<Pool> &pools, int retryPause, int retries, IStrategyListener *listener, bool quiet) :
@@ -62,6 +69,14 @@ void xmrig::FailoverStrategy::add(const Pool &pool)
     client->setQuiet(m_quiet);
 
     m_pools.push_back(client);
+    m_online.push_back(false);
+}
+
+
+void xmrig::FailoverStrategy::setStandby(int standby, int stallTimeout)
+{
+    m_standby      = standby > 0 ? static_cast<size_t>(standby) : 0;
+    m_stallTimeout = stallTimeout > 0 ? static_cast<uint64_t>(stallTimeout) * 1000 : 0;
 }
 
 
@@ -77,10 +92,28 @@ int64_t xmrig::FailoverStrategy::submit(const JobResult &result)
 
 void xmrig::FailoverStrategy::connect()
 {
+    if (m_standby) {
+        m_index = std::min(m_standby, m_pools.size() - 1);
+
+        for (size_t i = 0; i <= m_index; ++i) {
+            m_pools[i]->connect();
+        }
+
+        return;
+    }
+
     m_pools[m_index]->connect();
 }
 
 
+void xmrig::FailoverStrategy::forEachClient(const ClientVisitor &visitor) const
+{
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        visitor(m_pools[i], m_online[i]);
+    }
+}
+
+
 void xmrig::FailoverStrategy::resume()
 {
     if (!isActive()) {
@@ -116,6 +149,8 @@ void xmrig::FailoverStrategy::stop()
     m_index  = 0;
     m_active = -1;
 
+    std::fill(m_online.begin(), m_online.end(), false);
+
     m_listener->onPause(this);
 }
 
@@ -125,18 +160,57 @@ void xmrig::FailoverStrategy::tick(uint64_t now)
     for (IClient *client : m_pools) {
         client->tick(now);
     }
+
+    if (!m_stallTimeout || !isActive() || !active()->job().isValid()) {
+        return;
+    }
+
+    const double age = Chrono::highResolutionMSecs() - active()->job().timestamp();
+    if (age < m_stallTimeout) {
+        return;
+    }
+
+    IClient *client = standby(m_stallTimeout);
+    if (!client) {
+        return;
+    }
+
+    if (!m_quiet) {
+        LOG_WARN("%s " YELLOW_BOLD("no new job from ") WHITE_BOLD("%s:%d") YELLOW_BOLD(" for %.0f s, switching to standby pool"),
+                 Tags::network(), active()->pool().host().data(), active()->pool().port(), age / 1000);
+    }
+
+    setActive(client, true);
 }
 
 
 void xmrig::FailoverStrategy::onClose(IClient *client, int failures)
 {
+    m_online[static_cast<size_t>(client->id())] = false;
+
     if (failures == -1) {
         return;
     }
 
     if (m_active == client->id()) {
         m_active = -1;
-        m_listener->onPause(this);
+
+        // A standby pool is already logged in and has a job, so mining continues without waiting for any reconnect.
+        IClient *next = m_standby ? standby(0) : nullptr;
+        if (next) {
+            setActive(next, true);
+        }
+        else {
+            m_listener->onPause(this);
+        }
+    }
+
+    if (m_standby) {
+        if (failures == m_retries && (m_pools.size() - m_index) > 1) {
+            m_pools[++m_index]->connect();
+        }
+
+        return;
     }
 
     if (m_index == 0 && failures < m_retries) {
@@ -157,6 +231,11 @@ void xmrig::FailoverStrategy::onLogin(IClient *client, rapidjson::Document &doc,
 
 void xmrig::FailoverStrategy::onJobReceived(IClient *client, const Job &job, const rapidjson::Value &params)
 {
+    // A higher priority pool that was bypassed because of a stalled job is alive again.
+    if (m_standby && client->id() < m_active && m_online[static_cast<size_t>(client->id())]) {
+        setActive(client, false);
+    }
+
     if (m_active == client->id()) {
         m_listener->onJob(this, client, job, params);
     }
@@ -165,6 +244,18 @@ void xmrig::FailoverStrategy::onJobReceived(IClient *client, const Job &job, con
 
 void xmrig::FailoverStrategy::onLoginSuccess(IClient *client)
 {
+    m_online[static_cast<size_t>(client->id())] = true;
+
+    if (m_standby) {
+        if (!isActive() || client->id() < m_active) {
+            setActive(client, false);
+        }
+
+        trim();
+
+        return;
+    }
+
     int active = m_active;
 
     if (client->id() == 0 || !isActive()) {
@@ -194,3 +285,49 @@ void xmrig::FailoverStrategy::onVerifyAlgorithm(const IClient *client, const Alg
 {
     m_listener->onVerifyAlgorithm(this, client, algorithm, ok);
 }
+
+
+xmrig::IClient *xmrig::FailoverStrategy::standby(uint64_t maxAge) const
+{
+    const double now = Chrono::highResolutionMSecs();
+
+    for (size_t i = 0; i < m_pools.size(); ++i) {
+        IClient *client = m_pools[i];
+
+        if (!m_online[i] || m_active == client->id() || !client->job().isValid()) {
+            continue;
+        }
+
+        if (maxAge && now - client->job().timestamp() >= maxAge) {
+            continue;
+        }
+
+        return client;
+    }
+
+    return nullptr;
+}
+
+
+void xmrig::FailoverStrategy::setActive(IClient *client, bool resume)
+{
+    m_active = client->id();
+    m_listener->onActive(this, client);
+
+    if (resume) {
+        m_listener->onJob(this, client, client->job(), rapidjson::Value(rapidjson::kNullType));
+    }
+}
+
+
+void xmrig::FailoverStrategy::trim()
+{
+    // Backup pools connected after failures are dropped again once enough higher priority pools are back online.
+    const size_t base = std::min(m_standby, m_pools.size() - 1);
+
+    while (m_index > base && m_active != static_cast<int>(m_index) &&
+           static_cast<size_t>(std::count(m_online.begin(), m_online.begin() + static_cast<std::ptrdiff_t>(m_index), true)) > m_standby) {
+        m_online[m_index] = false;
+        m_pools[m_index--]->disconnect();
+    }
+}
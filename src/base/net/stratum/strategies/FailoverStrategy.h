@@ -46,6 +46,7 @@ public:
     ~FailoverStrategy() override;
 
     void add(const Pool &pool);
+    void setStandby(int standby, int stallTimeout);
 
 protected:
     inline bool isActive() const override           { return m_active >= 0; }
@@ -53,6 +54,7 @@ protected:
 
     int64_t submit(const JobResult &result) override;
     void connect() override;
+    void forEachClient(const ClientVisitor &visitor) const override;
     void resume() override;
     void setAlgo(const Algorithm &algo) override;
     void setProxy(const ProxyUrl &proxy) override;
@@ -69,13 +71,20 @@ protected:
 private:
     inline IClient *active() const { return m_pools[static_cast<size_t>(m_active)]; }
 
+    IClient *standby(uint64_t maxAge) const;
+    void setActive(IClient *client, bool resume);
+    void trim();
+
     const bool m_quiet;
     const int m_retries;
     const int m_retryPause;
     int m_active            = -1;
     IStrategyListener *m_listener;
     size_t m_index          = 0;
+    size_t m_standby        = 0;
+    std::vector<bool> m_online;
     std::vector<IClient*> m_pools;
+    uint64_t m_stallTimeout = 0;
 };
 
 
@@ -50,6 +50,7 @@ public:
 protected:
     inline bool isActive() const override           { return m_active; }
     inline IClient *client() const override         { return m_client; }
+    inline void forEachClient(const ClientVisitor &visitor) const override { visitor(m_client, m_active); }
 
     int64_t submit(const JobResult &result) override;
     void connect() override;
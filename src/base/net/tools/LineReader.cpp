@@ -23,13 +23,14 @@
 #include "base/kernel/interfaces/ILineListener.h"
 #include "base/net/tools/NetBuffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 
 
 xmrig::LineReader::~LineReader()
 {
-    NetBuffer::release(m_buf);
+    release();
 }
 
 
@@ -47,23 +48,46 @@ void xmrig::LineReader::parse(char *data, size_t size)
 void xmrig::LineReader::reset()
 {
     if (m_buf) {
-        NetBuffer::release(m_buf);
-        m_buf = nullptr;
-        m_pos = 0;
+        release();
+        m_buf       = nullptr;
+        m_capacity  = 0;
+        m_pos       = 0;
     }
+
+    m_overflow = false;
 }
 
 
 void xmrig::LineReader::add(const char *data, size_t size)
 {
-    if (size + m_pos > XMRIG_NET_BUFFER_CHUNK_SIZE) {
-        // it breaks correctness silently for long lines
+    if (m_overflow) {
+        return;
+    }
+
+    if (size + m_pos > XMRIG_NET_MAX_LINE_SIZE) {
+        // The rest of this line is skipped and the line is dropped when it ends, a truncated line is never delivered.
+        m_overflow = true;
+        m_pos      = 0;
+
         return;
     }
 
     if (!m_buf) {
-        m_buf = NetBuffer::allocate();
-        m_pos = 0;
+        m_buf       = NetBuffer::allocate();
+        m_capacity  = XMRIG_NET_BUFFER_CHUNK_SIZE;
+        m_pos       = 0;
+    }
+
+    if (size + m_pos > m_capacity) {
+        // Lines longer than a network buffer chunk (huge job blobs, long error messages) move to a larger heap buffer.
+        const size_t capacity = std::min(std::max(m_capacity * 2, size + m_pos), XMRIG_NET_MAX_LINE_SIZE);
+        auto buf              = new char[capacity];
+
+        memcpy(buf, m_buf, m_pos);
+        release();
+
+        m_buf      = buf;
+        m_capacity = capacity;
     }
 
     memcpy(m_buf + m_pos, data, size);
@@ -83,10 +107,22 @@ void xmrig::LineReader::getline(char *data, size_t size)
         end++;
 
         const auto len = static_cast<size_t>(end - start);
-        if (m_pos) {
+        if (m_pos || m_overflow) {
             add(start, len);
-            m_listener->onLine(m_buf, m_pos - 1);
-            m_pos = 0;
+
+            if (!m_overflow) {
+                m_listener->onLine(m_buf, m_pos - 1);
+            }
+
+            m_overflow = false;
+            m_pos      = 0;
+
+            // A long line doesn't keep its heap buffer for the life of the connection, the next partial line takes a pooled chunk again.
+            if (m_capacity > XMRIG_NET_BUFFER_CHUNK_SIZE) {
+                release();
+                m_buf      = nullptr;
+                m_capacity = 0;
+            }
         }
         else if (len > 1) {
             m_listener->onLine(start, len - 1);
@@ -102,3 +138,14 @@ void xmrig::LineReader::getline(char *data, size_t size)
 
     add(start, remaining);
 }
+
+
+void xmrig::LineReader::release()
+{
+    if (m_capacity == XMRIG_NET_BUFFER_CHUNK_SIZE) {
+        NetBuffer::release(m_buf);
+    }
+    else {
+        delete [] m_buf;
+    }
+}
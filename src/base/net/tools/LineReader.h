@@ -50,9 +50,12 @@ public:
 private:
     void add(const char *data, size_t size);
     void getline(char *data, size_t size);
+    void release();
 
+    bool m_overflow             = false;
     char *m_buf                 = nullptr;
     ILineListener *m_listener   = nullptr;
+    size_t m_capacity           = 0;
     size_t m_pos                = 0;
 };
 
@@ -0,0 +1,99 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_MPSCQUEUE_H
+#define XMRIG_MPSCQUEUE_H
+
+
+#include <atomic>
+#include <utility>
+
+
+#include "base/tools/Object.h"
+
+
+namespace xmrig {
+
+
+// Lock-free multiple producers, single consumer queue. Producers push individual items,
+// the consumer takes everything pushed so far at once and processes it in FIFO order.
+template<typename T>
+class MpscQueue
+{
+public:
+    XMRIG_DISABLE_COPY_MOVE(MpscQueue)
+
+    MpscQueue() = default;
+
+    inline ~MpscQueue()                 { consume([](T &&) {}); }
+    inline bool isEmpty() const         { return m_head.load(std::memory_order_relaxed) == nullptr; }
+
+
+    inline void push(T &&value)
+    {
+        auto node  = new Node(std::move(value));
+        node->next = m_head.load(std::memory_order_relaxed);
+
+        while (!m_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+
+    template<typename F>
+    inline size_t consume(F callback)
+    {
+        Node *node = m_head.exchange(nullptr, std::memory_order_acquire);
+        Node *prev = nullptr;
+
+        while (node) {
+            Node *next = node->next;
+            node->next = prev;
+            prev       = node;
+            node       = next;
+        }
+
+        size_t count = 0;
+
+        while (prev) {
+            Node *next = prev->next;
+            callback(std::move(prev->value));
+            delete prev;
+
+            prev = next;
+            ++count;
+        }
+
+        return count;
+    }
+
+private:
+    struct Node
+    {
+        inline explicit Node(T &&value) : value(std::move(value)) {}
+
+        T value;
+        Node *next = nullptr;
+    };
+
+    std::atomic<Node *> m_head{ nullptr };
+};
+
+
+} /* namespace xmrig */
+
+
+#endif /* XMRIG_MPSCQUEUE_H */
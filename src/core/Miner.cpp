@@ -25,6 +25,7 @@
 #include "core/Taskbar.h"
 #include "3rdparty/rapidjson/document.h"
 #include "backend/common/Hashrate.h"
+#include "backend/common/JobSwitch.h"
 #include "backend/cpu/Cpu.h"
 #include "backend/cpu/CpuBackend.h"
 #include "base/io/log/Log.h"
@@ -42,6 +43,7 @@
 #ifdef XMRIG_FEATURE_API
 #   include "base/api/Api.h"
 #   include "base/api/interfaces/IApiRequest.h"
+#   include "base/api/Metrics.h"
 #endif
 
 
@@ -132,6 +134,10 @@ public:
             backend->setJob(job);
         }
 
+        if (active && enabled) {
+            JobSwitch::dispatch(job);
+        }
+
         Nonce::touch();
 
         if (active && enabled) {
@@ -352,6 +358,10 @@ public:
                  avg_hashrate_buf
                  );
 
+        if (details) {
+            JobSwitch::print();
+        }
+
 #       ifdef XMRIG_FEATURE_BENCHMARK
         for (auto backend : backends) {
             backend->printBenchProgress();
@@ -361,7 +371,17 @@ public:
 
 
 #   ifdef XMRIG_ALGO_RANDOMX
-    inline bool initRX() const { return Rx::init(job, controller->config()->rx(), controller->config()->cpu()); }
+    inline bool initRX() const
+    {
+        const auto config = controller->config();
+        const bool ready  = Rx::init(job, config->rx(), config->cpu());
+
+        if (ready) {
+            Rx::prefetch(job, config->rx(), config->cpu());
+        }
+
+        return ready;
+    }
 #   endif
 
 
@@ -564,7 +584,7 @@ void xmrig::Miner::setJob(const Job &job, bool donate)
     }
 
 #   ifdef XMRIG_ALGO_RANDOMX
-    if (job.algorithm().family() == Algorithm::RANDOM_X && !Rx::isReady(job)) {
+    if (job.algorithm().family() == Algorithm::RANDOM_X && !Rx::isReady(job) && !Rx::isStandby(job)) {
         if (d_ptr->algorithm != job.algorithm()) {
             stop();
         }
@@ -709,6 +729,60 @@ void xmrig::Miner::onTimer(const Timer *)
 
 
 #ifdef XMRIG_FEATURE_API
+void xmrig::Miner::onMetrics(Metrics &metrics)
+{
+    static const std::pair<Hashrate::Intervals, const char *> intervals[] = {
+        { Hashrate::ShortInterval,  "10s" },
+        { Hashrate::MediumInterval, "60s" },
+        { Hashrate::LargeInterval,  "15m" }
+    };
+
+    metrics.set("xmrig_miner_enabled", Metrics::GAUGE, "Whether mining is enabled, 0 while paused.");
+    metrics.add(static_cast<uint64_t>(isEnabled()));
+
+    char labels[64];
+
+    for (IBackend *backend : d_ptr->backends) {
+        const Hashrate *hr = backend->hashrate();
+        if (!backend->isEnabled() || !hr) {
+            continue;
+        }
+
+        metrics.set("xmrig_hashrate", Metrics::GAUGE, "Backend hashrate over the interval, H/s.");
+
+        for (const auto &interval : intervals) {
+            const auto h = hr->calc(interval.first);
+            if (h.first) {
+                snprintf(labels, sizeof(labels), "backend=\"%s\",interval=\"%s\"", backend->type().data(), interval.second);
+                metrics.add(h.second, labels);
+            }
+        }
+
+        metrics.set("xmrig_thread_hashrate", Metrics::GAUGE, "Thread hashrate over the 10 second interval, H/s.");
+
+        for (size_t i = 0; i < hr->threads(); ++i) {
+            const auto h = hr->calc(i, Hashrate::ShortInterval);
+            if (h.first) {
+                snprintf(labels, sizeof(labels), "backend=\"%s\",thread=\"%zu\"", backend->type().data(), i);
+                metrics.add(h.second, labels);
+            }
+        }
+
+        backend->toMetrics(metrics);
+    }
+
+    JobSwitch::toMetrics(metrics);
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    const uint64_t initTime = Rx::initTime();
+    if (initTime) {
+        metrics.set("xmrig_randomx_dataset_init_seconds", Metrics::GAUGE, "Duration of the last RandomX dataset initialization.");
+        metrics.add(initTime / 1000.0);
+    }
+#   endif
+}
+
+
 void xmrig::Miner::onRequest(IApiRequest &request)
 {
     if (request.method() == IApiRequest::METHOD_GET) {
@@ -717,6 +791,8 @@ void xmrig::Miner::onRequest(IApiRequest &request)
 
             d_ptr->getMiner(request.reply(), request.doc(), request.version());
             d_ptr->getHashrate(request.reply(), request.doc(), request.version());
+
+            request.reply().AddMember("job_switch", JobSwitch::toJSON(request.doc()), request.doc().GetAllocator());
         }
         else if (request.url() == "/2/backends") {
             request.accept();
@@ -64,6 +64,7 @@ protected:
     void onTimer(const Timer *timer) override;
 
 #   ifdef XMRIG_FEATURE_API
+    void onMetrics(Metrics &metrics) override;
     void onRequest(IApiRequest &request) override;
 #   endif
 
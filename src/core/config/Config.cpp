@@ -314,6 +314,7 @@ void xmrig::Config::getJSON(rapidjson::Document &doc) const
 #   endif
 
     doc.AddMember(StringRef(kLogFile),                  m_logFile.toJSON(), allocator);
+    doc.AddMember(StringRef(kLogFileSize),              logFileSize(), allocator);
 
     m_pools.toJSON(doc, doc);
 
@@ -197,6 +197,15 @@ void xmrig::ConfigTransform::transform(rapidjson::Document &doc, int key, const
     case IConfig::RandomXCacheQoSKey: /* --cache-qos */
         return set(doc, RxConfig::kField, RxConfig::kCacheQoS, true);
 
+    case IConfig::RandomXDoubleBufferKey: /* --randomx-double-buffer */
+        return set(doc, RxConfig::kField, RxConfig::kDoubleBuffer, true);
+
+    case IConfig::RandomXDatasetCacheKey: /* --randomx-dataset-cache */
+        return set(doc, RxConfig::kField, RxConfig::kDatasetCache, arg);
+
+    case IConfig::RandomXMemoryBudgetKey: /* --randomx-memory-budget */
+        return set(doc, RxConfig::kField, RxConfig::kMemoryBudget, static_cast<uint64_t>(strtoull(arg, nullptr, 10)));
+
     case IConfig::HugePagesJitKey: /* --huge-pages-jit */
         return set(doc, CpuConfig::kField, CpuConfig::kHugePagesJit, true);
 #   endif
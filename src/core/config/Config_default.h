@@ -52,6 +52,9 @@ R"===(
         "rdmsr": true,
         "wrmsr": true,
         "cache_qos": false,
+        "double-buffer": false,
+        "dataset-cache": null,
+        "memory-budget": 0,
         "numa": true,
         "scratchpad_prefetch_mode": 1
     },
@@ -88,6 +91,7 @@ R"===(
     "donate-level": 1,
     "donate-over-proxy": 1,
     "log-file": null,
+    "log-file-size": 0,
     "pools": [
         {
             "algo": null,
@@ -112,6 +116,9 @@ R"===(
     "dmi": true,
     "retries": 5,
     "retry-pause": 5,
+    "standby-pools": 0,
+    "stall-timeout": 0,
+    "submit-delay": 0,
     "syslog": false,
     "tls": {
         "enabled": false,
@@ -62,6 +62,7 @@ static const option options[] = {
     { "dry-run",               0, nullptr, IConfig::DryRunKey             },
     { "keepalive",             0, nullptr, IConfig::KeepAliveKey          },
     { "log-file",              1, nullptr, IConfig::LogFileKey            },
+    { "log-file-size",         1, nullptr, IConfig::LogFileSizeKey        },
     { "nicehash",              0, nullptr, IConfig::NicehashKey           },
     { "no-color",              0, nullptr, IConfig::ColorKey              },
     { "no-huge-pages",         0, nullptr, IConfig::HugePagesKey          },
@@ -74,6 +75,9 @@ static const option options[] = {
     { "print-time",            1, nullptr, IConfig::PrintTimeKey          },
     { "retries",               1, nullptr, IConfig::RetriesKey            },
     { "retry-pause",           1, nullptr, IConfig::RetryPauseKey         },
+    { "standby-pools",         1, nullptr, IConfig::StandbyPoolsKey       },
+    { "stall-timeout",         1, nullptr, IConfig::StallTimeoutKey       },
+    { "submit-delay",          1, nullptr, IConfig::SubmitDelayKey        },
     { "syslog",                0, nullptr, IConfig::SyslogKey             },
     { "threads",               1, nullptr, IConfig::ThreadsKey            },
     { "url",                   1, nullptr, IConfig::UrlKey                },
@@ -138,6 +142,9 @@ static const option options[] = {
     { "no-rdmsr",              0, nullptr, IConfig::RandomXRdmsrKey       },
     { "randomx-cache-qos",     0, nullptr, IConfig::RandomXCacheQoSKey    },
     { "cache-qos",             0, nullptr, IConfig::RandomXCacheQoSKey    },
+    { "randomx-double-buffer", 0, nullptr, IConfig::RandomXDoubleBufferKey },
+    { "randomx-dataset-cache", 1, nullptr, IConfig::RandomXDatasetCacheKey },
+    { "randomx-memory-budget", 1, nullptr, IConfig::RandomXMemoryBudgetKey },
 #   endif
 #   ifdef XMRIG_FEATURE_OPENCL
     { "opencl",                0, nullptr, IConfig::OclKey                },
@@ -71,6 +71,9 @@ static inline const std::string &usage()
 
     u += "  -r, --retries=N               number of times to retry before switch to backup server (default: 5)\n";
     u += "  -R, --retry-pause=N           time to pause between retries (default: 5)\n";
+    u += "      --standby-pools=N         number of backup pools kept logged in for instant failover (default: 0)\n";
+    u += "      --stall-timeout=N         switch to a standby pool if no new job arrives for N seconds (default: 0, disabled)\n";
+    u += "      --submit-delay=N          collect shares found within N milliseconds and submit them together (default: 0)\n";
     u += "      --user-agent              set custom user-agent string for pool\n";
     u += "      --donate-level=N          donate level, default 1%% (1 minute in 100 minutes)\n";
     u += "      --donate-over-proxy=N     control donate over xmrig-proxy feature\n";
@@ -106,6 +109,9 @@ static inline const std::string &usage()
     u += "      --randomx-wrmsr=N         write custom value(s) to MSR registers or disable MSR mod (-1)\n";
     u += "      --randomx-no-rdmsr        disable reverting initial MSR values on exit\n";
     u += "      --randomx-cache-qos       enable Cache QoS\n";
+    u += "      --randomx-double-buffer   prepare dataset for the next seed in background (requires twice the memory)\n";
+    u += "      --randomx-dataset-cache=DIR  save initialized dataset to DIR and load it on next start\n";
+    u += "      --randomx-memory-budget=N  keep datasets of recently used seeds in up to N MB of memory\n";
 #   endif
 
 #   ifdef XMRIG_FEATURE_OPENCL
@@ -168,6 +174,7 @@ static inline const std::string &usage()
 #   endif
 
     u += "  -l, --log-file=FILE           log all output to a file\n";
+    u += "      --log-file-size=N         move the log file to FILE.1 once it grows over N MB (default: 0, never)\n";
     u += "      --print-time=N            print hashrate report every N seconds\n";
 #   if defined(XMRIG_FEATURE_NVML) || defined(XMRIG_FEATURE_ADL)
     u += "      --health-print-time=N     print health report every N seconds\n";
@@ -455,6 +455,47 @@ const static uint8_t test_output_gr[256] = {
 #endif
 
 
+#ifdef XMRIG_ALGO_KAWPOW
+// KawPow light mode (epoch 0), header hash and nonce are the same for all heights
+const static uint8_t kawpow_test_header[32] = {
+    0x01, 0x08, 0x0F, 0x16, 0x1D, 0x24, 0x2B, 0x32, 0x39, 0x40, 0x47, 0x4E, 0x55, 0x5C, 0x63, 0x6A,
+    0x71, 0x78, 0x7F, 0x86, 0x8D, 0x94, 0x9B, 0xA2, 0xA9, 0xB0, 0xB7, 0xBE, 0xC5, 0xCC, 0xD3, 0xDA
+};
+
+const static uint64_t kawpow_test_nonce = 0x123456789ABCDEF0ULL;
+
+struct kawpow_test_data
+{
+    uint32_t height;
+    uint8_t output[32];
+    uint8_t mix_hash[32];
+};
+
+const static kawpow_test_data kawpow_test_output[] = {
+    { 100,
+      {
+        0x4E, 0xEC, 0x24, 0x92, 0xEB, 0xD4, 0x83, 0x62, 0x20, 0x52, 0x93, 0x75, 0xC3, 0xB7, 0x02, 0x1D,
+        0xC5, 0xE4, 0x35, 0xDF, 0x6F, 0xA6, 0xBA, 0x05, 0x65, 0xB1, 0xCB, 0x40, 0xB8, 0x13, 0x90, 0xE7
+      },
+      {
+        0xD4, 0xC4, 0x27, 0x00, 0x4E, 0x21, 0xB3, 0x03, 0xC4, 0xF7, 0x24, 0x6B, 0x05, 0xA4, 0x9C, 0x36,
+        0x5A, 0x1F, 0xCB, 0x6F, 0xCE, 0x37, 0x79, 0x4B, 0xE1, 0x33, 0xEF, 0x3D, 0x3F, 0x18, 0x7C, 0x68
+      }
+    },
+    { 7499,
+      {
+        0x7F, 0x00, 0x7B, 0xB4, 0xD7, 0x76, 0xE4, 0xFD, 0x50, 0x03, 0x2C, 0x36, 0xB1, 0x5A, 0x1C, 0x3B,
+        0x33, 0xEA, 0xAF, 0x91, 0xC1, 0xA4, 0x30, 0x9C, 0xA6, 0x5D, 0xFF, 0x3A, 0x6D, 0x70, 0xB3, 0x68
+      },
+      {
+        0x23, 0xC3, 0x1B, 0xD6, 0x3A, 0xA0, 0x23, 0x09, 0xC3, 0xD0, 0xB8, 0x84, 0xC6, 0xD6, 0x82, 0xA5,
+        0x5D, 0x1D, 0x5A, 0xA9, 0x4F, 0x83, 0x34, 0x02, 0xAD, 0x93, 0x14, 0x60, 0xDC, 0x1C, 0x6A, 0x3A
+      }
+    }
+};
+#endif
+
+
 } // namespace xmrig
 
 
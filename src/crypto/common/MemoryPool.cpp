@@ -30,6 +30,7 @@
 
 
 #include <cassert>
+#include <iterator>
 
 
 namespace xmrig {
@@ -52,6 +53,9 @@ xmrig::MemoryPool::MemoryPool(size_t size, bool hugePages, uint32_t node)
     m_memory = new VirtualMemory(size * pageSize + alignment, hugePages, false, false, node);
 
     m_alignOffset = (alignment - (((size_t)m_memory->scratchpad()) % alignment)) % alignment;
+    m_size        = (m_memory->size() - m_alignOffset) / pageSize * pageSize;
+
+    insert(0, m_size);
 }
 
 
@@ -67,32 +71,104 @@ bool xmrig::MemoryPool::isHugePages(uint32_t) const
 }
 
 
+xmrig::MemoryPoolInfo xmrig::MemoryPool::info() const
+{
+    MemoryPoolInfo info;
+
+    if (!m_memory) {
+        return info;
+    }
+
+    info.hugePages  = m_memory->hugePages();
+    info.blocks     = m_blocks;
+    info.largest    = m_classes.empty() ? 0 : m_classes.rbegin()->first;
+    info.misses     = m_misses;
+    info.size       = m_size;
+    info.used       = m_used;
+
+    return info;
+}
+
+
 uint8_t *xmrig::MemoryPool::get(size_t size, uint32_t)
 {
     assert(!(size % pageSize));
 
-    if (!m_memory || (m_memory->size() - m_offset - m_alignOffset) < size) {
+    // Best fit: the smallest free block that is big enough, the lowest one of its size class.
+    const auto it = m_memory ? m_classes.lower_bound(size) : m_classes.end();
+    if (it == m_classes.end()) {
+        ++m_misses;
+
         return nullptr;
     }
 
-    uint8_t *out = m_memory->scratchpad() + m_alignOffset + m_offset;
+    const size_t blockSize = it->first;
+    const size_t offset    = *it->second.begin();
+
+    remove(offset, blockSize);
+
+    if (blockSize > size) {
+        insert(offset + size, blockSize - size);
+    }
 
-    m_offset += size;
-    ++m_refs;
+    m_used += size;
+    ++m_blocks;
 
-    return out;
+    return m_memory->scratchpad() + m_alignOffset + offset;
 }
 
 
-void xmrig::MemoryPool::release(uint32_t)
+void xmrig::MemoryPool::release(uint8_t *ptr, size_t size, uint32_t)
 {
-    assert(m_refs > 0);
+    assert(m_blocks > 0);
+    assert(ptr >= m_memory->scratchpad() + m_alignOffset);
 
-    if (m_refs > 0) {
-        --m_refs;
+    if (m_blocks == 0) {
+        return;
     }
 
-    if (m_refs == 0) {
-        m_offset = 0;
+    --m_blocks;
+    m_used -= size;
+
+    size_t offset = static_cast<size_t>(ptr - (m_memory->scratchpad() + m_alignOffset));
+
+    // Merge with the free neighbours, so released blocks don't fragment the arena.
+    auto next = m_free.lower_bound(offset);
+    if (next != m_free.end() && next->first == offset + size) {
+        size += next->second;
+        remove(next->first, next->second);
+    }
+
+    next = m_free.lower_bound(offset);
+    if (next != m_free.begin()) {
+        const auto prev = std::prev(next);
+
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size  += prev->second;
+            remove(prev->first, prev->second);
+        }
+    }
+
+    insert(offset, size);
+}
+
+
+void xmrig::MemoryPool::insert(size_t offset, size_t size)
+{
+    m_free[offset] = size;
+    m_classes[size].insert(offset);
+}
+
+
+void xmrig::MemoryPool::remove(size_t offset, size_t size)
+{
+    m_free.erase(offset);
+
+    auto it = m_classes.find(size);
+    it->second.erase(offset);
+
+    if (it->second.empty()) {
+        m_classes.erase(it);
     }
 }
@@ -32,12 +32,22 @@
 #include "base/tools/Object.h"
 
 
+#include <map>
+#include <set>
+
+
 namespace xmrig {
 
 
 class VirtualMemory;
 
 
+/**
+ * Scratchpad allocator over a single (huge pages) arena.
+ *
+ * Free blocks are kept in size classes (multiples of 2 MB) for best fit lookup and in address order for coalescing,
+ * a released block is merged with its free neighbours, so after workers restart the arena is contiguous again.
+ */
 class MemoryPool : public IMemoryPool
 {
 public:
@@ -48,13 +58,21 @@ public:
 
 protected:
     bool isHugePages(uint32_t node) const override;
+    MemoryPoolInfo info() const override;
     uint8_t *get(size_t size, uint32_t node) override;
-    void release(uint32_t node) override;
+    void release(uint8_t *ptr, size_t size, uint32_t node) override;
 
 private:
-    size_t m_refs           = 0;
-    size_t m_offset         = 0;
+    void insert(size_t offset, size_t size);
+    void remove(size_t offset, size_t size);
+
     size_t m_alignOffset    = 0;
+    size_t m_blocks         = 0;
+    size_t m_misses         = 0;
+    size_t m_size           = 0;
+    size_t m_used           = 0;
+    std::map<size_t, size_t> m_free;                // offset -> size
+    std::map<size_t, std::set<size_t> > m_classes;  // size -> offsets
     VirtualMemory *m_memory = nullptr;
 };
 
@@ -60,6 +60,18 @@ bool xmrig::NUMAMemoryPool::isHugePages(uint32_t node) const
 }
 
 
+xmrig::MemoryPoolInfo xmrig::NUMAMemoryPool::info() const
+{
+    MemoryPoolInfo info;
+
+    for (const auto &kv : m_map) {
+        info += kv.second->info();
+    }
+
+    return info;
+}
+
+
 uint8_t *xmrig::NUMAMemoryPool::get(size_t size, uint32_t node)
 {
     if (!m_size) {
@@ -70,11 +82,11 @@ uint8_t *xmrig::NUMAMemoryPool::get(size_t size, uint32_t node)
 }
 
 
-void xmrig::NUMAMemoryPool::release(uint32_t node)
+void xmrig::NUMAMemoryPool::release(uint8_t *ptr, size_t size, uint32_t node)
 {
     const auto pool = get(node);
     if (pool) {
-        pool->release(node);
+        pool->release(ptr, size, node);
     }
 }
 
@@ -51,8 +51,9 @@ public:
 
 protected:
     bool isHugePages(uint32_t node) const override;
+    MemoryPoolInfo info() const override;
     uint8_t *get(size_t size, uint32_t node) override;
-    void release(uint32_t node) override;
+    void release(uint8_t *ptr, size_t size, uint32_t node) override;
 
 private:
     IMemoryPool *get(uint32_t node) const;
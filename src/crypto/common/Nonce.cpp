@@ -16,14 +16,53 @@
  *   along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "base/tools/Alignment.h"
 #include "crypto/common/Nonce.h"
+#include "base/tools/Alignment.h"
+#include "base/tools/Chrono.h"
+
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 
 namespace xmrig {
 
+
+static constexpr uint32_t kMaxNodes         = 8;
+static constexpr uint32_t kMinNodeReserve   = 256;
+static constexpr uint64_t kMinBlockSize     = 1ULL << 16;
+static constexpr uint64_t kMaxBlockSize     = 1ULL << 28;
+static constexpr uint64_t kRefillInterval   = 100;
+
+
+// Nonces reserved from the global counter for the workers of one NUMA node, refilled about every kRefillInterval ms.
+struct alignas(64) NonceBlock
+{
+    struct Slot
+    {
+        uint64_t end        = 0;
+        uint64_t generation = 0;
+        uint64_t next       = 0;
+        uint64_t size       = kMinBlockSize;
+        uint64_t ts         = 0;
+    };
+
+    std::mutex mutex;
+    Slot slots[2];
+};
+
+
+static std::condition_variable cv;
+static std::mutex mutex;
+static NonceBlock blocks[kMaxNodes];
+static thread_local uint32_t node = 0;
+
+
 std::atomic<bool> Nonce::m_paused = {true};
-std::atomic<uint64_t>  Nonce::m_sequence[Nonce::MAX] = { {1}, {1}, {1} };
+std::atomic<uint64_t> Nonce::m_epoch = {0};
+std::atomic<uint64_t> Nonce::m_generation[2] = { {0}, {0} };
+std::atomic<uint64_t>  Nonce::m_sequence[Nonce::MAX] = { {1}, {1}, {1}, {1} };
 std::atomic<uint64_t> Nonce::m_nonces[2] = { {0}, {0} };
 
 
@@ -37,7 +76,99 @@ bool xmrig::Nonce::next(uint8_t index, uint32_t *nonce, uint32_t reserveCount, u
         return false;
     }
 
-    uint64_t counter = m_nonces[index].fetch_add(reserveCount, std::memory_order_relaxed);
+    // Tiny reservations (benchmark) keep the exact global order of nonces.
+    uint64_t counter = 0;
+    if ((reserveCount < kMinNodeReserve || !reserveFromNode(index, reserveCount, mask, counter)) && !reserve(index, reserveCount, mask, counter)) {
+        return false;
+    }
+
+    writeUnaligned(nonce, static_cast<uint32_t>((readUnaligned(nonce) & ~mask) | counter));
+
+    if (mask > 0xFFFFFFFFULL) {
+        writeUnaligned(nonce + 1, static_cast<uint32_t>((readUnaligned(nonce + 1) & (~mask >> 32)) | (counter >> 32)));
+    }
+
+    return true;
+}
+
+
+void xmrig::Nonce::notify()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        m_epoch.fetch_add(1, std::memory_order_release);
+    }
+
+    cv.notify_all();
+}
+
+
+void xmrig::Nonce::pause(bool paused)
+{
+    m_paused = paused;
+
+    if (!paused) {
+        notify();
+    }
+}
+
+
+void xmrig::Nonce::setNode(uint32_t value)
+{
+    node = value % kMaxNodes;
+}
+
+
+void xmrig::Nonce::stop()
+{
+    m_paused = false;
+
+    for (auto &i : m_sequence) {
+        i = 0;
+    }
+
+    notify();
+}
+
+
+void xmrig::Nonce::stop(Backend backend)
+{
+    m_sequence[backend] = 0;
+
+    notify();
+}
+
+
+void xmrig::Nonce::touch()
+{
+    for (auto &i : m_sequence) {
+        i++;
+    }
+
+    notify();
+}
+
+
+void xmrig::Nonce::touch(Backend backend)
+{
+    m_sequence[backend]++;
+
+    notify();
+}
+
+
+void xmrig::Nonce::wait(uint64_t epoch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // The timeout is only a safety net, waiters are always woken up by notify().
+    cv.wait_for(lock, std::chrono::seconds(1), [epoch] { return m_epoch.load(std::memory_order_relaxed) != epoch; });
+}
+
+
+bool xmrig::Nonce::reserve(uint8_t index, uint32_t reserveCount, uint64_t mask, uint64_t &counter)
+{
+    counter = m_nonces[index].fetch_add(reserveCount, std::memory_order_relaxed);
     while (true) {
         if (mask < counter) {
             return false;
@@ -54,30 +185,63 @@ bool xmrig::Nonce::next(uint8_t index, uint32_t *nonce, uint32_t reserveCount, u
             continue;
         }
 
-        writeUnaligned(nonce, static_cast<uint32_t>((readUnaligned(nonce) & ~mask) | counter));
-
-        if (mask > 0xFFFFFFFFULL) {
-            writeUnaligned(nonce + 1, static_cast<uint32_t>((readUnaligned(nonce + 1) & (~mask >> 32)) | (counter >> 32)));
-        }
-
         return true;
     }
 }
 
 
-void xmrig::Nonce::stop()
+bool xmrig::Nonce::reserveFromNode(uint8_t index, uint32_t reserveCount, uint64_t mask, uint64_t &counter)
 {
-    pause(false);
+    auto &block = blocks[node];
+    std::lock_guard<std::mutex> lock(block.mutex);
 
-    for (auto &i : m_sequence) {
-        i = 0;
+    auto &slot = block.slots[index];
+
+    // Nonce::reset() was called for a new job, the rest of the block belongs to the previous one.
+    const uint64_t generation = m_generation[index].load(std::memory_order_acquire);
+    if (slot.generation != generation) {
+        slot.generation = generation;
+        slot.next       = 0;
+        slot.end        = 0;
     }
-}
 
+    if (slot.end - slot.next < reserveCount) {
+        const uint64_t now = Chrono::steadyMSecs();
 
-void xmrig::Nonce::touch()
-{
-    for (auto &i : m_sequence) {
-        i++;
+        // Scale the block with the node hashrate, so the shared counter is touched at about the same rate on any host.
+        if (slot.ts) {
+            if (now - slot.ts < kRefillInterval / 2 && slot.size < kMaxBlockSize) {
+                slot.size *= 2;
+            }
+            else if (now - slot.ts > kRefillInterval * 4 && slot.size > kMinBlockSize) {
+                slot.size /= 2;
+            }
+        }
+
+        slot.ts = now;
+
+        const uint64_t size = ((std::max<uint64_t>(slot.size, reserveCount * 2ULL) + reserveCount - 1) / reserveCount) * reserveCount;
+
+        // A block must be a small part of the nonce space (nicehash masks are reserved directly) and must not cross a 32 bit boundary.
+        // The tail of the nonce space is always left to reserve(), so exhaustion is detected in one place.
+        if (size > (mask >> 10)) {
+            return false;
+        }
+
+        uint64_t value = m_nonces[index].load(std::memory_order_relaxed);
+        do {
+            if (value > mask || mask - value < size - 1 + reserveCount || 0xFFFFFFFFUL - (uint32_t)value < size - 1) {
+                return false;
+            }
+        }
+        while (!m_nonces[index].compare_exchange_weak(value, value + size, std::memory_order_relaxed));
+
+        slot.next   = value;
+        slot.end    = value + size;
     }
+
+    counter     = slot.next;
+    slot.next  += reserveCount;
+
+    return true;
 }
@@ -41,16 +41,38 @@ public:
     static inline bool isOutdated(Backend backend, uint64_t sequence)   { return m_sequence[backend].load(std::memory_order_relaxed) != sequence; }
     static inline bool isPaused()                                       { return m_paused.load(std::memory_order_relaxed); }
     static inline uint64_t sequence(Backend backend)                    { return m_sequence[backend].load(std::memory_order_relaxed); }
-    static inline void pause(bool paused)                               { m_paused = paused; }
-    static inline void reset(uint8_t index)                             { m_nonces[index] = 0; }
-    static inline void stop(Backend backend)                            { m_sequence[backend] = 0; }
-    static inline void touch(Backend backend)                           { m_sequence[backend]++; }
+    static inline void reset(uint8_t index)                             { m_nonces[index] = 0; m_generation[index]++; }
 
     static bool next(uint8_t index, uint32_t *nonce, uint32_t reserveCount, uint64_t mask);
+    static void notify();
+    static void pause(bool paused);
+    static void setNode(uint32_t node);
     static void stop();
+    static void stop(Backend backend);
     static void touch();
+    static void touch(Backend backend);
+
+    // Blocks the calling worker while the condition is true, every state change above wakes up waiters immediately.
+    template<typename T>
+    static inline void wait(T condition)
+    {
+        while (true) {
+            const uint64_t epoch = m_epoch.load(std::memory_order_acquire);
+            if (!condition()) {
+                return;
+            }
+
+            wait(epoch);
+        }
+    }
 
 private:
+    static bool reserve(uint8_t index, uint32_t reserveCount, uint64_t mask, uint64_t &counter);
+    static bool reserveFromNode(uint8_t index, uint32_t reserveCount, uint64_t mask, uint64_t &counter);
+    static void wait(uint64_t epoch);
+
+    static std::atomic<uint64_t> m_epoch;
+    static std::atomic<uint64_t> m_generation[2];
     static std::atomic<bool> m_paused;
     static std::atomic<uint64_t> m_sequence[MAX];
     static std::atomic<uint64_t> m_nonces[2];
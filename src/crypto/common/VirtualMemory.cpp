@@ -19,6 +19,7 @@
 
 
 #include "crypto/common/VirtualMemory.h"
+#include "backend/common/interfaces/IMemoryPool.h"
 #include "backend/cpu/Cpu.h"
 #include "base/io/log/Log.h"
 #include "crypto/common/MemoryPool.h"
@@ -86,7 +87,7 @@ xmrig::VirtualMemory::~VirtualMemory()
 
     if (m_flags.test(FLAG_EXTERNAL)) {
         std::lock_guard<std::mutex> lock(mutex);
-        pool->release(m_node);
+        pool->release(m_scratchpad, m_size, m_node);
     }
     else if (isHugePages() || isOneGbPages()) {
         freeLargePagesMemory();
@@ -111,6 +112,14 @@ uint32_t xmrig::VirtualMemory::bindToNUMANode(int64_t)
 #endif
 
 
+xmrig::MemoryPoolInfo xmrig::VirtualMemory::poolInfo()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return pool ? pool->info() : MemoryPoolInfo();
+}
+
+
 void xmrig::VirtualMemory::destroy()
 {
     delete pool;
@@ -34,6 +34,9 @@
 namespace xmrig {
 
 
+class MemoryPoolInfo;
+
+
 class VirtualMemory
 {
 public:
@@ -57,6 +60,7 @@ public:
     HugePagesInfo hugePages() const;
 
     static bool isHugepagesAvailable();
+    static MemoryPoolInfo poolInfo();
     static bool isOneGbPagesAvailable();
     static bool protectRW(void *p, size_t size);
     static bool protectRWX(void *p, size_t size);
@@ -33,6 +33,10 @@
 #include "sph_shabal.h"
 #include "sph_whirlpool.h"
 
+#ifdef XMRIG_FEATURE_AVX2
+#   include "sph_4way_avx2.h"
+#endif
+
 #include "base/io/log/Log.h"
 #include "base/io/log/Tags.h"
 #include "base/tools/Chrono.h"
@@ -92,6 +96,34 @@ CORE_HASH(14, whirlpool  );
 using core_hash_func = void (*)(const uint8_t* data, size_t size, uint8_t* output);
 static const core_hash_func core_hash[15] = { h0, h1, h2, h3, h4, h5, h6, h7, h8, h9, h10, h11, h12, h13, h14 };
 
+#ifdef XMRIG_FEATURE_AVX2
+// Multi-buffer versions which hash 4 independent inputs at once, nullptr if not available
+static const core_hash_func core_hash_4way_avx2[15] = {
+    blake512_4way_avx2, nullptr, nullptr, nullptr, keccak512_4way_avx2, skein512_4way_avx2, nullptr, nullptr,
+    nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr
+};
+#endif
+
+// Runs core hash "index" for inputs [first, last) of a batch, output stride is always 64 bytes
+static inline void core_hash_lanes(uint32_t index, const uint8_t* data, size_t size, uint8_t* output, size_t first, size_t last)
+{
+    size_t j = first;
+
+#   ifdef XMRIG_FEATURE_AVX2
+    static const bool has_avx2 = xmrig::Cpu::info()->hasAVX2();
+
+    if (has_avx2 && core_hash_4way_avx2[index]) {
+        for (; j + 4 <= last; j += 4) {
+            core_hash_4way_avx2[index](data + j * size, size, output + j * 64);
+        }
+    }
+#   endif
+
+    for (; j < last; ++j) {
+        core_hash[index](data + j * size, size, output + j * 64);
+    }
+}
+
 namespace xmrig
 {
 
@@ -620,9 +652,7 @@ void hash_octa(const uint8_t* data, size_t size, uint8_t* output, cryptonight_ct
                 }
 
                 for (size_t i = 0; i < 5; ++i) {
-                    for (size_t j = n; j < N; ++j) {
-                        core_hash[core_indices[part * 5 + i]](input + j * input_size, input_size, tmp + j * 64);
-                    }
+                    core_hash_lanes(core_indices[part * 5 + i], input, input_size, tmp, n, N);
                     input = tmp;
                     input_size = 64;
                 }
@@ -664,9 +694,7 @@ void hash_octa(const uint8_t* data, size_t size, uint8_t* output, cryptonight_ct
             }
 
             for (size_t i = 0; i < 5; ++i) {
-                for (size_t j = 0; j < n; ++j) {
-                    core_hash[core_indices[part * 5 + i]](input + j * input_size, input_size, tmp + j * 64);
-                }
+                core_hash_lanes(core_indices[part * 5 + i], input, input_size, tmp, 0, n);
                 input = tmp;
                 input_size = 64;
             }
@@ -732,9 +760,7 @@ void hash_octa(const uint8_t* data, size_t size, uint8_t* output, cryptonight_ct
                     size_t input_size = size;
 
                     for (size_t i = 0; i < 5; ++i) {
-                        for (size_t j = n; j < N; ++j) {
-                            core_hash[core_indices[part * 5 + i]](input + j * input_size, input_size, tmp + j * 64);
-                        }
+                        core_hash_lanes(core_indices[part * 5 + i], input, input_size, tmp, n, N);
                         input = tmp;
                         input_size = 64;
                     }
@@ -752,9 +778,7 @@ void hash_octa(const uint8_t* data, size_t size, uint8_t* output, cryptonight_ct
             }
 
             for (size_t i = 0; i < 5; ++i) {
-                for (size_t j = 0; j < n; ++j) {
-                    core_hash[core_indices[part * 5 + i]](data + j * size, size, tmp + j * 64);
-                }
+                core_hash_lanes(core_indices[part * 5 + i], data, size, tmp, 0, n);
                 data = tmp;
                 size = 64;
             }
@@ -848,9 +872,7 @@ void hash_octa(const uint8_t* data, size_t size, uint8_t* output, cryptonight_ct
         }
 
         for (size_t i = 0; i < 5; ++i) {
-            for (size_t j = 0; j < N; ++j) {
-                core_hash[core_indices[part * 5 + i]](data + j * size, size, tmp + j * 64);
-            }
+            core_hash_lanes(core_indices[part * 5 + i], data, size, tmp, 0, N);
             data = tmp;
             size = 64;
         }
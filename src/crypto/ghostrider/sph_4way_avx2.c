@@ -0,0 +1,474 @@
+/* XMRig
+ * Copyright 2018-2023 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2023 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sph_4way_avx2.h"
+
+#include <immintrin.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define LANES 4
+
+
+#ifdef _MSC_VER
+#   define bswap64 _byteswap_uint64
+#else
+#   define bswap64 __builtin_bswap64
+#endif
+
+
+static inline uint64_t load64le(const uint8_t* p)
+{
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+
+static inline uint64_t load64be(const uint8_t* p)
+{
+    return bswap64(load64le(p));
+}
+
+
+static inline __m256i rotl64(__m256i x, int c)
+{
+    return _mm256_or_si256(_mm256_slli_epi64(x, c), _mm256_srli_epi64(x, 64 - c));
+}
+
+
+static inline __m256i rotr64(__m256i x, int c)
+{
+    return _mm256_or_si256(_mm256_srli_epi64(x, c), _mm256_slli_epi64(x, 64 - c));
+}
+
+
+static inline __m256i set1(uint64_t x)
+{
+    return _mm256_set1_epi64x((long long) x);
+}
+
+
+/* Gathers 64-bit word "w" of the current block of each lane */
+static inline __m256i gather_le(const uint8_t (*block)[128], size_t w)
+{
+    return _mm256_set_epi64x((long long) load64le(block[3] + w * 8), (long long) load64le(block[2] + w * 8), (long long) load64le(block[1] + w * 8), (long long) load64le(block[0] + w * 8));
+}
+
+
+static inline __m256i gather_be(const uint8_t (*block)[128], size_t w)
+{
+    return _mm256_set_epi64x((long long) load64be(block[3] + w * 8), (long long) load64be(block[2] + w * 8), (long long) load64be(block[1] + w * 8), (long long) load64be(block[0] + w * 8));
+}
+
+
+static inline void scatter(__m256i x, uint8_t* output, size_t w, int big_endian)
+{
+    uint64_t v[LANES];
+    _mm256_storeu_si256((__m256i*) v, x);
+
+    for (size_t i = 0; i < LANES; ++i) {
+        const uint64_t t = big_endian ? bswap64(v[i]) : v[i];
+        memcpy(output + i * 64 + w * 8, &t, sizeof(t));
+    }
+}
+
+
+/* Copies up to "block_size" bytes at "offset" of every lane into zero padded blocks */
+static inline size_t copy_block(uint8_t (*block)[128], const uint8_t* data, size_t size, size_t offset, size_t block_size)
+{
+    const size_t n = (size - offset) < block_size ? (size - offset) : block_size;
+
+    for (size_t i = 0; i < LANES; ++i) {
+        memset(block[i], 0, 128);
+        memcpy(block[i], data + i * size + offset, n);
+    }
+
+    return n;
+}
+
+
+/* ---------------------------------------------------------------- BLAKE-512 */
+
+static const uint64_t blake_iv[8] = {
+    0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL, 0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+    0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL, 0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+
+static const uint64_t blake_cb[16] = {
+    0x243F6A8885A308D3ULL, 0x13198A2E03707344ULL, 0xA4093822299F31D0ULL, 0x082EFA98EC4E6C89ULL,
+    0x452821E638D01377ULL, 0xBE5466CF34E90C6CULL, 0xC0AC29B7C97C50DDULL, 0x3F84D5B5B5470917ULL,
+    0x9216D5D98979FB1BULL, 0xD1310BA698DFB5ACULL, 0x2FFD72DBD01ADFB7ULL, 0xB8E1AFED6A267E96ULL,
+    0xBA7C9045F12C7F99ULL, 0x24A19947B3916CF7ULL, 0x0801F2E2858EFC16ULL, 0x636920D871574E69ULL
+};
+
+
+static const uint8_t blake_sigma[10][16] = {
+    {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+    { 14, 10,  4,  8,  9, 15, 13,  6,  1, 12,  0,  2, 11,  7,  5,  3 },
+    { 11,  8, 12,  0,  5,  2, 15, 13, 10, 14,  3,  6,  7,  1,  9,  4 },
+    {  7,  9,  3,  1, 13, 12, 11, 14,  2,  6,  5, 10,  4,  0, 15,  8 },
+    {  9,  0,  5,  7,  2,  4, 10, 15, 14,  1, 11, 12,  6,  8,  3, 13 },
+    {  2, 12,  6, 10,  0, 11,  8,  3,  4, 13,  7,  5, 15, 14,  1,  9 },
+    { 12,  5,  1, 15, 14, 13,  4, 10,  0,  7,  6,  3,  9,  2,  8, 11 },
+    { 13, 11,  7, 14, 12,  1,  3,  9,  5,  0, 15,  4,  8,  6,  2, 10 },
+    {  6, 15, 14,  9, 11,  3,  0,  8, 12,  2, 13,  7,  1,  4, 10,  5 },
+    { 10,  2,  8,  4,  7,  6,  1,  5, 15, 11,  9, 14,  3, 12, 13,  0 }
+};
+
+
+#define BLAKE_G(r, i, a, b, c, d) do { \
+    const uint8_t s0 = blake_sigma[r][2 * (i)]; \
+    const uint8_t s1 = blake_sigma[r][2 * (i) + 1]; \
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_xor_si256(m[s0], set1(blake_cb[s1]))); \
+    d = rotr64(_mm256_xor_si256(d, a), 32); \
+    c = _mm256_add_epi64(c, d); \
+    b = rotr64(_mm256_xor_si256(b, c), 25); \
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), _mm256_xor_si256(m[s1], set1(blake_cb[s0]))); \
+    d = rotr64(_mm256_xor_si256(d, a), 16); \
+    c = _mm256_add_epi64(c, d); \
+    b = rotr64(_mm256_xor_si256(b, c), 11); \
+} while (0)
+
+
+static void blake512_compress(__m256i* h, const uint8_t (*block)[128], uint64_t counter)
+{
+    __m256i m[16];
+    __m256i v[16];
+
+    for (size_t i = 0; i < 16; ++i) {
+        m[i] = gather_be(block, i);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        v[i]     = h[i];
+        v[i + 8] = set1(blake_cb[i]);
+    }
+
+    v[12] = _mm256_xor_si256(v[12], set1(counter));
+    v[13] = _mm256_xor_si256(v[13], set1(counter));
+
+    for (size_t r = 0; r < 16; ++r) {
+        const size_t s = r % 10;
+
+        BLAKE_G(s, 0, v[0], v[4], v[8],  v[12]);
+        BLAKE_G(s, 1, v[1], v[5], v[9],  v[13]);
+        BLAKE_G(s, 2, v[2], v[6], v[10], v[14]);
+        BLAKE_G(s, 3, v[3], v[7], v[11], v[15]);
+        BLAKE_G(s, 4, v[0], v[5], v[10], v[15]);
+        BLAKE_G(s, 5, v[1], v[6], v[11], v[12]);
+        BLAKE_G(s, 6, v[2], v[7], v[8],  v[13]);
+        BLAKE_G(s, 7, v[3], v[4], v[9],  v[14]);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]));
+    }
+}
+
+
+void blake512_4way_avx2(const uint8_t* data, size_t size, uint8_t* output)
+{
+    uint8_t block[LANES][128];
+    __m256i h[8];
+
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = set1(blake_iv[i]);
+    }
+
+    size_t offset = 0;
+    for (; size - offset > 128; offset += 128) {
+        copy_block(block, data, size, offset, 128);
+        blake512_compress(h, (const uint8_t (*)[128]) block, (offset + 128) * 8);
+    }
+
+    const size_t rest      = size - offset;
+    const uint64_t bits    = (uint64_t) size * 8;
+
+    if (rest == 128) {
+        copy_block(block, data, size, offset, 128);
+        blake512_compress(h, (const uint8_t (*)[128]) block, bits);
+
+        memset(block, 0, sizeof(block));
+        for (size_t i = 0; i < LANES; ++i) {
+            block[i][0]   = 0x80;
+            block[i][111] = 0x01;
+            for (size_t k = 0; k < 8; ++k) {
+                block[i][127 - k] = (uint8_t) (bits >> (k * 8));
+            }
+        }
+
+        blake512_compress(h, (const uint8_t (*)[128]) block, 0);
+    }
+    else {
+        copy_block(block, data, size, offset, rest);
+
+        for (size_t i = 0; i < LANES; ++i) {
+            block[i][rest] = 0x80;
+        }
+
+        if (rest <= 111) {
+            for (size_t i = 0; i < LANES; ++i) {
+                block[i][111] |= 0x01;
+                for (size_t k = 0; k < 8; ++k) {
+                    block[i][127 - k] = (uint8_t) (bits >> (k * 8));
+                }
+            }
+
+            blake512_compress(h, (const uint8_t (*)[128]) block, rest ? bits : 0);
+        }
+        else {
+            blake512_compress(h, (const uint8_t (*)[128]) block, bits);
+
+            memset(block, 0, sizeof(block));
+            for (size_t i = 0; i < LANES; ++i) {
+                block[i][111] = 0x01;
+                for (size_t k = 0; k < 8; ++k) {
+                    block[i][127 - k] = (uint8_t) (bits >> (k * 8));
+                }
+            }
+
+            blake512_compress(h, (const uint8_t (*)[128]) block, 0);
+        }
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        scatter(h[i], output, i, 1);
+    }
+}
+
+
+/* --------------------------------------------------------------- Keccak-512 */
+
+static const uint64_t keccak_rc[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+
+static const uint8_t keccak_rho[25] = {
+     0,  1, 62, 28, 27,
+    36, 44,  6, 55, 20,
+     3, 10, 43, 25, 39,
+    41, 45, 15, 21,  8,
+    18,  2, 61, 56, 14
+};
+
+
+static inline __m256i rotl64v(__m256i x, int c)
+{
+    return c ? rotl64(x, c) : x;
+}
+
+
+static void keccakf1600(__m256i* a)
+{
+    __m256i b[25];
+    __m256i c[5];
+    __m256i d[5];
+
+    for (size_t round = 0; round < 24; ++round) {
+        for (size_t x = 0; x < 5; ++x) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]), _mm256_xor_si256(_mm256_xor_si256(a[x + 10], a[x + 15]), a[x + 20]));
+        }
+
+        for (size_t x = 0; x < 5; ++x) {
+            d[x] = _mm256_xor_si256(c[(x + 4) % 5], rotl64(c[(x + 1) % 5], 1));
+        }
+
+        /* theta, rho and pi: B[y][2x+3y] = rot(A[x][y] ^ D[x], r[x][y]) */
+        for (size_t y = 0; y < 5; ++y) {
+            for (size_t x = 0; x < 5; ++x) {
+                const size_t i = x + 5 * y;
+                b[y + 5 * ((2 * x + 3 * y) % 5)] = rotl64v(_mm256_xor_si256(a[i], d[x]), keccak_rho[i]);
+            }
+        }
+
+        /* chi */
+        for (size_t y = 0; y < 25; y += 5) {
+            for (size_t x = 0; x < 5; ++x) {
+                a[y + x] = _mm256_xor_si256(b[y + x], _mm256_andnot_si256(b[y + (x + 1) % 5], b[y + (x + 2) % 5]));
+            }
+        }
+
+        /* iota */
+        a[0] = _mm256_xor_si256(a[0], set1(keccak_rc[round]));
+    }
+}
+
+
+void keccak512_4way_avx2(const uint8_t* data, size_t size, uint8_t* output)
+{
+    enum { RATE = 72 };
+
+    uint8_t block[LANES][128];
+    __m256i a[25];
+
+    for (size_t i = 0; i < 25; ++i) {
+        a[i] = _mm256_setzero_si256();
+    }
+
+    size_t offset = 0;
+    for (; size - offset >= RATE; offset += RATE) {
+        copy_block(block, data, size, offset, RATE);
+
+        for (size_t i = 0; i < RATE / 8; ++i) {
+            a[i] = _mm256_xor_si256(a[i], gather_le((const uint8_t (*)[128]) block, i));
+        }
+
+        keccakf1600(a);
+    }
+
+    const size_t rest = copy_block(block, data, size, offset, RATE);
+
+    /* Original Keccak padding (0x01), as used by sph_keccak */
+    for (size_t i = 0; i < LANES; ++i) {
+        block[i][rest]     |= 0x01;
+        block[i][RATE - 1] |= 0x80;
+    }
+
+    for (size_t i = 0; i < RATE / 8; ++i) {
+        a[i] = _mm256_xor_si256(a[i], gather_le((const uint8_t (*)[128]) block, i));
+    }
+
+    keccakf1600(a);
+
+    for (size_t i = 0; i < 8; ++i) {
+        scatter(a[i], output, i, 0);
+    }
+}
+
+
+/* ---------------------------------------------------------------- Skein-512 */
+
+static const uint64_t skein_iv[8] = {
+    0x4903ADFF749C51CEULL, 0x0D95DE399746DF03ULL, 0x8FD1934127C79BCEULL, 0x9A255629FF352CB1ULL,
+    0x5DB62599DF6CA7B0ULL, 0xEABE394CA9D5C3F4ULL, 0x991112C71A75B523ULL, 0xAE18A40B660FCC33ULL
+};
+
+
+#define SKEIN_MIX(a, b, rc) do { \
+    p[a] = _mm256_add_epi64(p[a], p[b]); \
+    p[b] = _mm256_xor_si256(rotl64(p[b], rc), p[a]); \
+} while (0)
+
+
+/* 8 rounds of Threefish-512 (Skein 1.3 rotation constants), the word permutation is applied by renaming */
+#define SKEIN_ROUNDS_8() do { \
+    SKEIN_MIX(0, 1, 46); SKEIN_MIX(2, 3, 36); SKEIN_MIX(4, 5, 19); SKEIN_MIX(6, 7, 37); \
+    SKEIN_MIX(2, 1, 33); SKEIN_MIX(4, 7, 27); SKEIN_MIX(6, 5, 14); SKEIN_MIX(0, 3, 42); \
+    SKEIN_MIX(4, 1, 17); SKEIN_MIX(6, 3, 49); SKEIN_MIX(0, 5, 36); SKEIN_MIX(2, 7, 39); \
+    SKEIN_MIX(6, 1, 44); SKEIN_MIX(0, 7,  9); SKEIN_MIX(2, 5, 54); SKEIN_MIX(4, 3, 56); \
+    skein512_inject_key(p, k, t, s + 1); \
+    SKEIN_MIX(0, 1, 39); SKEIN_MIX(2, 3, 30); SKEIN_MIX(4, 5, 34); SKEIN_MIX(6, 7, 24); \
+    SKEIN_MIX(2, 1, 13); SKEIN_MIX(4, 7, 50); SKEIN_MIX(6, 5, 10); SKEIN_MIX(0, 3, 17); \
+    SKEIN_MIX(4, 1, 25); SKEIN_MIX(6, 3, 29); SKEIN_MIX(0, 5, 39); SKEIN_MIX(2, 7, 43); \
+    SKEIN_MIX(6, 1,  8); SKEIN_MIX(0, 7, 35); SKEIN_MIX(2, 5, 56); SKEIN_MIX(4, 3, 22); \
+    skein512_inject_key(p, k, t, s + 2); \
+} while (0)
+
+
+#define SKEIN_T1_FIRST  (1ULL << 62)
+#define SKEIN_T1_FINAL  (1ULL << 63)
+#define SKEIN_T1_MSG    (48ULL << 56)
+#define SKEIN_T1_OUT    (63ULL << 56)
+
+
+static inline void skein512_inject_key(__m256i* p, const __m256i* k, const uint64_t* t, size_t s)
+{
+    for (size_t i = 0; i < 8; ++i) {
+        p[i] = _mm256_add_epi64(p[i], k[(s + i) % 9]);
+    }
+
+    p[5] = _mm256_add_epi64(p[5], set1(t[s % 3]));
+    p[6] = _mm256_add_epi64(p[6], set1(t[(s + 1) % 3]));
+    p[7] = _mm256_add_epi64(p[7], set1(s));
+}
+
+
+/* UBI step: h = Threefish-512(key = h, tweak = t0/t1, plaintext = m) ^ m */
+static void skein512_ubi(__m256i* h, const __m256i* m, uint64_t t0, uint64_t t1)
+{
+    __m256i k[9];
+    __m256i p[8];
+    const uint64_t t[3] = { t0, t1, t0 ^ t1 };
+
+    k[8] = set1(0x1BD11BDAA9FC1A22ULL);
+    for (size_t i = 0; i < 8; ++i) {
+        k[i] = h[i];
+        k[8] = _mm256_xor_si256(k[8], h[i]);
+        p[i] = m[i];
+    }
+
+    skein512_inject_key(p, k, t, 0);
+
+    /* 72 rounds, a subkey is injected after every 4 rounds */
+    for (size_t s = 0; s < 18; s += 2) {
+        SKEIN_ROUNDS_8();
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = _mm256_xor_si256(p[i], m[i]);
+    }
+}
+
+
+void skein512_4way_avx2(const uint8_t* data, size_t size, uint8_t* output)
+{
+    uint8_t block[LANES][128];
+    __m256i h[8];
+    __m256i m[8];
+
+    for (size_t i = 0; i < 8; ++i) {
+        h[i] = set1(skein_iv[i]);
+    }
+
+    uint64_t flags = SKEIN_T1_FIRST | SKEIN_T1_MSG;
+    size_t offset  = 0;
+
+    do {
+        const size_t n     = copy_block(block, data, size, offset, 64);
+        const int is_final = (offset + n) >= size;
+
+        for (size_t i = 0; i < 8; ++i) {
+            m[i] = gather_le((const uint8_t (*)[128]) block, i);
+        }
+
+        skein512_ubi(h, m, offset + n, flags | (is_final ? SKEIN_T1_FINAL : 0));
+
+        flags  &= ~SKEIN_T1_FIRST;
+        offset += n;
+    }
+    while (offset < size);
+
+    for (size_t i = 0; i < 8; ++i) {
+        m[i] = _mm256_setzero_si256();
+    }
+
+    skein512_ubi(h, m, 8, SKEIN_T1_FIRST | SKEIN_T1_FINAL | SKEIN_T1_OUT);
+
+    for (size_t i = 0; i < 8; ++i) {
+        scatter(h[i], output, i, 0);
+    }
+}
@@ -0,0 +1,47 @@
+/* XMRig
+ * Copyright 2018-2023 SChernykh   <https://github.com/SChernykh>
+ * Copyright 2016-2023 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_SPH_4WAY_AVX2_H
+#define XMRIG_SPH_4WAY_AVX2_H
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/*
+ * 4-way multi-buffer versions of GhostRider's 64-bit core hashes.
+ * Lane i hashes "size" bytes at data + i * size and writes 64 bytes to output + i * 64,
+ * output may overlap with input. Results are identical to the sph_* reference functions.
+ */
+void blake512_4way_avx2(const uint8_t* data, size_t size, uint8_t* output);
+void keccak512_4way_avx2(const uint8_t* data, size_t size, uint8_t* output);
+void skein512_4way_avx2(const uint8_t* data, size_t size, uint8_t* output);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* XMRIG_SPH_4WAY_AVX2_H */
@@ -35,7 +35,7 @@ namespace xmrig {
 
 
 std::mutex KPCache::s_cacheMutex;
-KPCache KPCache::s_cache;
+std::shared_ptr<KPCache> KPCache::s_cache;
 
 
 KPCache::KPCache()
@@ -49,6 +49,38 @@ KPCache::~KPCache()
 }
 
 
+// Light cache shared by the GPU runners and the result verifier, hashing with the returned instance needs no lock
+std::shared_ptr<KPCache> KPCache::get(uint32_t epoch)
+{
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+
+    if (s_cache && s_cache->epoch() == epoch) {
+        return s_cache;
+    }
+
+    // Whoever still holds the previous epoch keeps it, the instance is only reused in place when nobody does
+    auto cache = s_cache.use_count() == 1 ? s_cache : std::make_shared<KPCache>();
+    if (!cache->init(epoch)) {
+        return nullptr;
+    }
+
+    s_cache = std::move(cache);
+
+    return s_cache;
+}
+
+
+void KPCache::clear()
+{
+    delete m_memory;
+    m_memory = nullptr;
+    m_size   = 0;
+    m_epoch  = 0xFFFFFFFFUL;
+
+    std::vector<uint32_t>().swap(m_DAGCache);
+}
+
+
 bool KPCache::init(uint32_t epoch)
 {
     if (epoch >= sizeof(cache_sizes) / sizeof(cache_sizes[0])) {
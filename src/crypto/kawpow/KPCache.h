@@ -21,6 +21,7 @@
 
 
 #include "base/tools/Object.h"
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -45,6 +46,7 @@ public:
     ~KPCache();
 
     bool init(uint32_t epoch);
+    void clear();
 
     void* data() const;
     size_t size() const { return m_size; }
@@ -57,10 +59,12 @@ public:
 
     static void calculate_fast_mod_data(uint32_t divisor, uint32_t &reciprocal, uint32_t &increment, uint32_t& shift);
 
-    static std::mutex s_cacheMutex;
-    static KPCache s_cache;
+    static std::shared_ptr<KPCache> get(uint32_t epoch);
 
 private:
+    static std::mutex s_cacheMutex;
+    static std::shared_ptr<KPCache> s_cache;
+
     VirtualMemory* m_memory = nullptr;
     size_t m_size = 0;
     uint32_t m_epoch = 0xFFFFFFFFUL;
@@ -0,0 +1,278 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <cinttypes>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <uv.h>
+
+
+#include "crypto/kawpow/KPDag.h"
+#include "3rdparty/libethash/ethash_internal.h"
+#include "base/io/log/Log.h"
+#include "base/io/log/Tags.h"
+#include "base/tools/Chrono.h"
+#include "crypto/common/VirtualMemory.h"
+
+
+namespace xmrig {
+
+
+static constexpr uint32_t kInvalidEpoch = 0xFFFFFFFFUL;
+
+
+static std::condition_variable cv;
+static std::mutex mutex;
+static std::thread builder;
+static KPDag sharedDag;
+static bool building        = false;
+static bool wantHugePages   = false;
+static uint32_t dagEpoch    = kInvalidEpoch;
+static uint32_t failedEpoch = kInvalidEpoch;
+static uint32_t users       = 0;
+static uint32_t wantEpoch   = kInvalidEpoch;
+
+
+} // namespace xmrig
+
+
+xmrig::KPDag::~KPDag()
+{
+    delete m_memory;
+}
+
+
+const void *xmrig::KPDag::data() const
+{
+    return m_memory ? m_memory->raw() : nullptr;
+}
+
+
+xmrig::HugePagesInfo xmrig::KPDag::hugePages()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (building || !sharedDag.m_memory) {
+        return {};
+    }
+
+    return sharedDag.m_memory->hugePages();
+}
+
+
+xmrig::KPDag *xmrig::KPDag::acquire(uint32_t epoch)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (!cv.wait_for(lock, std::chrono::milliseconds(20), [epoch] { return !building && dagEpoch == epoch; })) {
+        return nullptr;
+    }
+
+    ++users;
+
+    return &sharedDag;
+}
+
+
+void xmrig::KPDag::destroy()
+{
+    if (builder.joinable()) {
+        builder.join();
+    }
+}
+
+
+void xmrig::KPDag::prepare(uint32_t epoch, bool hugePages)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    wantEpoch     = epoch;
+    wantHugePages = hugePages;
+
+    if (building) {
+        cv.notify_all();
+
+        return;
+    }
+
+    if (dagEpoch == epoch || failedEpoch == epoch) {
+        return;
+    }
+
+    building = true;
+    lock.unlock();
+
+    // Started from the main thread, so unlike mining threads the builder and its helpers are not pinned to one core
+    if (builder.joinable()) {
+        builder.join();
+    }
+
+    builder = std::thread(build);
+}
+
+
+void xmrig::KPDag::release(KPDag *dag)
+{
+    if (!dag) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (--users == 0 && !building && wantEpoch == kInvalidEpoch) {
+        sharedDag.clear();
+    }
+
+    cv.notify_all();
+}
+
+
+void xmrig::KPDag::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    wantEpoch = kInvalidEpoch;
+
+    // Threads still hashing the old epoch free it on the last release, a running builder when it stops
+    if (users == 0 && !building) {
+        sharedDag.clear();
+    }
+
+    cv.notify_all();
+}
+
+
+void xmrig::KPDag::build()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        // The DAG is rebuilt in place, so wait until all threads have released the previous epoch
+        cv.wait(lock, [] { return users == 0 || wantEpoch == dagEpoch; });
+
+        const uint32_t epoch = wantEpoch;
+        const bool hugePages = wantHugePages;
+
+        if (epoch == kInvalidEpoch || epoch == dagEpoch || epoch == failedEpoch) {
+            break;
+        }
+
+        dagEpoch = kInvalidEpoch;
+        lock.unlock();
+
+        const bool ok = sharedDag.init(epoch, hugePages);
+
+        lock.lock();
+
+        if (ok) {
+            dagEpoch = epoch;
+        }
+        else {
+            failedEpoch = epoch;
+
+            LOG_ERR("%s " YELLOW("KawPow") RED(" failed to prepare light cache for epoch ") RED_BOLD("%u"), Tags::miner(), epoch);
+        }
+    }
+
+    building = false;
+
+    if (wantEpoch == kInvalidEpoch && users == 0) {
+        sharedDag.clear();
+    }
+
+    cv.notify_all();
+}
+
+
+void xmrig::KPDag::clear()
+{
+    delete m_memory;
+    m_memory = nullptr;
+    dagEpoch = kInvalidEpoch;
+
+    m_cache.clear();
+}
+
+
+bool xmrig::KPDag::init(uint32_t epoch, bool hugePages)
+{
+    if (!m_cache.init(epoch)) {
+        return false;
+    }
+
+    const uint64_t size = KPCache::dag_size(epoch);
+
+    if (!m_memory || m_memory->size() < size) {
+        delete m_memory;
+        m_memory = nullptr;
+
+        if (uv_get_total_memory() < (size + m_cache.size())) {
+            LOG_WARN("%s " YELLOW("KawPow") " not enough memory for DAG " CYAN_BOLD("%" PRIu64 " MB") ", switching to light mode", Tags::miner(), size / (1024 * 1024));
+
+            return true;
+        }
+
+        m_memory = new VirtualMemory(size, hugePages, false, false);
+
+        if (!m_memory->raw()) {
+            delete m_memory;
+            m_memory = nullptr;
+
+            return true;
+        }
+    }
+
+    const uint64_t start_ms = Chrono::steadyMSecs();
+
+    ethash_light cache;
+    cache.cache      = m_cache.data();
+    cache.cache_size = m_cache.size();
+
+    cache.num_parent_nodes = cache.cache_size / sizeof(node);
+    KPCache::calculate_fast_mod_data(cache.num_parent_nodes, cache.reciprocal, cache.increment, cache.shift);
+
+    node *items             = reinterpret_cast<node*>(m_memory->raw());
+    const uint64_t nodes    = size / sizeof(node);
+    const uint64_t n        = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::vector<std::thread> threads;
+    threads.reserve(n);
+
+    for (uint64_t i = 0; i < n; ++i) {
+        const uint32_t a = static_cast<uint32_t>((nodes * i) / n);
+        const uint32_t b = static_cast<uint32_t>((nodes * (i + 1)) / n);
+
+        threads.emplace_back([items, a, b, &cache]() {
+            uint32_t j = a;
+            for (; j + 4 <= b; j += 4) ethash_calculate_dag_item4_opt(items + j, j, KPCache::num_dataset_parents, &cache);
+            for (; j < b; ++j) ethash_calculate_dag_item_opt(items + j, j, KPCache::num_dataset_parents, &cache);
+        });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    LOG_INFO("%s " YELLOW("KawPow") " DAG for epoch " WHITE_BOLD("%u") " calculated " CYAN_BOLD("%" PRIu64 " MB") " huge pages %s" BLACK_BOLD(" (%" PRIu64 "ms)"),
+             Tags::miner(), epoch, size / (1024 * 1024), m_memory->isHugePages() ? GREEN_BOLD_S "on" CLEAR : RED_BOLD_S "off" CLEAR, Chrono::steadyMSecs() - start_ms);
+
+    return true;
+}
@@ -0,0 +1,69 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_KP_DAG_H
+#define XMRIG_KP_DAG_H
+
+
+#include "base/tools/Object.h"
+#include "crypto/common/HugePagesInfo.h"
+#include "crypto/kawpow/KPCache.h"
+
+
+namespace xmrig
+{
+
+
+class VirtualMemory;
+
+
+// Full KawPow DAG shared by all CPU mining threads, falls back to the light cache when there is not enough memory
+class KPDag
+{
+public:
+    XMRIG_DISABLE_COPY_MOVE(KPDag)
+
+    KPDag() = default;
+    ~KPDag();
+
+    inline const KPCache &cache() const { return m_cache; }
+
+    const void *data() const;
+
+    static HugePagesInfo hugePages();
+    static KPDag *acquire(uint32_t epoch);
+    static void destroy();
+    static void prepare(uint32_t epoch, bool hugePages);
+    static void release(KPDag *dag);
+    static void reset();
+
+private:
+    static void build();
+
+    void clear();
+    bool init(uint32_t epoch, bool hugePages);
+
+    KPCache m_cache;
+    VirtualMemory *m_memory = nullptr;
+};
+
+
+} /* namespace xmrig */
+
+
+#endif /* XMRIG_KP_DAG_H */
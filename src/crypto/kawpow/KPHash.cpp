@@ -107,22 +107,24 @@ static inline uint32_t rotr(uint32_t n, uint32_t c)
 }
 
 
-static inline void random_merge(uint32_t& a, uint32_t b, uint32_t selector)
+static inline void random_merge(uint32_t (&a)[KPHash::LANES], const uint32_t (&b)[KPHash::LANES], uint32_t selector)
 {
     const uint32_t x = (selector >> 16) % 31 + 1;
+
+    // The selector is shared by all lanes, so dispatch once and let the compiler vectorize the lane loops
     switch (selector % 4)
     {
     case 0:
-        a = (a * 33) + b;
+        for (uint32_t l = 0; l < KPHash::LANES; ++l) a[l] = (a[l] * 33) + b[l];
         break;
     case 1:
-        a = (a ^ b) * 33;
+        for (uint32_t l = 0; l < KPHash::LANES; ++l) a[l] = (a[l] ^ b[l]) * 33;
         break;
     case 2:
-        a = rotl(a, x) ^ b;
+        for (uint32_t l = 0; l < KPHash::LANES; ++l) a[l] = ((a[l] << x) | (a[l] >> (32 - x))) ^ b[l];
         break;
     case 3:
-        a = rotr(a, x) ^ b;
+        for (uint32_t l = 0; l < KPHash::LANES; ++l) a[l] = ((a[l] >> x) | (a[l] << (32 - x))) ^ b[l];
         break;
     default:
 #ifdef _MSC_VER
@@ -172,35 +174,50 @@ static inline uint32_t popcount_soft(uint64_t x)
 }
 
 
-static inline uint32_t random_math(uint32_t a, uint32_t b, uint32_t selector, bool has_popcnt)
+static inline void random_math(uint32_t (&out)[KPHash::LANES], const uint32_t (&a)[KPHash::LANES], const uint32_t (&b)[KPHash::LANES], uint32_t selector, bool has_popcnt)
 {
+    constexpr uint32_t LANES = KPHash::LANES;
+
     switch (selector % 11)
     {
     case 0:
-        return a + b;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = a[l] + b[l];
+        break;
     case 1:
-        return a * b;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = a[l] * b[l];
+        break;
     case 2:
-        return (uint64_t(a) * b) >> 32;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = (uint64_t(a[l]) * b[l]) >> 32;
+        break;
     case 3:
-        return (a < b) ? a : b;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = (a[l] < b[l]) ? a[l] : b[l];
+        break;
     case 4:
-        return rotl(a, b);
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = rotl(a[l], b[l]);
+        break;
     case 5:
-        return rotr(a, b);
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = rotr(a[l], b[l]);
+        break;
     case 6:
-        return a & b;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = a[l] & b[l];
+        break;
     case 7:
-        return a | b;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = a[l] | b[l];
+        break;
     case 8:
-        return a ^ b;
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = a[l] ^ b[l];
+        break;
     case 9:
-        return clz(a) + clz(b);
+        for (uint32_t l = 0; l < LANES; ++l) out[l] = clz(a[l]) + clz(b[l]);
+        break;
     case 10:
-        if (has_popcnt)
-            return popcount(a) + popcount(b);
-        else
-            return popcount_soft(a) + popcount_soft(b);
+        if (has_popcnt) {
+            for (uint32_t l = 0; l < LANES; ++l) out[l] = popcount(a[l]) + popcount(b[l]);
+        }
+        else {
+            for (uint32_t l = 0; l < LANES; ++l) out[l] = popcount_soft(a[l]) + popcount_soft(b[l]);
+        }
+        break;
     default:
 #ifdef _MSC_VER
         __assume(false);
@@ -213,9 +230,15 @@ static inline uint32_t random_math(uint32_t a, uint32_t b, uint32_t selector, bo
 
 
 void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const uint8_t (&header_hash)[32], uint64_t nonce, uint32_t (&output)[8], uint32_t (&mix_hash)[8])
+{
+    calculate(light_cache, nullptr, block_height, header_hash, nonce, output, mix_hash);
+}
+
+
+void KPHash::calculate(const KPCache& light_cache, const void* dag, uint32_t block_height, const uint8_t (&header_hash)[32], uint64_t nonce, uint32_t (&output)[8], uint32_t (&mix_hash)[8])
 {
     uint32_t keccak_state[25];
-    uint32_t mix[LANES][REGS];
+    uint32_t mix[REGS][LANES];
 
     memcpy(keccak_state, header_hash, sizeof(header_hash));
     memcpy(keccak_state + 8, &nonce, sizeof(nonce));
@@ -234,7 +257,7 @@ void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const
         jcong = fnv1a(jsr, l);
 
         for (uint32_t r = 0; r < REGS; ++r) {
-            mix[l][r] = kiss99(z1, w1, jsr, jcong);
+            mix[r][l] = kiss99(z1, w1, jsr, jcong);
         }
     }
 
@@ -280,12 +303,22 @@ void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const
     uint32_t jcong0 = jcong;
 
     const bool has_popcnt = Cpu::info()->has(ICpuInfo::FLAG_POPCNT);
+    const uint32_t* l1_cache = light_cache.l1_cache();
+
+    uint32_t data[LANES];
 
     for (uint32_t r = 0; r < ETHASH_ACCESSES; ++r) {
-        uint32_t item_index = (mix[r % LANES][0] % num_items) * 4;
+        const uint32_t item_index = (mix[0][r % LANES] % num_items) * 4;
 
-        node item[4];
-        ethash_calculate_dag_item4_opt(item, item_index, KPCache::num_dataset_parents, &cache);
+        node item_buf[4];
+        const node* item = item_buf;
+
+        if (dag) {
+            item = reinterpret_cast<const node*>(dag) + item_index;
+        }
+        else {
+            ethash_calculate_dag_item4_opt(item_buf, item_index, KPCache::num_dataset_parents, &cache);
+        }
 
         uint32_t dst_counter = 0;
         uint32_t src_counter = 0;
@@ -300,9 +333,10 @@ void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const
                 const uint32_t src = src_seq[(src_counter++) % REGS];
                 const uint32_t dst = dst_seq[(dst_counter++) % REGS];
                 const uint32_t sel = kiss99(z, w, jsr, jcong);
-                for (uint32_t j = 0; j < LANES; ++j) {
-                    random_merge(mix[j][dst], light_cache.l1_cache()[mix[j][src] % KPCache::l1_cache_num_items], sel);
+                for (uint32_t l = 0; l < LANES; ++l) {
+                    data[l] = l1_cache[mix[src][l] % KPCache::l1_cache_num_items];
                 }
+                random_merge(mix[dst], data, sel);
             }
 
             if (i < CNT_MATH)
@@ -318,11 +352,8 @@ void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const
                 const uint32_t dst = dst_seq[(dst_counter++) % REGS];
                 const uint32_t sel2 = kiss99(z, w, jsr, jcong);
 
-                for (size_t l = 0; l < LANES; ++l)
-                {
-                    const uint32_t data = random_math(mix[l][src1], mix[l][src2], sel1, has_popcnt);
-                    random_merge(mix[l][dst], data, sel2);
-                }
+                random_math(data, mix[src1], mix[src2], sel1, has_popcnt);
+                random_merge(mix[dst], data, sel2);
             }
         }
 
@@ -333,11 +364,13 @@ void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const
             sels[i] = kiss99(z, w, jsr, jcong);
         }
 
-        for (uint32_t l = 0; l < LANES; ++l) {
-            const uint32_t offset = ((l ^ r) % LANES) * num_words_per_lane;
-            for (size_t i = 0; i < num_words_per_lane; ++i) {
-                random_merge(mix[l][dsts[i]], ((uint32_t*)item)[offset + i], sels[i]);
+        const uint32_t* item_words = reinterpret_cast<const uint32_t*>(item);
+
+        for (uint32_t i = 0; i < num_words_per_lane; ++i) {
+            for (uint32_t l = 0; l < LANES; ++l) {
+                data[l] = item_words[((l ^ r) % LANES) * num_words_per_lane + i];
             }
+            random_merge(mix[dsts[i]], data, sels[i]);
         }
     }
 
@@ -346,7 +379,7 @@ void KPHash::calculate(const KPCache& light_cache, uint32_t block_height, const
     {
         lane_hash[l] = fnv_offset_basis;
         for (uint32_t i = 0; i < REGS; ++i) {
-            lane_hash[l] = fnv1a(lane_hash[l], mix[l][i]);
+            lane_hash[l] = fnv1a(lane_hash[l], mix[i][l]);
         }
     }
 
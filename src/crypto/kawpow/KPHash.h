@@ -49,6 +49,9 @@ public:
     static constexpr uint32_t LANES         = 16;
 
     static void calculate(const KPCache& light_cache, uint32_t block_height, const uint8_t (&header_hash)[32], uint64_t nonce, uint32_t (&output)[8], uint32_t (&mix_hash)[8]);
+
+    // dag is either the full DAG for the light cache's epoch or nullptr, in which case DAG items are calculated on the fly
+    static void calculate(const KPCache& light_cache, const void* dag, uint32_t block_height, const uint8_t (&header_hash)[32], uint64_t nonce, uint32_t (&output)[8], uint32_t (&mix_hash)[8]);
 };
 
 
@@ -0,0 +1,223 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crypto/kawpow/KPProgram.h"
+#include "crypto/kawpow/KPCache.h"
+#include "crypto/kawpow/KPHash.h"
+
+
+#include <cstring>
+#include <sstream>
+#include <utility>
+
+
+namespace xmrig {
+
+
+typedef struct {
+    uint32_t z, w, jsr, jcong;
+} kiss99_t;
+
+
+static inline uint32_t fnv1a(uint32_t& h, uint32_t d)
+{
+    return h = (h ^ d) * 0x1000193;
+}
+
+
+static inline uint32_t kiss99(kiss99_t& st)
+{
+    st.z = 36969 * (st.z & 65535) + (st.z >> 16);
+    st.w = 18000 * (st.w & 65535) + (st.w >> 16);
+    uint32_t MWC = ((st.z << 16) + st.w);
+    st.jsr ^= (st.jsr << 17);
+    st.jsr ^= (st.jsr >> 13);
+    st.jsr ^= (st.jsr << 5);
+    st.jcong = 69069 * st.jcong + 1234567;
+    return ((MWC ^ st.jcong) + st.jsr);
+}
+
+
+static std::string merge(const std::string& a, const std::string& b, uint32_t r)
+{
+    switch (r % 4)
+    {
+    case 0:
+        return a + " = (" + a + " * 33) + " + b + ";\n";
+    case 1:
+        return a + " = (" + a + " ^ " + b + ") * 33;\n";
+    case 2:
+        return a + " = ROTL32(" + a + ", " + std::to_string(((r >> 16) % 31) + 1) + ") ^ " + b + ";\n";
+    case 3:
+        return a + " = ROTR32(" + a + ", " + std::to_string(((r >> 16) % 31) + 1) + ") ^ " + b + ";\n";
+    }
+    return "#error\n";
+}
+
+
+static std::string math(const std::string& d, const std::string& a, const std::string& b, uint32_t r)
+{
+    switch (r % 11)
+    {
+    case 0:
+        return d + " = " + a + " + " + b + ";\n";
+    case 1:
+        return d + " = " + a + " * " + b + ";\n";
+    case 2:
+        return d + " = mul_hi(" + a + ", " + b + ");\n";
+    case 3:
+        return d + " = min(" + a + ", " + b + ");\n";
+    case 4:
+        return d + " = ROTL32(" + a + ", " + b + " % 32);\n";
+    case 5:
+        return d + " = ROTR32(" + a + ", " + b + " % 32);\n";
+    case 6:
+        return d + " = " + a + " & " + b + ";\n";
+    case 7:
+        return d + " = " + a + " | " + b + ";\n";
+    case 8:
+        return d + " = " + a + " ^ " + b + ";\n";
+    case 9:
+        return d + " = clz(" + a + ") + clz(" + b + ");\n";
+    case 10:
+        return d + " = popcount(" + a + ") + popcount(" + b + ");\n";
+    }
+    return "#error\n";
+}
+
+
+// Plain substring replacement, std::regex on the whole kernel source was the most expensive part of the generator.
+static void replace(std::string &str, const char *what, const std::string &with)
+{
+    const size_t size = strlen(what);
+
+    for (size_t pos = str.find(what); pos != std::string::npos; pos = str.find(what, pos + with.size())) {
+        str.replace(pos, size, with);
+    }
+}
+
+
+} // namespace xmrig
+
+
+#define rnd()       (kiss99(rnd_state))
+#define mix_src()   ("mix[" + std::to_string(rnd() % KPHash::REGS) + "]")
+#define mix_dst()   ("mix[" + std::to_string(mix_seq_dst[(mix_seq_dst_cnt++) % KPHash::REGS]) + "]")
+#define mix_cache() ("mix[" + std::to_string(mix_seq_cache[(mix_seq_cache_cnt++) % KPHash::REGS]) + "]")
+
+
+std::string xmrig::KPProgram::source(const char *kernel, uint64_t period)
+{
+    std::stringstream ret;
+
+    uint32_t seed0 = static_cast<uint32_t>(period);
+    uint32_t seed1 = static_cast<uint32_t>(period >> 32);
+
+    kiss99_t rnd_state;
+    uint32_t fnv_hash = 0x811c9dc5;
+    rnd_state.z = fnv1a(fnv_hash, seed0);
+    rnd_state.w = fnv1a(fnv_hash, seed1);
+    rnd_state.jsr = fnv1a(fnv_hash, seed0);
+    rnd_state.jcong = fnv1a(fnv_hash, seed1);
+
+    // Create a random sequence of mix destinations and cache sources
+    // Merge is a read-modify-write, guaranteeing every mix element is modified every loop
+    // Guarantee no cache load is duplicated and can be optimized away
+    int mix_seq_dst[KPHash::REGS];
+    int mix_seq_cache[KPHash::REGS];
+    int mix_seq_dst_cnt = 0;
+    int mix_seq_cache_cnt = 0;
+
+    for (uint32_t i = 0; i < KPHash::REGS; i++) {
+        mix_seq_dst[i] = i;
+        mix_seq_cache[i] = i;
+    }
+
+    for (int i = KPHash::REGS - 1; i > 0; i--) {
+        int j = 0;
+        j = rnd() % (i + 1);
+        std::swap(mix_seq_dst[i], mix_seq_dst[j]);
+        j = rnd() % (i + 1);
+        std::swap(mix_seq_cache[i], mix_seq_cache[j]);
+    }
+
+    for (int i = 0; (i < KPHash::CNT_CACHE) || (i < KPHash::CNT_MATH); ++i) {
+        if (i < KPHash::CNT_CACHE) {
+            // Cached memory access
+            // lanes access random locations
+            std::string src = mix_cache();
+            std::string dest = mix_dst();
+            uint32_t r = rnd();
+            ret << "offset = " << src << " % PROGPOW_CACHE_WORDS;\n";
+            ret << "data = c_dag[offset];\n";
+            ret << merge(dest, "data", r);
+        }
+
+        if (i < KPHash::CNT_MATH) {
+            // Random Math
+            // Generate 2 unique sources
+            int src_rnd = rnd() % ((KPHash::REGS - 1) * KPHash::REGS);
+            int src1 = src_rnd % KPHash::REGS; // 0 <= src1 < KPHash::REGS
+            int src2 = src_rnd / KPHash::REGS; // 0 <= src2 < KPHash::REGS - 1
+
+            if (src2 >= src1) {
+                ++src2; // src2 is now any reg other than src1
+            }
+
+            std::string src1_str = "mix[" + std::to_string(src1) + "]";
+            std::string src2_str = "mix[" + std::to_string(src2) + "]";
+            uint32_t r1 = rnd();
+            std::string dest = mix_dst();
+            uint32_t r2 = rnd();
+            ret << math("data", src1_str, src2_str, r1);
+            ret << merge(dest, "data", r2);
+        }
+    }
+
+    std::string out(kernel);
+    replace(out, "XMRIG_INCLUDE_PROGPOW_RANDOM_MATH", ret.str());
+    ret.str(std::string());
+
+    ret << merge("mix[0]", "data_dag.s[0]", rnd());
+
+    constexpr size_t num_words_per_lane = 256 / (sizeof(uint32_t) * KPHash::LANES);
+    for (size_t i = 1; i < num_words_per_lane; i++)
+    {
+        std::string dest = mix_dst();
+        uint32_t    r = rnd();
+        ret << merge(dest, "data_dag.s[" + std::to_string(i) + "]", r);
+    }
+
+    replace(out, "XMRIG_INCLUDE_PROGPOW_DATA_LOADS", ret.str());
+
+    return out;
+}
+
+
+uint64_t xmrig::KPProgram::dagElements(uint64_t period)
+{
+    const uint64_t epoch = (period * KPHash::PERIOD_LENGTH) / KPHash::EPOCH_LENGTH;
+
+    return KPCache::dag_size(static_cast<uint32_t>(epoch)) / 256;
+}
+
+
+uint64_t xmrig::KPProgram::period(uint64_t height)
+{
+    return height / KPHash::PERIOD_LENGTH;
+}
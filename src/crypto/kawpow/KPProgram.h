@@ -0,0 +1,49 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_KP_PROGRAM_H
+#define XMRIG_KP_PROGRAM_H
+
+
+#include <cstdint>
+#include <string>
+
+
+namespace xmrig
+{
+
+
+/**
+ * Generator of the per period ProgPoW kernel source shared by the GPU backends.
+ *
+ * Output depends only on the period and the kernel template, so it can be produced (and checked) on CPU without
+ * any GPU runtime, and any number of future periods can be generated ahead of time.
+ */
+class KPProgram
+{
+public:
+    static std::string source(const char *kernel, uint64_t period);
+    static uint64_t dagElements(uint64_t period);
+    static uint64_t period(uint64_t height);
+};
+
+
+} /* namespace xmrig */
+
+
+#endif /* XMRIG_KP_PROGRAM_H */
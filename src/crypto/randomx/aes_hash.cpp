@@ -31,6 +31,7 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <array>
 
 #include "crypto/randomx/aes_hash.hpp"
+#include "backend/cpu/Cpu.h"
 #include "base/tools/Chrono.h"
 #include "crypto/randomx/randomx.h"
 #include "crypto/randomx/soft_aes.h"
@@ -38,13 +39,8 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "crypto/randomx/common.hpp"
 #include "crypto/rx/Profiler.h"
 
-#define AES_HASH_1R_STATE0 0xd7983aad, 0xcc82db47, 0x9fa856de, 0x92b52c0d
-#define AES_HASH_1R_STATE1 0xace78057, 0xf59e125a, 0x15c7b798, 0x338d996e
-#define AES_HASH_1R_STATE2 0xe8a07ce4, 0x5079506b, 0xae62c7d0, 0x6a770017
-#define AES_HASH_1R_STATE3 0x7e994948, 0x79a10005, 0x07ad828d, 0x630a240c
-
-#define AES_HASH_1R_XKEY0 0x06890201, 0x90dc56bf, 0x8b24949f, 0xf6fa8389
-#define AES_HASH_1R_XKEY1 0xed18f99b, 0xee1043c6, 0x51f4e03c, 0x61b263d1
+// Set by SelectHardAESImpl() when the VAES version of hashAndFillAes1Rx4 was the fastest, the rest of the hardware AES functions follow it.
+static bool vaesEnabled = false;
 
 /*
 	Calculate a 512-bit hash of 'input' using 4 lanes of AES.
@@ -60,6 +56,13 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 template<int softAes>
 void hashAes1Rx4(const void *input, size_t inputSize, void *hash) {
+#	ifdef XMRIG_VAES
+	if (!softAes && vaesEnabled) {
+		hashAes1Rx4_vaes256(input, inputSize, hash);
+		return;
+	}
+#	endif
+
 	const uint8_t* inptr = (uint8_t*)input;
 	const uint8_t* inputEnd = inptr + inputSize;
 
@@ -111,11 +114,6 @@ void hashAes1Rx4(const void *input, size_t inputSize, void *hash) {
 template void hashAes1Rx4<false>(const void *input, size_t inputSize, void *hash);
 template void hashAes1Rx4<true>(const void *input, size_t inputSize, void *hash);
 
-#define AES_GEN_1R_KEY0 0xb4f44917, 0xdbb5552b, 0x62716609, 0x6daca553
-#define AES_GEN_1R_KEY1 0x0da1dc4e, 0x1725d378, 0x846a710d, 0x6d7caf07
-#define AES_GEN_1R_KEY2 0x3e20e345, 0xf4c0794f, 0x9f947ec6, 0x3f1262f1
-#define AES_GEN_1R_KEY3 0x49169154, 0x16314c88, 0xb1ba317c, 0x6aef8135
-
 /*
 	Fill 'buffer' with pseudorandom data based on 512-bit 'state'.
 	The state is encrypted using a single AES round per 16 bytes of output
@@ -128,6 +126,13 @@ template void hashAes1Rx4<true>(const void *input, size_t inputSize, void *hash)
 */
 template<int softAes>
 void fillAes1Rx4(void *state, size_t outputSize, void *buffer) {
+#	ifdef XMRIG_VAES
+	if (!softAes && vaesEnabled) {
+		fillAes1Rx4_vaes256(state, outputSize, buffer);
+		return;
+	}
+#	endif
+
 	const uint8_t* outptr = (uint8_t*)buffer;
 	const uint8_t* outputEnd = outptr + outputSize;
 
@@ -172,6 +177,13 @@ alignas(16) static const randomx::Instruction inst_mask[2] = { inst, inst };
 
 template<int softAes>
 void fillAes4Rx4(void *state, size_t outputSize, void *buffer) {
+#	ifdef XMRIG_VAES
+	if (!softAes && vaesEnabled) {
+		fillAes4Rx4_vaes256(state, outputSize, buffer);
+		return;
+	}
+#	endif
+
 	const uint8_t* outptr = (uint8_t*)buffer;
 	const uint8_t* outputEnd = outptr + outputSize;
 
@@ -383,26 +395,25 @@ template void hashAndFillAes1Rx4<2,2>(void* scratchpad, size_t scratchpadSize, v
 template void hashAndFillAes1Rx4<2,4>(void* scratchpad, size_t scratchpadSize, void* hash, void* fill_state);
 
 hashAndFillAes1Rx4_impl* softAESImpl = &hashAndFillAes1Rx4<1,1>;
+hashAndFillAes1Rx4_impl* hardAESImpl = &hashAndFillAes1Rx4<0,2>;
 
-void SelectSoftAESImpl(size_t threadsCount)
+template<size_t N>
+static size_t SelectFastestImpl(const std::array<hashAndFillAes1Rx4_impl *, N> &impl, size_t threadsCount, size_t scratchpadSize)
 {
   constexpr uint64_t test_length_ms = 100;
-  const std::array<hashAndFillAes1Rx4_impl *, 4> impl = {
-    &hashAndFillAes1Rx4<1,1>,
-    &hashAndFillAes1Rx4<2,1>,
-    &hashAndFillAes1Rx4<2,2>,
-    &hashAndFillAes1Rx4<2,4>,
-  };
   size_t fast_idx = 0;
   double fast_speed = 0.0;
   for (size_t run = 0; run < 3; ++run) {
     for (size_t i = 0; i < impl.size(); ++i) {
+      if (!impl[i]) {
+        continue;
+      }
       const double t1 = xmrig::Chrono::highResolutionMSecs();
       std::vector<uint32_t> count(threadsCount, 0);
       std::vector<std::thread> threads;
       for (size_t t = 0; t < threadsCount; ++t) {
         threads.emplace_back([&, t]() {
-          std::vector<uint8_t> scratchpad(10 * 1024);
+          std::vector<uint8_t> scratchpad(scratchpadSize);
           alignas(16) uint8_t hash[64] = {};
           alignas(16) uint8_t state[64] = {};
           do {
@@ -424,5 +435,37 @@ void SelectSoftAESImpl(size_t threadsCount)
       }
     }
   }
-  softAESImpl = impl[fast_idx];
+  return fast_idx;
+}
+
+void SelectSoftAESImpl(size_t threadsCount)
+{
+  const std::array<hashAndFillAes1Rx4_impl *, 4> impl = {
+    &hashAndFillAes1Rx4<1,1>,
+    &hashAndFillAes1Rx4<2,1>,
+    &hashAndFillAes1Rx4<2,2>,
+    &hashAndFillAes1Rx4<2,4>,
+  };
+  softAESImpl = impl[SelectFastestImpl(impl, threadsCount, 10 * 1024)];
+}
+
+void SelectHardAESImpl(size_t threadsCount)
+{
+#ifdef XMRIG_VAES
+  const auto info = xmrig::Cpu::info();
+  if (!info->hasVAES()) {
+    return;
+  }
+  // VAES-512 only pays off where hash and fill lanes can share one register, the other functions stay at 256 bits.
+  const std::array<hashAndFillAes1Rx4_impl *, 3> impl = {
+    &hashAndFillAes1Rx4<0,2>,
+    &hashAndFillAes1Rx4_vaes256,
+    info->has(xmrig::ICpuInfo::FLAG_AVX512F) ? &hashAndFillAes1Rx4_vaes512 : nullptr,
+  };
+  // Full size scratchpad, so the measurement includes the same cache traffic as real hashing.
+  hardAESImpl = impl[SelectFastestImpl(impl, threadsCount, 2 * 1024 * 1024)];
+  vaesEnabled = hardAESImpl != impl[0];
+#else
+  (void) threadsCount;
+#endif
 }
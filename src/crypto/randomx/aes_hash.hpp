@@ -30,16 +30,36 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cstddef>
 
+#define AES_HASH_1R_STATE0 0xd7983aad, 0xcc82db47, 0x9fa856de, 0x92b52c0d
+#define AES_HASH_1R_STATE1 0xace78057, 0xf59e125a, 0x15c7b798, 0x338d996e
+#define AES_HASH_1R_STATE2 0xe8a07ce4, 0x5079506b, 0xae62c7d0, 0x6a770017
+#define AES_HASH_1R_STATE3 0x7e994948, 0x79a10005, 0x07ad828d, 0x630a240c
+
+#define AES_HASH_1R_XKEY0 0x06890201, 0x90dc56bf, 0x8b24949f, 0xf6fa8389
+#define AES_HASH_1R_XKEY1 0xed18f99b, 0xee1043c6, 0x51f4e03c, 0x61b263d1
+
+#define AES_GEN_1R_KEY0 0xb4f44917, 0xdbb5552b, 0x62716609, 0x6daca553
+#define AES_GEN_1R_KEY1 0x0da1dc4e, 0x1725d378, 0x846a710d, 0x6d7caf07
+#define AES_GEN_1R_KEY2 0x3e20e345, 0xf4c0794f, 0x9f947ec6, 0x3f1262f1
+#define AES_GEN_1R_KEY3 0x49169154, 0x16314c88, 0xb1ba317c, 0x6aef8135
+
 typedef void (hashAndFillAes1Rx4_impl)(void *scratchpad, size_t scratchpadSize, void *hash, void* fill_state);
 
 extern hashAndFillAes1Rx4_impl* softAESImpl;
+extern hashAndFillAes1Rx4_impl* hardAESImpl;
 
 inline hashAndFillAes1Rx4_impl* GetSoftAESImpl()
 {
   return softAESImpl;
 }
 
+inline hashAndFillAes1Rx4_impl* GetHardAESImpl()
+{
+  return hardAESImpl;
+}
+
 void SelectSoftAESImpl(size_t threadsCount);
+void SelectHardAESImpl(size_t threadsCount);
 
 template<int softAes>
 void hashAes1Rx4(const void *input, size_t inputSize, void *hash);
@@ -52,3 +72,11 @@ void fillAes4Rx4(void *state, size_t outputSize, void *buffer);
 
 template<int softAes, int unroll>
 void hashAndFillAes1Rx4(void *scratchpad, size_t scratchpadSize, void *hash, void* fill_state);
+
+#ifdef XMRIG_VAES
+void hashAes1Rx4_vaes256(const void *input, size_t inputSize, void *hash);
+void fillAes1Rx4_vaes256(void *state, size_t outputSize, void *buffer);
+void fillAes4Rx4_vaes256(void *state, size_t outputSize, void *buffer);
+void hashAndFillAes1Rx4_vaes256(void *scratchpad, size_t scratchpadSize, void *hash, void* fill_state);
+void hashAndFillAes1Rx4_vaes512(void *scratchpad, size_t scratchpadSize, void *hash, void* fill_state);
+#endif
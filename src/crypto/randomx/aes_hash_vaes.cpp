@@ -0,0 +1,236 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crypto/randomx/aes_hash.hpp"
+#include "crypto/randomx/instruction.hpp"
+#include "crypto/randomx/intrin_portable.h"
+#include "crypto/randomx/randomx.h"
+#include "crypto/rx/Profiler.h"
+
+
+#include <immintrin.h>
+
+
+/*
+	VAES-256 versions of the functions from aes_hash.cpp, two AES lanes per instruction.
+
+	VAES applies the same round type (encryption or decryption) to both halves of a register, so lanes are regrouped:
+	lanes 0 and 2 always use one round type and lanes 1 and 3 use the other one.
+*/
+
+
+static inline __m256i loadPairs02(const void *ptr)
+{
+	const __m256i a = _mm256_loadu_si256((const __m256i*)ptr + 0);
+	const __m256i b = _mm256_loadu_si256((const __m256i*)ptr + 1);
+
+	return _mm256_permute2x128_si256(a, b, 0x20);
+}
+
+
+static inline __m256i loadPairs13(const void *ptr)
+{
+	const __m256i a = _mm256_loadu_si256((const __m256i*)ptr + 0);
+	const __m256i b = _mm256_loadu_si256((const __m256i*)ptr + 1);
+
+	return _mm256_permute2x128_si256(a, b, 0x31);
+}
+
+
+static inline void storePairs(void *ptr, __m256i lanes02, __m256i lanes13)
+{
+	_mm256_storeu_si256((__m256i*)ptr + 0, _mm256_permute2x128_si256(lanes02, lanes13, 0x20));
+	_mm256_storeu_si256((__m256i*)ptr + 1, _mm256_permute2x128_si256(lanes02, lanes13, 0x31));
+}
+
+
+void hashAes1Rx4_vaes256(const void *input, size_t inputSize, void *hash)
+{
+	const uint8_t* inptr = (const uint8_t*)input;
+	const uint8_t* inputEnd = inptr + inputSize;
+
+	__m256i state02 = _mm256_set_m128i(rx_set_int_vec_i128(AES_HASH_1R_STATE2), rx_set_int_vec_i128(AES_HASH_1R_STATE0));
+	__m256i state13 = _mm256_set_m128i(rx_set_int_vec_i128(AES_HASH_1R_STATE3), rx_set_int_vec_i128(AES_HASH_1R_STATE1));
+
+	while (inptr < inputEnd) {
+		state02 = _mm256_aesenc_epi128(state02, loadPairs02(inptr));
+		state13 = _mm256_aesdec_epi128(state13, loadPairs13(inptr));
+
+		inptr += 64;
+	}
+
+	const __m256i xkey0 = _mm256_broadcastsi128_si256(rx_set_int_vec_i128(AES_HASH_1R_XKEY0));
+	const __m256i xkey1 = _mm256_broadcastsi128_si256(rx_set_int_vec_i128(AES_HASH_1R_XKEY1));
+
+	state02 = _mm256_aesenc_epi128(state02, xkey0);
+	state13 = _mm256_aesdec_epi128(state13, xkey0);
+
+	state02 = _mm256_aesenc_epi128(state02, xkey1);
+	state13 = _mm256_aesdec_epi128(state13, xkey1);
+
+	storePairs(hash, state02, state13);
+}
+
+
+void fillAes1Rx4_vaes256(void *state, size_t outputSize, void *buffer)
+{
+	uint8_t* outptr = (uint8_t*)buffer;
+	const uint8_t* outputEnd = outptr + outputSize;
+
+	const __m256i key02 = _mm256_set_m128i(rx_set_int_vec_i128(AES_GEN_1R_KEY2), rx_set_int_vec_i128(AES_GEN_1R_KEY0));
+	const __m256i key13 = _mm256_set_m128i(rx_set_int_vec_i128(AES_GEN_1R_KEY3), rx_set_int_vec_i128(AES_GEN_1R_KEY1));
+
+	__m256i state02 = loadPairs02(state);
+	__m256i state13 = loadPairs13(state);
+
+	while (outptr < outputEnd) {
+		state02 = _mm256_aesdec_epi128(state02, key02);
+		state13 = _mm256_aesenc_epi128(state13, key13);
+
+		storePairs(outptr, state02, state13);
+
+		outptr += 64;
+	}
+
+	storePairs(state, state02, state13);
+}
+
+
+void fillAes4Rx4_vaes256(void *state, size_t outputSize, void *buffer)
+{
+	uint8_t* outptr = (uint8_t*)buffer;
+	const uint8_t* outputEnd = outptr + outputSize;
+
+	// Lanes 0 and 1 use keys 0-3, lanes 2 and 3 use keys 4-7.
+	const rx_vec_i128 *keys = RandomX_CurrentConfig.fillAes4Rx4_Key;
+
+	const __m256i key04 = _mm256_set_m128i(keys[4], keys[0]);
+	const __m256i key15 = _mm256_set_m128i(keys[5], keys[1]);
+	const __m256i key26 = _mm256_set_m128i(keys[6], keys[2]);
+	const __m256i key37 = _mm256_set_m128i(keys[7], keys[3]);
+
+	__m256i state02 = loadPairs02(state);
+	__m256i state13 = loadPairs13(state);
+
+#define TRANSFORM do { \
+	state02 = _mm256_aesdec_epi128(state02, key04); \
+	state13 = _mm256_aesenc_epi128(state13, key04); \
+	state02 = _mm256_aesdec_epi128(state02, key15); \
+	state13 = _mm256_aesenc_epi128(state13, key15); \
+	state02 = _mm256_aesdec_epi128(state02, key26); \
+	state13 = _mm256_aesenc_epi128(state13, key26); \
+	state02 = _mm256_aesdec_epi128(state02, key37); \
+	state13 = _mm256_aesenc_epi128(state13, key37); \
+} while (0)
+
+	for (int i = 0; i < 2; ++i, outptr += 64) {
+		TRANSFORM;
+		storePairs(outptr, state02, state13);
+	}
+
+	constexpr randomx::Instruction inst{ 0xFF, 7, 7, 0xFF, 0xFFFFFFFFU };
+	alignas(16) const randomx::Instruction inst_mask[2] = { inst, inst };
+
+	const __m256i mask = _mm256_broadcastsi128_si256(_mm_load_si128((const __m128i*)inst_mask));
+
+	while (outptr < outputEnd) {
+		TRANSFORM;
+		storePairs(outptr, _mm256_and_si256(state02, mask), _mm256_and_si256(state13, mask));
+		outptr += 64;
+	}
+
+#undef TRANSFORM
+}
+
+
+void hashAndFillAes1Rx4_vaes256(void *scratchpad, size_t scratchpadSize, void *hash, void* fill_state)
+{
+	PROFILE_SCOPE(RandomX_AES);
+
+	uint8_t* scratchpadPtr = (uint8_t*)scratchpad;
+	const uint8_t* scratchpadEnd = scratchpadPtr + scratchpadSize;
+
+	// Hash and fill lanes share registers without any shuffling, because hash lane N uses the opposite round type to fill lane N:
+	// enc01 = { hash0, fill1 }, dec01 = { fill0, hash1 }, enc23 = { hash2, fill3 }, dec23 = { fill2, hash3 }
+	const __m256i hash01 = _mm256_set_m128i(rx_set_int_vec_i128(AES_HASH_1R_STATE1), rx_set_int_vec_i128(AES_HASH_1R_STATE0));
+	const __m256i hash23 = _mm256_set_m128i(rx_set_int_vec_i128(AES_HASH_1R_STATE3), rx_set_int_vec_i128(AES_HASH_1R_STATE2));
+	const __m256i fill01 = _mm256_loadu_si256((const __m256i*)fill_state + 0);
+	const __m256i fill23 = _mm256_loadu_si256((const __m256i*)fill_state + 1);
+
+	__m256i enc01 = _mm256_blend_epi32(hash01, fill01, 0xF0);
+	__m256i dec01 = _mm256_blend_epi32(hash01, fill01, 0x0F);
+	__m256i enc23 = _mm256_blend_epi32(hash23, fill23, 0xF0);
+	__m256i dec23 = _mm256_blend_epi32(hash23, fill23, 0x0F);
+
+	const __m256i key01 = _mm256_set_m128i(rx_set_int_vec_i128(AES_GEN_1R_KEY1), rx_set_int_vec_i128(AES_GEN_1R_KEY0));
+	const __m256i key23 = _mm256_set_m128i(rx_set_int_vec_i128(AES_GEN_1R_KEY3), rx_set_int_vec_i128(AES_GEN_1R_KEY2));
+
+	constexpr int PREFETCH_DISTANCE = 7168;
+	const char* prefetchPtr = ((const char*)scratchpad) + PREFETCH_DISTANCE;
+	scratchpadEnd -= PREFETCH_DISTANCE;
+
+	for (int i = 0; i < 2; ++i) {
+		//process 64 bytes at a time in 4 lanes
+		while (scratchpadPtr < scratchpadEnd) {
+#define HASH_AND_FILL(k) { \
+			const __m256i in01 = _mm256_loadu_si256((const __m256i*)scratchpadPtr + k * 2 + 0); \
+			const __m256i in23 = _mm256_loadu_si256((const __m256i*)scratchpadPtr + k * 2 + 1); \
+			enc01 = _mm256_aesenc_epi128(enc01, _mm256_blend_epi32(in01, key01, 0xF0)); \
+			dec01 = _mm256_aesdec_epi128(dec01, _mm256_blend_epi32(in01, key01, 0x0F)); \
+			enc23 = _mm256_aesenc_epi128(enc23, _mm256_blend_epi32(in23, key23, 0xF0)); \
+			dec23 = _mm256_aesdec_epi128(dec23, _mm256_blend_epi32(in23, key23, 0x0F)); \
+			_mm256_storeu_si256((__m256i*)scratchpadPtr + k * 2 + 0, _mm256_blend_epi32(dec01, enc01, 0xF0)); \
+			_mm256_storeu_si256((__m256i*)scratchpadPtr + k * 2 + 1, _mm256_blend_epi32(dec23, enc23, 0xF0)); \
+		}
+
+			HASH_AND_FILL(0);
+			HASH_AND_FILL(1);
+
+			rx_prefetch_t0(prefetchPtr);
+			rx_prefetch_t0(prefetchPtr + 64);
+
+			scratchpadPtr += 128;
+			prefetchPtr += 128;
+		}
+		prefetchPtr = (const char*) scratchpad;
+		scratchpadEnd += PREFETCH_DISTANCE;
+	}
+
+#undef HASH_AND_FILL
+
+	_mm256_storeu_si256((__m256i*)fill_state + 0, _mm256_blend_epi32(dec01, enc01, 0xF0));
+	_mm256_storeu_si256((__m256i*)fill_state + 1, _mm256_blend_epi32(dec23, enc23, 0xF0));
+
+	//two extra rounds to achieve full diffusion, fill lanes are not needed anymore
+	const __m256i xkey0 = _mm256_broadcastsi128_si256(rx_set_int_vec_i128(AES_HASH_1R_XKEY0));
+	const __m256i xkey1 = _mm256_broadcastsi128_si256(rx_set_int_vec_i128(AES_HASH_1R_XKEY1));
+
+	enc01 = _mm256_aesenc_epi128(enc01, xkey0);
+	dec01 = _mm256_aesdec_epi128(dec01, xkey0);
+	enc23 = _mm256_aesenc_epi128(enc23, xkey0);
+	dec23 = _mm256_aesdec_epi128(dec23, xkey0);
+
+	enc01 = _mm256_aesenc_epi128(enc01, xkey1);
+	dec01 = _mm256_aesdec_epi128(dec01, xkey1);
+	enc23 = _mm256_aesenc_epi128(enc23, xkey1);
+	dec23 = _mm256_aesdec_epi128(dec23, xkey1);
+
+	//output hash
+	_mm256_storeu_si256((__m256i*)hash + 0, _mm256_blend_epi32(enc01, dec01, 0xF0));
+	_mm256_storeu_si256((__m256i*)hash + 1, _mm256_blend_epi32(enc23, dec23, 0xF0));
+}
@@ -0,0 +1,112 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crypto/randomx/aes_hash.hpp"
+#include "crypto/randomx/intrin_portable.h"
+#include "crypto/rx/Profiler.h"
+
+
+#include <immintrin.h>
+
+
+static inline __m512i set4(rx_vec_i128 x0, rx_vec_i128 x1, rx_vec_i128 x2, rx_vec_i128 x3)
+{
+	__m512i out = _mm512_maskz_broadcast_i32x4(0x000F, x0);
+	out = _mm512_mask_broadcast_i32x4(out, 0x00F0, x1);
+	out = _mm512_mask_broadcast_i32x4(out, 0x0F00, x2);
+
+	return _mm512_mask_broadcast_i32x4(out, 0xF000, x3);
+}
+
+
+/*
+	VAES-512 version of hashAndFillAes1Rx4, all 8 lanes in two registers:
+	enc = { hash0, fill1, hash2, fill3 }, dec = { fill0, hash1, fill2, hash3 }
+
+	Lanes 1 and 3 are selected with mask 0xCC (64-bit elements 2, 3, 6 and 7).
+*/
+void hashAndFillAes1Rx4_vaes512(void *scratchpad, size_t scratchpadSize, void *hash, void* fill_state)
+{
+	PROFILE_SCOPE(RandomX_AES);
+
+	uint8_t* scratchpadPtr = (uint8_t*)scratchpad;
+	const uint8_t* scratchpadEnd = scratchpadPtr + scratchpadSize;
+
+	const __m512i hashState = set4(
+		rx_set_int_vec_i128(AES_HASH_1R_STATE0),
+		rx_set_int_vec_i128(AES_HASH_1R_STATE1),
+		rx_set_int_vec_i128(AES_HASH_1R_STATE2),
+		rx_set_int_vec_i128(AES_HASH_1R_STATE3)
+	);
+
+	const __m512i fillState = _mm512_loadu_si512(fill_state);
+
+	__m512i enc = _mm512_mask_blend_epi64(0xCC, hashState, fillState);
+	__m512i dec = _mm512_mask_blend_epi64(0xCC, fillState, hashState);
+
+	const __m512i key = set4(
+		rx_set_int_vec_i128(AES_GEN_1R_KEY0),
+		rx_set_int_vec_i128(AES_GEN_1R_KEY1),
+		rx_set_int_vec_i128(AES_GEN_1R_KEY2),
+		rx_set_int_vec_i128(AES_GEN_1R_KEY3)
+	);
+
+	constexpr int PREFETCH_DISTANCE = 7168;
+	const char* prefetchPtr = ((const char*)scratchpad) + PREFETCH_DISTANCE;
+	scratchpadEnd -= PREFETCH_DISTANCE;
+
+	for (int i = 0; i < 2; ++i) {
+		//process 64 bytes at a time in 4 lanes
+		while (scratchpadPtr < scratchpadEnd) {
+#define HASH_AND_FILL(k) { \
+			const __m512i in = _mm512_loadu_si512(scratchpadPtr + k * 64); \
+			enc = _mm512_aesenc_epi128(enc, _mm512_mask_blend_epi64(0xCC, in, key)); \
+			dec = _mm512_aesdec_epi128(dec, _mm512_mask_blend_epi64(0x33, in, key)); \
+			_mm512_storeu_si512(scratchpadPtr + k * 64, _mm512_mask_blend_epi64(0xCC, dec, enc)); \
+		}
+
+			HASH_AND_FILL(0);
+			HASH_AND_FILL(1);
+
+			rx_prefetch_t0(prefetchPtr);
+			rx_prefetch_t0(prefetchPtr + 64);
+
+			scratchpadPtr += 128;
+			prefetchPtr += 128;
+		}
+		prefetchPtr = (const char*) scratchpad;
+		scratchpadEnd += PREFETCH_DISTANCE;
+	}
+
+#undef HASH_AND_FILL
+
+	_mm512_storeu_si512(fill_state, _mm512_mask_blend_epi64(0xCC, dec, enc));
+
+	//two extra rounds to achieve full diffusion, fill lanes are not needed anymore
+	const __m512i xkey0 = _mm512_maskz_broadcast_i32x4(0xFFFF, rx_set_int_vec_i128(AES_HASH_1R_XKEY0));
+	const __m512i xkey1 = _mm512_maskz_broadcast_i32x4(0xFFFF, rx_set_int_vec_i128(AES_HASH_1R_XKEY1));
+
+	enc = _mm512_aesenc_epi128(enc, xkey0);
+	dec = _mm512_aesdec_epi128(dec, xkey0);
+
+	enc = _mm512_aesenc_epi128(enc, xkey1);
+	dec = _mm512_aesdec_epi128(dec, xkey1);
+
+	//output hash
+	_mm512_storeu_si512(hash, _mm512_mask_blend_epi64(0xCC, enc, dec));
+}
@@ -22,6 +22,7 @@
 #include "backend/cpu/CpuConfig.h"
 #include "backend/cpu/CpuThreads.h"
 #include "crypto/rx/RxConfig.h"
+#include "crypto/rx/RxDataset.h"
 #include "crypto/rx/RxQueue.h"
 #include "crypto/randomx/randomx.h"
 #include "crypto/randomx/aes_hash.hpp"
@@ -61,12 +62,24 @@ xmrig::HugePagesInfo xmrig::Rx::hugePages()
 }
 
 
+xmrig::RxDataset *xmrig::Rx::acquire(const Job &job, uint32_t nodeId)
+{
+    return d_ptr->queue.acquire(job, nodeId);
+}
+
+
 xmrig::RxDataset *xmrig::Rx::dataset(const Job &job, uint32_t nodeId)
 {
     return d_ptr->queue.dataset(job, nodeId);
 }
 
 
+uint64_t xmrig::Rx::initTime()
+{
+    return d_ptr->queue.initTime();
+}
+
+
 void xmrig::Rx::destroy()
 {
 #   ifdef XMRIG_FEATURE_MSR
@@ -144,6 +157,9 @@ bool xmrig::Rx::init(const T &seed, const RxConfig &config, const CpuConfig &cpu
         if (!cpu.isHwAES()) {
             SelectSoftAESImpl(cpu.threads().get(seed.algorithm()).count());
         }
+        else {
+            SelectHardAESImpl(cpu.threads().get(seed.algorithm()).count());
+        }
 
 #       if defined(XMRIG_FEATURE_SSE4_1)
         if (Cpu::info()->has(ICpuInfo::FLAG_SSE41)) {
@@ -160,13 +176,13 @@ bool xmrig::Rx::init(const T &seed, const RxConfig &config, const CpuConfig &cpu
         osInitialized = true;
     }
 
+    d_ptr->queue.configure(config);
+
     if (isReady(seed)) {
         return true;
     }
 
-    d_ptr->queue.enqueue(seed, config.nodeset(), config.threads(cpu.limit()), cpu.isHugePages(), config.isOneGbPages(), config.mode(), cpu.priority());
-
-    return false;
+    return d_ptr->queue.enqueue(seed, config.nodeset(), config.threads(cpu.limit()), cpu.isHugePages(), config.isOneGbPages(), config.mode(), cpu.priority(), config.datasetCache());
 }
 
 
@@ -177,6 +193,31 @@ bool xmrig::Rx::isReady(const T &seed)
 }
 
 
+template<typename T>
+bool xmrig::Rx::isStandby(const T &seed)
+{
+    return d_ptr->queue.isStandby(seed);
+}
+
+
+void xmrig::Rx::prefetch(const Job &job, const RxConfig &config, const CpuConfig &cpu)
+{
+    if (!config.isDoubleBuffer() || job.algorithm().family() != Algorithm::RANDOM_X || job.nextSeed().empty() || job.nextSeed() == job.seed()) {
+        return;
+    }
+
+    d_ptr->queue.prefetch(RxSeed(job.algorithm(), job.nextSeed()), config.nodeset(), config.threads(cpu.limit()), cpu.isHugePages(), config.isOneGbPages(), config.mode(), cpu.priority(), config.datasetCache());
+}
+
+
+void xmrig::Rx::release(RxDataset *dataset)
+{
+    if (dataset) {
+        dataset->release();
+    }
+}
+
+
 #ifdef XMRIG_FEATURE_MSR
 bool xmrig::Rx::isMSR()
 {
@@ -190,8 +231,10 @@ namespace xmrig {
 
 template bool Rx::init(const RxSeed &seed, const RxConfig &config, const CpuConfig &cpu);
 template bool Rx::isReady(const RxSeed &seed);
+template bool Rx::isStandby(const RxSeed &seed);
 template bool Rx::init(const Job &seed, const RxConfig &config, const CpuConfig &cpu);
 template bool Rx::isReady(const Job &seed);
+template bool Rx::isStandby(const Job &seed);
 
 
 } // namespace xmrig
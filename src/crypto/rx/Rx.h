@@ -46,11 +46,16 @@ class Rx
 {
 public:
     static HugePagesInfo hugePages();
+    static RxDataset *acquire(const Job &job, uint32_t nodeId);
     static RxDataset *dataset(const Job &job, uint32_t nodeId);
+    static uint64_t initTime();
     static void destroy();
     static void init(IRxListener *listener);
     template<typename T> static bool init(const T &seed, const RxConfig &config, const CpuConfig &cpu);
     template<typename T> static bool isReady(const T &seed);
+    template<typename T> static bool isStandby(const T &seed);
+    static void prefetch(const Job &job, const RxConfig &config, const CpuConfig &cpu);
+    static void release(RxDataset *dataset);
 
 #   ifdef XMRIG_FEATURE_MSR
     static bool isMSR();
@@ -43,6 +43,7 @@ public:
 
     inline bool isReady(const Job &job) const   { return m_ready && m_seed == job; }
     inline RxDataset *dataset() const           { return m_dataset; }
+    inline const RxSeed &seed() const           { return m_seed; }
     inline void deleteDataset()                 { delete m_dataset; m_dataset = nullptr; }
 
 
@@ -77,11 +78,11 @@ public:
     }
 
 
-    inline void initDataset(uint32_t threads, int priority)
+    inline void initDataset(uint32_t threads, int priority, const String &datasetCache, const std::atomic<bool> *abort)
     {
         const uint64_t ts = Chrono::steadyMSecs();
 
-        m_ready = m_dataset->init(m_seed.data(), threads, priority);
+        m_ready = m_dataset->init(m_seed, threads, priority, datasetCache, abort);
 
         if (m_ready) {
             LOG_INFO("%s" GREEN_BOLD("dataset ready") BLACK_BOLD(" (%" PRIu64 " ms)"), Tags::randomx(), Chrono::steadyMSecs() - ts);
@@ -141,6 +142,12 @@ bool xmrig::RxBasicStorage::isAllocated() const
 }
 
 
+bool xmrig::RxBasicStorage::isUsed() const
+{
+    return d_ptr->dataset() && d_ptr->dataset()->isUsed();
+}
+
+
 xmrig::HugePagesInfo xmrig::RxBasicStorage::hugePages() const
 {
     if (!d_ptr->dataset()) {
@@ -161,7 +168,7 @@ xmrig::RxDataset *xmrig::RxBasicStorage::dataset(const Job &job, uint32_t) const
 }
 
 
-void xmrig::RxBasicStorage::init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority)
+void xmrig::RxBasicStorage::init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache, const std::atomic<bool> *abort)
 {
     d_ptr->setSeed(seed);
 
@@ -169,5 +176,13 @@ void xmrig::RxBasicStorage::init(const RxSeed &seed, uint32_t threads, bool huge
         return;
     }
 
-    d_ptr->initDataset(threads, priority);
+    d_ptr->initDataset(threads, priority, datasetCache, abort);
+}
+
+
+void xmrig::RxBasicStorage::saveSnapshot(const String &dir)
+{
+    if (d_ptr->dataset()) {
+        d_ptr->dataset()->saveSnapshot(dir, d_ptr->seed());
+    }
 }
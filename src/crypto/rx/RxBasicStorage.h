@@ -41,9 +41,11 @@ public:
 
 protected:
     bool isAllocated() const override;
+    bool isUsed() const override;
     HugePagesInfo hugePages() const override;
     RxDataset *dataset(const Job &job, uint32_t nodeId) const override;
-    void init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority) override;
+    void init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache, const std::atomic<bool> *abort) override;
+    void saveSnapshot(const String &dir) override;
 
 private:
     RxBasicStoragePrivate *d_ptr;
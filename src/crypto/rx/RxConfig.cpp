@@ -43,6 +43,9 @@ const char *RxConfig::kRdmsr                    = "rdmsr";
 const char *RxConfig::kWrmsr                    = "wrmsr";
 const char *RxConfig::kScratchpadPrefetchMode   = "scratchpad_prefetch_mode";
 const char *RxConfig::kCacheQoS                 = "cache_qos";
+const char *RxConfig::kDoubleBuffer             = "double-buffer";
+const char *RxConfig::kDatasetCache             = "dataset-cache";
+const char *RxConfig::kMemoryBudget             = "memory-budget";
 
 #ifdef XMRIG_FEATURE_HWLOC
 const char *RxConfig::kNUMA                     = "numa";
@@ -87,7 +90,10 @@ bool xmrig::RxConfig::read(const rapidjson::Value &value)
         readMSR(Json::getValue(value, kWrmsr));
 #       endif
 
-        m_cacheQoS = Json::getBool(value, kCacheQoS, m_cacheQoS);
+        m_cacheQoS     = Json::getBool(value, kCacheQoS, m_cacheQoS);
+        m_doubleBuffer = Json::getBool(value, kDoubleBuffer, m_doubleBuffer);
+        m_datasetCache = Json::getString(value, kDatasetCache);
+        m_memoryBudget = Json::getUint64(value, kMemoryBudget, m_memoryBudget);
 
 #       ifdef XMRIG_OS_LINUX
         m_oneGbPages = Json::getBool(value, kOneGbPages, m_oneGbPages);
@@ -158,6 +164,9 @@ rapidjson::Value xmrig::RxConfig::toJSON(rapidjson::Document &doc) const
 #   endif
 
     obj.AddMember(StringRef(kCacheQoS), m_cacheQoS, allocator);
+    obj.AddMember(StringRef(kDoubleBuffer), m_doubleBuffer, allocator);
+    obj.AddMember(StringRef(kDatasetCache), m_datasetCache.toJSON(), allocator);
+    obj.AddMember(StringRef(kMemoryBudget), m_memoryBudget, allocator);
 
 #   ifdef XMRIG_FEATURE_HWLOC
     if (!m_nodeset.empty()) {
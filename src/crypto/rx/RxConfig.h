@@ -21,6 +21,7 @@
 
 
 #include "3rdparty/rapidjson/fwd.h"
+#include "base/tools/String.h"
 
 
 #ifdef XMRIG_FEATURE_MSR
@@ -53,9 +54,12 @@ public:
     };
 
     static const char *kCacheQoS;
+    static const char *kDatasetCache;
+    static const char *kDoubleBuffer;
     static const char *kField;
     static const char *kInit;
     static const char *kInitAVX2;
+    static const char *kMemoryBudget;
     static const char *kMode;
     static const char *kOneGbPages;
     static const char *kRdmsr;
@@ -83,7 +87,10 @@ public:
     inline bool rdmsr() const           { return m_rdmsr; }
     inline bool wrmsr() const           { return m_wrmsr; }
     inline bool cacheQoS() const        { return m_cacheQoS; }
+    inline bool isDoubleBuffer() const  { return m_doubleBuffer; }
+    inline const String &datasetCache() const { return m_datasetCache; }
     inline Mode mode() const            { return m_mode; }
+    inline uint64_t memoryBudget() const { return m_memoryBudget; }
 
     inline ScratchpadPrefetchMode scratchpadPrefetchMode() const { return m_scratchpadPrefetchMode; }
 
@@ -104,6 +111,9 @@ private:
 #   endif
 
     bool m_cacheQoS = false;
+    bool m_doubleBuffer = false;
+    String m_datasetCache;
+    uint64_t m_memoryBudget = 0;
 
     static Mode readMode(const rapidjson::Value &value);
 
@@ -22,12 +22,16 @@
 #include "base/io/log/Log.h"
 #include "base/io/log/Tags.h"
 #include "base/kernel/Platform.h"
+#include "base/tools/String.h"
 #include "crypto/common/VirtualMemory.h"
 #include "crypto/randomx/randomx.h"
 #include "crypto/rx/RxAlgo.h"
 #include "crypto/rx/RxCache.h"
+#include "crypto/rx/RxDatasetSnapshot.h"
+#include "crypto/rx/RxSeed.h"
 
 
+#include <algorithm>
 #include <thread>
 #include <uv.h>
 
@@ -35,10 +39,12 @@
 namespace xmrig {
 
 
-static void init_dataset_wrapper(randomx_dataset *dataset, randomx_cache *cache, uint32_t startItem, uint32_t itemCount, int priority)
-{
-    Platform::setThreadPriority(priority);
+// Multiple of 5, the AVX2 dataset init calculates 5 items at once.
+static constexpr uint32_t kInitChunk = 5 * 8192;
 
+
+static void init_dataset_items(randomx_dataset *dataset, randomx_cache *cache, uint32_t startItem, uint32_t itemCount)
+{
     if (Cpu::info()->hasAVX2() && (itemCount % 5)) {
         randomx_init_dataset(dataset, cache, startItem, itemCount - (itemCount % 5));
         randomx_init_dataset(dataset, cache, startItem + itemCount - 5, 5);
@@ -49,6 +55,22 @@ static void init_dataset_wrapper(randomx_dataset *dataset, randomx_cache *cache,
 }
 
 
+// Items are calculated in chunks, so a dataset that is no longer needed can stop early.
+static void init_dataset_wrapper(randomx_dataset *dataset, randomx_cache *cache, uint32_t startItem, uint32_t itemCount, int priority, const std::atomic<bool> *abort)
+{
+    Platform::setThreadPriority(priority);
+
+    while (itemCount > 0 && !(abort && abort->load(std::memory_order_relaxed))) {
+        const uint32_t count = std::min(itemCount, kInitChunk);
+
+        init_dataset_items(dataset, cache, startItem, count);
+
+        startItem += count;
+        itemCount -= count;
+    }
+}
+
+
 } // namespace xmrig
 
 
@@ -86,18 +108,23 @@ xmrig::RxDataset::~RxDataset()
 }
 
 
-bool xmrig::RxDataset::init(const Buffer &seed, uint32_t numThreads, int priority)
+bool xmrig::RxDataset::init(const RxSeed &seed, uint32_t numThreads, int priority, const String &datasetCache, const std::atomic<bool> *abort)
 {
     if (!m_cache || !m_cache->get()) {
         return false;
     }
 
-    m_cache->init(seed);
+    m_unsaved = false;
+    m_cache->init(seed.data());
 
     if (!get()) {
         return true;
     }
 
+    if (!datasetCache.isEmpty() && RxDatasetSnapshot::load(datasetCache, seed, this)) {
+        return true;
+    }
+
     const uint64_t datasetItemCount = randomx_dataset_item_count();
 
     if (numThreads > 1) {
@@ -107,7 +134,7 @@ bool xmrig::RxDataset::init(const Buffer &seed, uint32_t numThreads, int priorit
         for (uint64_t i = 0; i < numThreads; ++i) {
             const uint32_t a = (datasetItemCount * i) / numThreads;
             const uint32_t b = (datasetItemCount * (i + 1)) / numThreads;
-            threads.emplace_back(init_dataset_wrapper, m_dataset, m_cache->get(), a, b - a, priority);
+            threads.emplace_back(init_dataset_wrapper, m_dataset, m_cache->get(), a, b - a, priority, abort);
         }
 
         for (uint32_t i = 0; i < numThreads; ++i) {
@@ -115,13 +142,32 @@ bool xmrig::RxDataset::init(const Buffer &seed, uint32_t numThreads, int priorit
         }
     }
     else {
-        init_dataset_wrapper(m_dataset, m_cache->get(), 0, datasetItemCount, priority);
+        init_dataset_wrapper(m_dataset, m_cache->get(), 0, datasetItemCount, priority, abort);
     }
 
+    if (abort && abort->load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // The snapshot is written later by the caller, after the dataset is reported as ready.
+    m_unsaved = true;
+
     return true;
 }
 
 
+bool xmrig::RxDataset::saveSnapshot(const String &dir, const RxSeed &seed)
+{
+    if (!m_unsaved || dir.isEmpty() || !get()) {
+        return false;
+    }
+
+    m_unsaved = false;
+
+    return RxDatasetSnapshot::save(dir, seed, this);
+}
+
+
 bool xmrig::RxDataset::isHugePages() const
 {
     return m_memory && m_memory->isHugePages();
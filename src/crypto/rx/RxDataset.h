@@ -38,6 +38,8 @@ namespace xmrig
 
 
 class RxCache;
+class RxSeed;
+class String;
 class VirtualMemory;
 
 
@@ -50,13 +52,17 @@ public:
     RxDataset(RxCache *cache);
     ~RxDataset();
 
+    inline bool isUsed() const              { return m_users.load(std::memory_order_acquire) > 0; }
     inline randomx_dataset *get() const     { return m_dataset; }
     inline RxCache *cache() const           { return m_cache; }
+    inline void acquire()                   { m_users.fetch_add(1, std::memory_order_relaxed); }
+    inline void release()                   { m_users.fetch_sub(1, std::memory_order_release); }
     inline void setCache(RxCache *cache)    { m_cache = cache; }
 
-    bool init(const Buffer &seed, uint32_t numThreads, int priority);
+    bool init(const RxSeed &seed, uint32_t numThreads, int priority, const String &datasetCache, const std::atomic<bool> *abort = nullptr);
     bool isHugePages() const;
     bool isOneGbPages() const;
+    bool saveSnapshot(const String &dir, const RxSeed &seed);
     HugePagesInfo hugePages(bool cache = true) const;
     size_t size(bool cache = true) const;
     uint8_t *tryAllocateScrathpad();
@@ -70,10 +76,12 @@ private:
 
     const RxConfig::Mode m_mode = RxConfig::FastMode;
     const uint32_t m_node;
+    bool m_unsaved              = false;
     randomx_dataset *m_dataset  = nullptr;
     RxCache *m_cache            = nullptr;
     size_t m_scratchpadLimit    = 0;
     std::atomic<size_t> m_scratchpadOffset{};
+    std::atomic<uint32_t> m_users{};
     VirtualMemory *m_memory     = nullptr;
 };
 
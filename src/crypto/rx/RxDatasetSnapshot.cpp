@@ -0,0 +1,315 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "crypto/rx/RxDatasetSnapshot.h"
+#include "base/io/log/Log.h"
+#include "base/io/log/Tags.h"
+#include "base/tools/Chrono.h"
+#include "base/tools/Cvt.h"
+#include "base/tools/String.h"
+#include "crypto/randomx/dataset.hpp"
+#include "crypto/randomx/randomx.h"
+#include "crypto/rx/RxCache.h"
+#include "crypto/rx/RxDataset.h"
+#include "crypto/rx/RxSeed.h"
+
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <uv.h>
+#include <vector>
+
+
+namespace xmrig {
+
+
+static const char kMagic[8]         = { 'X', 'M', 'R', 'I', 'G', 'R', 'X', 'D' };
+static constexpr uint32_t kVersion  = 1;
+static constexpr size_t kChunkSize  = 64 * 1024 * 1024;
+static constexpr size_t kSamples    = 256;
+static constexpr size_t kKeepFiles  = 2;
+
+
+struct RxSnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t algorithm;
+    uint64_t size;
+    uint64_t checksum;
+    uint32_t seedSize;
+    uint8_t seed[60];
+};
+
+
+static_assert(sizeof(RxSnapshotHeader) == 96, "RxSnapshotHeader size mismatch");
+
+
+class RxChecksum
+{
+public:
+    inline void update(const uint8_t *data, size_t size)
+    {
+        const auto *p = reinterpret_cast<const uint64_t *>(data);
+
+        for (size_t i = 0; i < size / sizeof(uint64_t); ++i) {
+            m_a += p[i];
+            m_b += m_a;
+        }
+    }
+
+    inline uint64_t value() const { return m_a ^ (m_b * 0x9E3779B97F4A7C15ULL); }
+
+private:
+    uint64_t m_a = 0;
+    uint64_t m_b = 0;
+};
+
+
+static inline size_t datasetSize()
+{
+    return randomx_dataset_item_count() * RANDOMX_DATASET_ITEM_SIZE;
+}
+
+
+} // namespace xmrig
+
+
+bool xmrig::RxDatasetSnapshot::load(const String &dir, const RxSeed &seed, RxDataset *dataset)
+{
+    const uint64_t ts  = Chrono::steadyMSecs();
+    const auto name    = path(dir, seed);
+    const size_t size  = datasetSize();
+
+    FILE *fp = fopen(name.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+
+    RxSnapshotHeader header{};
+    bool ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+              memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+              header.version == kVersion &&
+              header.algorithm == seed.algorithm().id() &&
+              header.size == size &&
+              header.seedSize == seed.data().size() &&
+              header.seedSize <= sizeof(header.seed) &&
+              memcmp(header.seed, seed.data().data(), seed.data().size()) == 0;
+
+    auto raw = static_cast<uint8_t *>(dataset->raw());
+    RxChecksum checksum;
+
+    for (size_t offset = 0; ok && offset < size; offset += kChunkSize) {
+        const size_t n = std::min(kChunkSize, size - offset);
+
+        ok = fread(raw + offset, 1, n, fp) == n;
+        checksum.update(raw + offset, n);
+    }
+
+    fclose(fp);
+
+    if (!ok || checksum.value() != header.checksum || !verify(dataset)) {
+        LOG_WARN("%s" YELLOW_BOLD("dataset snapshot ") WHITE_BOLD("\"%s\"") YELLOW_BOLD(" is invalid, ignoring"), Tags::randomx(), name.c_str());
+
+        return false;
+    }
+
+    touch(name);
+
+    LOG_INFO("%s" GREEN_BOLD("dataset loaded from snapshot ") WHITE_BOLD("\"%s\"") BLACK_BOLD(" (%" PRIu64 " ms)"), Tags::randomx(), name.c_str(), Chrono::steadyMSecs() - ts);
+
+    return true;
+}
+
+
+bool xmrig::RxDatasetSnapshot::save(const String &dir, const RxSeed &seed, const RxDataset *dataset)
+{
+    if (seed.data().size() > sizeof(RxSnapshotHeader::seed)) {
+        return false;
+    }
+
+    const uint64_t ts  = Chrono::steadyMSecs();
+    const auto name    = path(dir, seed);
+    const auto tmp     = name + ".tmp";
+    const size_t size  = datasetSize();
+    const auto raw     = static_cast<const uint8_t *>(dataset->raw());
+
+    RxSnapshotHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version   = kVersion;
+    header.algorithm = seed.algorithm().id();
+    header.size      = size;
+    header.seedSize  = static_cast<uint32_t>(seed.data().size());
+    memcpy(header.seed, seed.data().data(), seed.data().size());
+
+    RxChecksum checksum;
+    checksum.update(raw, size);
+    header.checksum = checksum.value();
+
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (!fp) {
+        LOG_WARN("%s" YELLOW_BOLD("failed to create dataset snapshot ") WHITE_BOLD("\"%s\""), Tags::randomx(), tmp.c_str());
+
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    for (size_t offset = 0; ok && offset < size; offset += kChunkSize) {
+        const size_t n = std::min(kChunkSize, size - offset);
+
+        ok = fwrite(raw + offset, 1, n, fp) == n;
+    }
+
+    ok = (fclose(fp) == 0) && ok;
+
+    // Write to a temporary file first, so another instance never sees a partially written snapshot.
+    if (ok) {
+        remove(name.c_str());
+        ok = rename(tmp.c_str(), name.c_str()) == 0;
+    }
+
+    if (!ok) {
+        remove(tmp.c_str());
+
+        LOG_WARN("%s" YELLOW_BOLD("failed to write dataset snapshot ") WHITE_BOLD("\"%s\""), Tags::randomx(), name.c_str());
+
+        return false;
+    }
+
+    LOG_INFO("%s" GREEN_BOLD("dataset snapshot saved to ") WHITE_BOLD("\"%s\"") BLACK_BOLD(" (%" PRIu64 " ms)"), Tags::randomx(), name.c_str(), Chrono::steadyMSecs() - ts);
+
+    prune(dir, seed);
+
+    return true;
+}
+
+
+bool xmrig::RxDatasetSnapshot::verify(RxDataset *dataset)
+{
+    const uint64_t count = randomx_dataset_item_count();
+    const auto raw       = static_cast<const uint8_t *>(dataset->raw());
+
+    std::random_device rd;
+    std::mt19937_64 rng((static_cast<uint64_t>(rd()) << 32) | rd());
+
+    alignas(64) uint8_t item[RANDOMX_DATASET_ITEM_SIZE];
+
+    for (size_t i = 0; i < kSamples; ++i) {
+        // Always check the first and the last item, the rest is random so a partially damaged file can't pass by luck.
+        const uint64_t index = (i == 0) ? 0 : ((i == 1) ? count - 1 : rng() % count);
+
+        randomx::initDatasetItem(dataset->cache()->get(), item, index);
+
+        if (memcmp(item, raw + index * RANDOMX_DATASET_ITEM_SIZE, sizeof(item)) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+std::string xmrig::RxDatasetSnapshot::path(const String &dir, const RxSeed &seed)
+{
+    return prefix(dir, seed) + Cvt::toHex(seed.data()).data() + ".bin";
+}
+
+
+std::string xmrig::RxDatasetSnapshot::prefix(const String &dir, const RxSeed &seed)
+{
+    std::string algo = seed.algorithm().name();
+    std::replace(algo.begin(), algo.end(), '/', '-');
+
+    std::string out = dir.data();
+    if (!out.empty() && out.back() != '/' && out.back() != '\\') {
+        out += '/';
+    }
+
+    return out + algo + "-";
+}
+
+
+// Every snapshot is a full dataset (2+ GB), so only the newest files of the same algorithm are kept, by modification time.
+void xmrig::RxDatasetSnapshot::prune(const String &dir, const RxSeed &seed)
+{
+    const std::string base = prefix(dir, seed);
+    const size_t split     = base.find_last_of("/\\") + 1;
+    const std::string name = base.substr(split);
+
+    uv_fs_t req;
+    if (uv_fs_scandir(uv_default_loop(), &req, base.substr(0, split).c_str(), 0, nullptr) < 0) {
+        uv_fs_req_cleanup(&req);
+
+        return;
+    }
+
+    std::vector<std::pair<uv_timespec_t, std::string> > files;
+    uv_dirent_t entry;
+
+    while (uv_fs_scandir_next(&req, &entry) != UV_EOF) {
+        const std::string file = entry.name;
+
+        if (file.size() <= name.size() + 4 || file.compare(0, name.size(), name) != 0 || file.compare(file.size() - 4, 4, ".bin") != 0) {
+            continue;
+        }
+
+        uv_fs_t stat;
+        const std::string full = base.substr(0, split) + file;
+
+        if (uv_fs_stat(uv_default_loop(), &stat, full.c_str(), nullptr) == 0) {
+            files.emplace_back(stat.statbuf.st_mtim, full);
+        }
+
+        uv_fs_req_cleanup(&stat);
+    }
+
+    uv_fs_req_cleanup(&req);
+
+    if (files.size() <= kKeepFiles) {
+        return;
+    }
+
+    std::sort(files.begin(), files.end(), [](const std::pair<uv_timespec_t, std::string> &a, const std::pair<uv_timespec_t, std::string> &b) {
+        return a.first.tv_sec != b.first.tv_sec ? a.first.tv_sec > b.first.tv_sec : a.first.tv_nsec > b.first.tv_nsec;
+    });
+
+    for (size_t i = kKeepFiles; i < files.size(); ++i) {
+        uv_fs_t unlink;
+
+        if (uv_fs_unlink(uv_default_loop(), &unlink, files[i].second.c_str(), nullptr) == 0) {
+            LOG_INFO("%s" "removed old dataset snapshot " WHITE_BOLD("\"%s\""), Tags::randomx(), files[i].second.c_str());
+        }
+
+        uv_fs_req_cleanup(&unlink);
+    }
+}
+
+
+// A snapshot that was just loaded counts as recently used, so pruning keeps it.
+void xmrig::RxDatasetSnapshot::touch(const std::string &name)
+{
+    const double now = static_cast<double>(time(nullptr));
+
+    uv_fs_t req;
+    uv_fs_utime(uv_default_loop(), &req, name.c_str(), now, now, nullptr);
+    uv_fs_req_cleanup(&req);
+}
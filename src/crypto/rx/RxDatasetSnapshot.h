@@ -0,0 +1,60 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_RX_DATASETSNAPSHOT_H
+#define XMRIG_RX_DATASETSNAPSHOT_H
+
+
+#include <string>
+
+
+namespace xmrig
+{
+
+
+class RxDataset;
+class RxSeed;
+class String;
+
+
+/**
+ * On-disk copy of an initialized RandomX dataset.
+ *
+ * File layout: fixed header (magic, version, algorithm, seed, payload size and checksum) followed by the raw dataset.
+ * A loaded snapshot is accepted only if the checksum matches and a random sample of items is identical to
+ * items calculated from the current cache. Only the most recently used snapshots of each algorithm are kept.
+ */
+class RxDatasetSnapshot
+{
+public:
+    static bool load(const String &dir, const RxSeed &seed, RxDataset *dataset);
+    static bool save(const String &dir, const RxSeed &seed, const RxDataset *dataset);
+
+private:
+    static bool verify(RxDataset *dataset);
+    static std::string path(const String &dir, const RxSeed &seed);
+    static std::string prefix(const String &dir, const RxSeed &seed);
+    static void prune(const String &dir, const RxSeed &seed);
+    static void touch(const std::string &name);
+};
+
+
+} /* namespace xmrig */
+
+
+#endif /* XMRIG_RX_DATASETSNAPSHOT_H */
@@ -163,7 +163,7 @@ public:
     }
 
 
-    inline void initDatasets(uint32_t threads, int priority)
+    inline void initDatasets(uint32_t threads, int priority, const String &datasetCache, const std::atomic<bool> *abort)
     {
         uint64_t ts = Chrono::steadyMSecs();
         uint32_t id = 0;
@@ -175,7 +175,9 @@ public:
         }
 
         auto primary = dataset(id);
-        primary->init(m_seed.data(), threads, priority);
+        if (!primary->init(m_seed, threads, priority, datasetCache, abort)) {
+            return;
+        }
 
         printDatasetReady(id, ts);
 
@@ -195,6 +197,27 @@ public:
     }
 
 
+    inline bool isUsed() const
+    {
+        for (const auto &kv : m_datasets) {
+            if (kv.second->isUsed()) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    // Only the primary dataset is calculated, the copies on other nodes never have anything to save.
+    inline void saveSnapshot(const String &dir)
+    {
+        for (const auto &kv : m_datasets) {
+            kv.second->saveSnapshot(dir, m_seed);
+        }
+    }
+
+
     inline HugePagesInfo hugePages() const
     {
         HugePagesInfo pages;
@@ -350,6 +373,12 @@ bool xmrig::RxNUMAStorage::isAllocated() const
 }
 
 
+bool xmrig::RxNUMAStorage::isUsed() const
+{
+    return d_ptr->isUsed();
+}
+
+
 xmrig::HugePagesInfo xmrig::RxNUMAStorage::hugePages() const
 {
     if (!d_ptr->isAllocated()) {
@@ -370,7 +399,7 @@ xmrig::RxDataset *xmrig::RxNUMAStorage::dataset(const Job &job, uint32_t nodeId)
 }
 
 
-void xmrig::RxNUMAStorage::init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode, int priority)
+void xmrig::RxNUMAStorage::init(const RxSeed &seed, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode, int priority, const String &datasetCache, const std::atomic<bool> *abort)
 {
     d_ptr->setSeed(seed);
 
@@ -378,5 +407,11 @@ void xmrig::RxNUMAStorage::init(const RxSeed &seed, uint32_t threads, bool hugeP
         return;
     }
 
-    d_ptr->initDatasets(threads, priority);
+    d_ptr->initDatasets(threads, priority, datasetCache, abort);
+}
+
+
+void xmrig::RxNUMAStorage::saveSnapshot(const String &dir)
+{
+    d_ptr->saveSnapshot(dir);
 }
@@ -23,8 +23,13 @@
 #include "base/io/Async.h"
 #include "base/io/log/Log.h"
 #include "base/io/log/Tags.h"
+#include "base/tools/Chrono.h"
 #include "base/tools/Cvt.h"
+#include "crypto/common/Nonce.h"
+#include "crypto/rx/RxAlgo.h"
 #include "crypto/rx/RxBasicStorage.h"
+#include "crypto/rx/RxCache.h"
+#include "crypto/rx/RxDataset.h"
 
 
 #ifdef XMRIG_FEATURE_HWLOC
@@ -32,6 +37,69 @@
 #endif
 
 
+#include <algorithm>
+#include <cstdio>
+#include <uv.h>
+
+
+namespace xmrig {
+
+
+static IRxStorage *createStorage(const std::vector<uint32_t> &nodeset)
+{
+#   ifdef XMRIG_FEATURE_HWLOC
+    if (!nodeset.empty()) {
+        return new RxNUMAStorage(nodeset);
+    }
+#   endif
+
+    return new RxBasicStorage();
+}
+
+
+static uint64_t storageSize(size_t nodes, RxConfig::Mode mode)
+{
+    const uint64_t datasets = mode == RxConfig::LightMode ? 0 : std::max<uint64_t>(nodes, 1);
+
+    return datasets * RxDataset::maxSize() + RxCache::maxSize();
+}
+
+
+// Memory that can be allocated without swapping, MemAvailable also counts reclaimable page cache unlike free memory.
+static uint64_t availableMemory()
+{
+#   ifdef __linux__
+    FILE *fp = fopen("/proc/meminfo", "r");
+    if (fp) {
+        char line[128];
+        unsigned long long kb = 0;
+
+        while (fgets(line, sizeof(line), fp)) {
+            if (sscanf(line, "MemAvailable: %llu kB", &kb) == 1) {
+                fclose(fp);
+
+                return kb * 1024;
+            }
+        }
+
+        fclose(fp);
+    }
+#   endif
+
+    return uv_get_free_memory();
+}
+
+
+// Kept free for the rest of the system and the miner's own allocations.
+static uint64_t headroom()
+{
+    return std::max<uint64_t>(uv_get_total_memory() / 16, 512 * 1024 * 1024);
+}
+
+
+} // namespace xmrig
+
+
 xmrig::RxQueue::RxQueue(IRxListener *listener) :
     m_listener(listener)
 {
@@ -44,6 +112,7 @@ xmrig::RxQueue::~RxQueue()
 {
     std::unique_lock<std::mutex> lock(m_mutex);
     m_state = STATE_SHUTDOWN;
+    m_abort = true;
     lock.unlock();
 
     m_cv.notify_one();
@@ -51,6 +120,67 @@ xmrig::RxQueue::~RxQueue()
     m_thread.join();
 
     delete m_storage;
+
+    for (auto &slot : m_slots) {
+        delete slot.storage;
+    }
+}
+
+
+bool xmrig::RxQueue::enqueue(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (!m_storage) {
+        m_storage = createStorage(nodeset);
+    }
+
+    if (m_state == STATE_PENDING && m_seed == seed) {
+        return false;
+    }
+
+    // Dataset for this seed was prepared in background or used recently, switch to it without any pause
+    Slot *slot = m_state == STATE_IDLE ? find(seed) : nullptr;
+    if (slot) {
+        activate(*slot);
+
+        LOG_INFO("%s" GREEN_BOLD("switched to prepared dataset") BLACK_BOLD(" seed %s..."), Tags::randomx(), Cvt::toHex(seed.data().data(), 8).data());
+
+        return true;
+    }
+
+    // A standby dataset for another seed is useless now, stop it instead of making this one wait for a whole dataset init.
+    for (const auto &s : m_slots) {
+        if (s.storage == m_busy && !s.ready && s.seed != seed) {
+            m_abort = true;
+        }
+    }
+
+    retire(nodeset);
+
+    m_queue.emplace_back(seed, nodeset, threads, hugePages, oneGbPages, mode, priority, datasetCache);
+    m_seed  = seed;
+    m_state = STATE_PENDING;
+
+    lock.unlock();
+
+    m_cv.notify_one();
+
+    return false;
+}
+
+
+// Same as dataset(), but the storage is not evicted or initialized for another seed until the dataset is released.
+xmrig::RxDataset *xmrig::RxQueue::acquire(const Job &job, uint32_t nodeId)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    RxDataset *dataset = isReadyUnsafe(job) ? m_storage->dataset(job, nodeId) : nullptr;
+    if (dataset) {
+        dataset->acquire();
+    }
+
+    return dataset;
 }
 
 
@@ -70,7 +200,79 @@ xmrig::HugePagesInfo xmrig::RxQueue::hugePages()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
 
-    return m_storage && m_state == STATE_IDLE ? m_storage->hugePages() : HugePagesInfo();
+    if (!m_storage || m_state != STATE_IDLE) {
+        return {};
+    }
+
+    auto pages = m_storage->hugePages();
+
+    for (const auto &slot : m_slots) {
+        if (slot.ready) {
+            pages += slot.storage->hugePages();
+        }
+    }
+
+    return pages;
+}
+
+
+void xmrig::RxQueue::configure(const RxConfig &config)
+{
+    const uint64_t size = storageSize(config.nodeset().size(), config.mode());
+    size_t capacity     = config.memoryBudget() ? static_cast<size_t>(config.memoryBudget() * 1024 * 1024 / size) : (config.isDoubleBuffer() ? 1 : 0);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_requested == capacity && m_slotSize == size && m_configured) {
+        return;
+    }
+
+    m_requested = capacity;
+    m_slotSize  = size;
+
+    // Memory already held by this queue counts as available, the active dataset must fit as well if not allocated yet.
+    uint64_t available = availableMemory();
+
+    for (const auto &slot : m_slots) {
+        if (slot.storage->isAllocated()) {
+            available += size;
+        }
+    }
+
+    if (!m_storage || !m_storage->isAllocated()) {
+        available -= std::min(available, size);
+    }
+
+    const uint64_t reserve = headroom();
+    const uint64_t fit     = available > reserve ? (available - reserve) / size : 0;
+    const bool limited     = capacity > fit;
+
+    if (limited) {
+        capacity = static_cast<size_t>(fit);
+
+        LOG_WARN("%s" YELLOW_BOLD("not enough memory for more RandomX datasets, keeping at most %zu inactive"), Tags::randomx(), capacity);
+    }
+
+    m_capacity      = capacity;
+    m_configured    = true;
+
+    while (m_slots.size() > m_capacity) {
+        Slot *slot = evict();
+        if (!slot) {
+            break;
+        }
+
+        delete slot->storage;
+        m_slots.erase(m_slots.begin() + (slot - m_slots.data()));
+    }
+}
+
+
+uint64_t xmrig::RxQueue::initTime()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_initTime;
 }
 
 
@@ -83,29 +285,35 @@ bool xmrig::RxQueue::isReady(const T &seed)
 }
 
 
-void xmrig::RxQueue::enqueue(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority)
+template<typename T>
+bool xmrig::RxQueue::isStandby(const T &seed)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return m_state == STATE_IDLE && isStandbyUnsafe(seed);
+}
+
+
+void xmrig::RxQueue::prefetch(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
 
-    if (!m_storage) {
-#       ifdef XMRIG_FEATURE_HWLOC
-        if (!nodeset.empty()) {
-            m_storage = new RxNUMAStorage(nodeset);
-        }
-        else
-#       endif
-        {
-            m_storage = new RxBasicStorage();
+    // The prepared slot must use the same RandomX configuration as the active one, because it is applied globally.
+    if (!m_capacity || seed.data().empty() || seed == m_seed || seed.algorithm() != m_seed.algorithm()) {
+        return;
+    }
+
+    for (const auto &slot : m_slots) {
+        if (slot.seed == seed) {
+            return;
         }
     }
 
-    if (m_state == STATE_PENDING && m_seed == seed) {
+    if (!m_prefetch.empty() && m_prefetch.back().seed == seed) {
         return;
     }
 
-    m_queue.emplace_back(seed, nodeset, threads, hugePages, oneGbPages, mode, priority);
-    m_seed  = seed;
-    m_state = STATE_PENDING;
+    m_prefetch.emplace_back(seed, nodeset, threads, hugePages, oneGbPages, mode, priority, datasetCache);
 
     lock.unlock();
 
@@ -120,13 +328,175 @@ bool xmrig::RxQueue::isReadyUnsafe(const T &seed) const
 }
 
 
+// Only slots with the active algorithm count as standby, switching to another one goes through a full miner restart.
+template<typename T>
+bool xmrig::RxQueue::isStandbyUnsafe(const T &seed) const
+{
+    if (seed.algorithm() != m_seed.algorithm()) {
+        return false;
+    }
+
+    for (const auto &slot : m_slots) {
+        if (slot.ready && slot.seed == seed) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+template<typename T>
+xmrig::RxQueue::Slot *xmrig::RxQueue::find(const T &seed)
+{
+    for (auto &slot : m_slots) {
+        if (slot.ready && slot.seed == seed) {
+            return &slot;
+        }
+    }
+
+    return nullptr;
+}
+
+
+void xmrig::RxQueue::initStandby(std::unique_lock<std::mutex> &lock)
+{
+    const auto item = m_prefetch.back();
+    m_prefetch.clear();
+
+    if (item.seed == m_seed || item.seed.algorithm() != m_seed.algorithm() || find(item.seed)) {
+        return;
+    }
+
+    Slot *slot = allocate(item.nodeset);
+
+    if (!slot) {
+        return;
+    }
+
+    IRxStorage *standby = slot->storage;
+    slot->seed          = item.seed;
+    slot->ready         = false;
+    m_busy              = standby;
+    m_abort             = false;
+
+    lock.unlock();
+
+    LOG_INFO("%s" MAGENTA_BOLD("prepare next dataset") " algo " WHITE_BOLD("%s (") CYAN_BOLD("%u") WHITE_BOLD(" threads)") BLACK_BOLD(" seed %s..."),
+             Tags::randomx(),
+             item.seed.algorithm().name(),
+             item.threads,
+             Cvt::toHex(item.seed.data().data(), 8).data()
+             );
+
+    standby->init(item.seed, item.threads, item.hugePages, item.oneGbPages, item.mode, item.priority, item.datasetCache, &m_abort);
+
+    lock.lock();
+
+    m_busy = nullptr;
+
+    const bool aborted = m_abort.exchange(false);
+
+    // Slots could be added or reordered in the meantime, the storage itself never moves to another slot while busy.
+    slot = nullptr;
+    for (auto &s : m_slots) {
+        if (s.storage == standby) {
+            slot = &s;
+        }
+    }
+
+    if (!slot) {
+        return;
+    }
+
+    if (aborted) {
+        LOG_INFO("%s" YELLOW_BOLD("next dataset preparation stopped") BLACK_BOLD(" seed %s..."), Tags::randomx(), Cvt::toHex(item.seed.data().data(), 8).data());
+
+        slot->seed = RxSeed();
+
+        return;
+    }
+
+    // The dataset is useless if the active algorithm (and so the global RandomX configuration) changed during init.
+    slot->ready = standby->isAllocated() && m_seed.algorithm() == item.seed.algorithm();
+    slot->used  = ++m_tick;
+
+    // Seed has changed while the standby dataset was initializing, switch to it instead of starting over
+    if (m_state == STATE_PENDING && slot->ready && m_seed == item.seed) {
+        activate(*slot);
+        m_async->send();
+    }
+
+    if (standby->isAllocated()) {
+        saveSnapshot(standby, item.datasetCache, lock);
+    }
+}
+
+
+// New slots are added only while the memory is still there, the host might have got busier since configure().
+xmrig::RxQueue::Slot *xmrig::RxQueue::allocate(const std::vector<uint32_t> &nodeset)
+{
+    if (m_slots.size() < m_capacity && availableMemory() >= m_slotSize + headroom()) {
+        m_slots.emplace_back();
+        m_slots.back().storage = createStorage(nodeset);
+
+        return &m_slots.back();
+    }
+
+    return evict();
+}
+
+
+xmrig::RxQueue::Slot *xmrig::RxQueue::evict()
+{
+    Slot *lru = nullptr;
+
+    // Storage that was active a moment ago may still be used by workers which have not switched to the new job yet.
+    for (auto &slot : m_slots) {
+        if (slot.storage != m_busy && !slot.storage->isUsed() && (!lru || slot.used < lru->used)) {
+            lru = &slot;
+        }
+    }
+
+    return lru;
+}
+
+
+void xmrig::RxQueue::activate(Slot &slot)
+{
+    // Previous dataset takes the slot, so switching back to the previous seed is also free
+    const bool ready  = m_state == STATE_IDLE && m_storage->isAllocated();
+    const RxSeed seed = slot.seed;
+
+    if (seed.algorithm() != m_seed.algorithm()) {
+        RxAlgo::apply(seed.algorithm());
+    }
+
+    std::swap(m_storage, slot.storage);
+
+    slot.seed   = ready ? m_seed : RxSeed();
+    slot.ready  = ready;
+    slot.used   = ++m_tick;
+    m_seed      = seed;
+    m_state     = STATE_IDLE;
+
+    m_queue.clear();
+}
+
+
 void xmrig::RxQueue::backgroundInit()
 {
     while (m_state != STATE_SHUTDOWN) {
         std::unique_lock<std::mutex> lock(m_mutex);
 
-        if (m_state == STATE_IDLE) {
-            m_cv.wait(lock, [this]{ return m_state != STATE_IDLE; });
+        if (m_state == STATE_IDLE && m_prefetch.empty()) {
+            m_cv.wait(lock, [this]{ return m_state != STATE_IDLE || !m_prefetch.empty(); });
+        }
+
+        if (m_state == STATE_IDLE && !m_prefetch.empty()) {
+            initStandby(lock);
+
+            continue;
         }
 
         if (m_state != STATE_PENDING) {
@@ -136,6 +506,8 @@ void xmrig::RxQueue::backgroundInit()
         const auto item = m_queue.back();
         m_queue.clear();
 
+        IRxStorage *storage = m_storage;
+
         lock.unlock();
 
         LOG_INFO("%s" MAGENTA_BOLD("init dataset%s") " algo " WHITE_BOLD("%s (") CYAN_BOLD("%u") WHITE_BOLD(" threads)") BLACK_BOLD(" seed %s..."),
@@ -146,10 +518,17 @@ void xmrig::RxQueue::backgroundInit()
                  Cvt::toHex(item.seed.data().data(), 8).data()
                  );
 
-        m_storage->init(item.seed, item.threads, item.hugePages, item.oneGbPages, item.mode, item.priority);
+        // Storages apply the algorithm only when it differs from their previous seed, a cached slot might have changed it since.
+        RxAlgo::apply(item.seed.algorithm());
+
+        const uint64_t ts = Chrono::steadyMSecs();
+
+        storage->init(item.seed, item.threads, item.hugePages, item.oneGbPages, item.mode, item.priority, item.datasetCache, nullptr);
 
         lock.lock();
 
+        m_initTime = Chrono::steadyMSecs() - ts;
+
         if (m_state == STATE_SHUTDOWN || !m_queue.empty()) {
             continue;
         }
@@ -158,6 +537,11 @@ void xmrig::RxQueue::backgroundInit()
         m_seed = item.seed;
         m_state = STATE_IDLE;
         m_async->send();
+
+        // Wake up workers waiting for the dataset right away, without the round trip to the main thread.
+        Nonce::notify();
+
+        saveSnapshot(storage, item.datasetCache, lock);
     }
 }
 
@@ -174,11 +558,52 @@ void xmrig::RxQueue::onReady()
 }
 
 
+// Keeps the current dataset in an inactive slot before the active storage is initialized for another seed.
+void xmrig::RxQueue::retire(const std::vector<uint32_t> &nodeset)
+{
+    if (!m_capacity || m_state != STATE_IDLE || m_seed.data().empty() || !m_storage->isAllocated()) {
+        return;
+    }
+
+    Slot *slot = allocate(nodeset);
+
+    if (!slot) {
+        return;
+    }
+
+    std::swap(m_storage, slot->storage);
+
+    slot->seed  = m_seed;
+    slot->ready = true;
+    slot->used  = ++m_tick;
+}
+
+
+// Writing a snapshot is slow, so it happens only after the dataset is reported as ready.
+// The storage is marked as busy meanwhile, so it is never evicted or initialized for another seed in the middle of the write.
+void xmrig::RxQueue::saveSnapshot(IRxStorage *storage, const String &dir, std::unique_lock<std::mutex> &lock)
+{
+    if (dir.isEmpty() || m_state == STATE_SHUTDOWN) {
+        return;
+    }
+
+    m_busy = storage;
+    lock.unlock();
+
+    storage->saveSnapshot(dir);
+
+    lock.lock();
+    m_busy = nullptr;
+}
+
+
 namespace xmrig {
 
 
 template bool RxQueue::isReady(const Job &);
 template bool RxQueue::isReady(const RxSeed &);
+template bool RxQueue::isStandby(const Job &);
+template bool RxQueue::isStandby(const RxSeed &);
 
 
 } // namespace xmrig
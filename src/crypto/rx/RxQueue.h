@@ -29,6 +29,7 @@
 #include "crypto/rx/RxSeed.h"
 
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -46,12 +47,13 @@ class RxDataset;
 class RxQueueItem
 {
 public:
-    RxQueueItem(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority) :
+    RxQueueItem(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache) :
         hugePages(hugePages),
         oneGbPages(oneGbPages),
         priority(priority),
         mode(mode),
         seed(seed),
+        datasetCache(datasetCache),
         nodeset(nodeset),
         threads(threads)
     {}
@@ -61,6 +63,7 @@ public:
     const int priority;
     const RxConfig::Mode mode;
     const RxSeed seed;
+    const String datasetCache;
     const std::vector<uint32_t> nodeset;
     const uint32_t threads;
 };
@@ -74,10 +77,15 @@ public:
     RxQueue(IRxListener *listener);
     ~RxQueue() override;
 
+    bool enqueue(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache);
     HugePagesInfo hugePages();
+    void configure(const RxConfig &config);
+    RxDataset *acquire(const Job &job, uint32_t nodeId);
     RxDataset *dataset(const Job &job, uint32_t nodeId);
+    uint64_t initTime();
     template<typename T> bool isReady(const T &seed);
-    void enqueue(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority);
+    template<typename T> bool isStandby(const T &seed);
+    void prefetch(const RxSeed &seed, const std::vector<uint32_t> &nodeset, uint32_t threads, bool hugePages, bool oneGbPages, RxConfig::Mode mode, int priority, const String &datasetCache);
 
 protected:
     inline void onAsync() override  { onReady(); }
@@ -89,19 +97,46 @@ private:
         STATE_SHUTDOWN
     };
 
+    // Inactive storage, either prepared for the next seed or kept after a switch to another seed.
+    struct Slot
+    {
+        bool ready          = false;
+        IRxStorage *storage = nullptr;
+        RxSeed seed;
+        uint64_t used       = 0;
+    };
+
     template<typename T> bool isReadyUnsafe(const T &seed) const;
+    template<typename T> bool isStandbyUnsafe(const T &seed) const;
+    template<typename T> Slot *find(const T &seed);
+    void initStandby(std::unique_lock<std::mutex> &lock);
+    Slot *allocate(const std::vector<uint32_t> &nodeset);
+    Slot *evict();
+    void activate(Slot &slot);
     void backgroundInit();
     void onReady();
+    void retire(const std::vector<uint32_t> &nodeset);
+    void saveSnapshot(IRxStorage *storage, const String &dir, std::unique_lock<std::mutex> &lock);
 
+    bool m_configured       = false;
     IRxListener *m_listener = nullptr;
+    IRxStorage *m_busy      = nullptr;
     IRxStorage *m_storage   = nullptr;
     RxSeed m_seed;
-    State m_state = STATE_IDLE;
+    size_t m_capacity       = 0;
+    size_t m_requested      = 0;
+    State m_state           = STATE_IDLE;
+    std::atomic<bool> m_abort{false};
+    std::vector<Slot> m_slots;
+    uint64_t m_slotSize     = 0;
+    uint64_t m_tick         = 0;
     std::condition_variable m_cv;
     std::mutex m_mutex;
     std::shared_ptr<Async> m_async;
     std::thread m_thread;
+    std::vector<RxQueueItem> m_prefetch;
     std::vector<RxQueueItem> m_queue;
+    uint64_t m_initTime     = 0;
 };
 
 
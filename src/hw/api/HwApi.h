@@ -38,6 +38,8 @@ public:
     HwApi() = default;
 
 protected:
+    inline void onMetrics(Metrics &) override {}
+
     void onRequest(IApiRequest &request) override;
 
 private:
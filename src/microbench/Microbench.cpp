@@ -0,0 +1,140 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "microbench/Microbench.h"
+#include "3rdparty/rapidjson/document.h"
+
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+
+namespace xmrig {
+
+
+static inline double steadyNSecs()
+{
+    using namespace std::chrono;
+
+    return static_cast<double>(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+
+} // namespace xmrig
+
+
+xmrig::Microbench::Microbench(uint64_t budget, const char *filter, bool full, bool hugePages) :
+    m_full(full),
+    m_hugePages(hugePages),
+    m_filter(filter ? filter : ""),
+    m_budget(budget * 1000000ULL)
+{
+}
+
+
+bool xmrig::Microbench::isEnabled(const std::string &name) const
+{
+    // Prefix match in both directions, so a group (e.g. "rx") is enabled by a filter that selects one of its cases.
+    return m_filter.empty() || name.compare(0, m_filter.size(), m_filter) == 0 || m_filter.compare(0, name.size(), name) == 0;
+}
+
+
+void xmrig::Microbench::fail(const std::string &name, const std::string &reason)
+{
+    m_failures.emplace_back(name, reason);
+
+    fprintf(stderr, "%-40s FAILED: %s\n", name.c_str(), reason.c_str());
+}
+
+
+double xmrig::Microbench::run(const std::string &name, uint32_t items, const Case &fn)
+{
+    if (!isEnabled(name)) {
+        return 0;
+    }
+
+    // Warm up caches, JIT code and lazily allocated state outside of the measured region.
+    fn(1);
+
+    const double budget = static_cast<double>(m_budget);
+    const double batch  = budget / 16;
+
+    uint64_t count      = 1;
+    uint64_t iterations = 0;
+    double total        = 0;
+    double minNs        = 0;
+
+    while (total < budget || iterations < 3) {
+        const double start = steadyNSecs();
+        fn(count);
+        const double elapsed = steadyNSecs() - start;
+
+        total      += elapsed;
+        iterations += count;
+
+        const double ns = elapsed / count;
+        minNs = (minNs == 0) ? ns : std::min(minNs, ns);
+
+        if (elapsed < batch && count < (1ULL << 40)) {
+            count = elapsed > 0 ? std::max(count + 1, static_cast<uint64_t>(count * batch / elapsed)) : count * 2;
+        }
+    }
+
+    m_results.push_back({ name, items, iterations, total / iterations, minNs });
+
+    fprintf(stderr, "%-40s %12.1f ns/op %14.1f ops/s\n", name.c_str(), total / iterations, iterations * 1e9 / total);
+
+    return total / iterations;
+}
+
+
+void xmrig::Microbench::toJSON(rapidjson::Document &doc) const
+{
+    using namespace rapidjson;
+    auto &allocator = doc.GetAllocator();
+
+    Value benchmarks(kArrayType);
+
+    for (const auto &result : m_results) {
+        Value out(kObjectType);
+        out.AddMember("name",           Value(result.name.c_str(), allocator), allocator);
+        out.AddMember("iterations",     static_cast<uint64_t>(result.iterations), allocator);
+        out.AddMember("ns_per_op",      result.ns, allocator);
+        out.AddMember("min_ns_per_op",  result.minNs, allocator);
+        out.AddMember("ops_per_sec",    1e9 / result.ns, allocator);
+        out.AddMember("items_per_op",   result.items, allocator);
+        out.AddMember("items_per_sec",  1e9 * result.items / result.ns, allocator);
+
+        benchmarks.PushBack(out, allocator);
+    }
+
+    Value failures(kArrayType);
+
+    for (const auto &failure : m_failures) {
+        Value out(kObjectType);
+        out.AddMember("name",   Value(failure.first.c_str(), allocator), allocator);
+        out.AddMember("reason", Value(failure.second.c_str(), allocator), allocator);
+
+        failures.PushBack(out, allocator);
+    }
+
+    doc.AddMember("budget_ms",  static_cast<uint64_t>(m_budget / 1000000ULL), allocator);
+    doc.AddMember("benchmarks", benchmarks, allocator);
+    doc.AddMember("failures",   failures, allocator);
+}
@@ -0,0 +1,104 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef XMRIG_MICROBENCH_H
+#define XMRIG_MICROBENCH_H
+
+
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+#include "3rdparty/rapidjson/fwd.h"
+#include "base/tools/Object.h"
+
+
+namespace xmrig {
+
+
+/**
+ * Time-boxed runner for the hot-path micro benchmarks.
+ *
+ * Every case is a callable that performs the requested number of operations,
+ * the runner grows the batch size until a single batch takes about 1/16 of the
+ * time budget and keeps running batches until the budget is spent.
+ * Cases that also check a result (known answers, overhead limits) report a
+ * mismatch with fail(), the executable then exits with a non-zero status.
+ * run() returns the mean time per operation in nanoseconds, 0 if the case was filtered out.
+ */
+class Microbench
+{
+public:
+    XMRIG_DISABLE_COPY_MOVE_DEFAULT(Microbench)
+
+    using Case = std::function<void(uint64_t count)>;
+
+    Microbench(uint64_t budget, const char *filter, bool full, bool hugePages);
+
+    inline bool isFailed() const    { return !m_failures.empty(); }
+    inline bool isFull() const      { return m_full; }
+    inline bool isHugePages() const { return m_hugePages; }
+
+    bool isEnabled(const std::string &name) const;
+    void fail(const std::string &name, const std::string &reason);
+    double run(const std::string &name, uint32_t items, const Case &fn);
+    void toJSON(rapidjson::Document &doc) const;
+
+private:
+    struct Result
+    {
+        std::string name;
+        uint32_t items;
+        uint64_t iterations;
+        double ns;
+        double minNs;
+    };
+
+    const bool m_full;
+    const bool m_hugePages;
+    const std::string m_filter;
+    const uint64_t m_budget;
+    std::vector<Result> m_results;
+    std::vector<std::pair<std::string, std::string> > m_failures;
+};
+
+
+namespace microbench {
+
+
+void argon2(Microbench &bench);
+void cn(Microbench &bench);
+void ghostrider(Microbench &bench);
+void hashrate(Microbench &bench);
+void jobSwitch(Microbench &bench);
+void kawpow(Microbench &bench);
+void log(Microbench &bench);
+void nonce(Microbench &bench);
+void rx(Microbench &bench);
+void stratum(Microbench &bench);
+
+
+} // namespace microbench
+
+
+} // namespace xmrig
+
+
+#endif /* XMRIG_MICROBENCH_H */
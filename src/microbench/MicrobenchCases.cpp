@@ -0,0 +1,972 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+
+#include "microbench/Microbench.h"
+#include "3rdparty/rapidjson/document.h"
+#include "3rdparty/rapidjson/stringbuffer.h"
+#include "3rdparty/rapidjson/writer.h"
+#include "backend/common/Hashrate.h"
+#include "backend/common/JobSwitch.h"
+#include "backend/cpu/Cpu.h"
+#include "base/io/json/JsonRequest.h"
+#include "base/io/log/Log.h"
+#include "base/kernel/interfaces/IClientListener.h"
+#include "base/kernel/interfaces/ILogBackend.h"
+#include "base/net/stratum/Client.h"
+#include "base/net/stratum/Job.h"
+#include "base/tools/Chrono.h"
+#include "base/tools/Cvt.h"
+#include "crypto/cn/CnCtx.h"
+#include "crypto/cn/CnHash.h"
+#include "crypto/common/Nonce.h"
+#include "crypto/common/VirtualMemory.h"
+#include "net/JobResult.h"
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+#   include "crypto/randomx/aes_hash.hpp"
+#   include "crypto/randomx/randomx.h"
+#   include "crypto/rx/RxAlgo.h"
+#   include "crypto/rx/RxCache.h"
+#   include "crypto/rx/RxDataset.h"
+#endif
+
+#ifdef XMRIG_ALGO_ARGON2
+#   include "3rdparty/argon2.h"
+#   include "crypto/argon2/Impl.h"
+#endif
+
+#ifdef XMRIG_ALGO_KAWPOW
+#   include "backend/opencl/cl/kawpow/kawpow_cl.h"
+#   include "crypto/cn/CryptoNight_test.h"
+#   include "crypto/kawpow/KPCache.h"
+#   include "crypto/kawpow/KPHash.h"
+#   include "crypto/kawpow/KPProgram.h"
+#endif
+
+#ifdef XMRIG_ALGO_GHOSTRIDER
+#   include "crypto/ghostrider/ghostrider.h"
+#endif
+
+
+namespace xmrig {
+
+
+static constexpr size_t kBlobSize       = 76;
+static constexpr size_t kNonceOffset    = 39;
+static constexpr uint64_t kHeight       = 3000000;
+
+
+static void fillBlobs(uint8_t *blobs, size_t size, size_t count)
+{
+    for (size_t i = 0; i < size * count; ++i) {
+        blobs[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+}
+
+
+#ifdef XMRIG_ALGO_KAWPOW
+// Size and FNV-1a 64 of the OpenCL kernel source produced by the std::regex based generator that KPProgram replaced.
+static const struct {
+    uint64_t period;
+    size_t size;
+    uint64_t fnv;
+} kawpow_program_output[] = {
+    { 0,            8306, 0x0f8ad8001c4618d4ULL },
+    { 1,            8310, 0x96d90b52ab1f4a19ULL },
+    { 1000000,      8370, 0xa5517396f732518fULL },
+    { 1300000,      8273, 0x9ba1d1664447a600ULL },
+    { 0x100000001,  8310, 0x5768f324e4a7b5b0ULL }
+};
+#endif
+
+
+#ifdef XMRIG_ALGO_RANDOMX
+static randomx_vm *createVm(int flags, randomx_cache *cache, randomx_dataset *dataset, uint8_t *scratchpad)
+{
+    if (Cpu::info()->hasAES()) {
+        flags |= RANDOMX_FLAG_HARD_AES;
+    }
+
+    const auto asmId = Cpu::info()->assembly();
+    if ((asmId == Assembly::RYZEN) || (asmId == Assembly::BULLDOZER)) {
+        flags |= RANDOMX_FLAG_AMD;
+    }
+
+    return randomx_create_vm(static_cast<randomx_flags>(flags), cache, dataset, scratchpad, 0);
+}
+
+
+static void runAes(Microbench &bench, const std::string &name, uint8_t *scratchpad, size_t size, hashAndFillAes1Rx4_impl *hashAndFill, void (*hash)(const void *, size_t, void *), void (*fill)(void *, size_t, void *))
+{
+    alignas(64) uint64_t state[8] = {};
+    alignas(64) uint64_t out[8]   = {};
+    alignas(64) uint8_t program[128 + 256 * 8];
+
+    bench.run("rx/aes/hash-fill/" + name, static_cast<uint32_t>(size), [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            hashAndFill(scratchpad, size, out, state);
+        }
+    });
+
+    if (hash) {
+        bench.run("rx/aes/hash/" + name, static_cast<uint32_t>(size), [&](uint64_t count) {
+            for (uint64_t i = 0; i < count; ++i) {
+                hash(scratchpad, size, out);
+            }
+        });
+    }
+
+    if (fill) {
+        bench.run("rx/aes/program/" + name, sizeof(program), [&](uint64_t count) {
+            for (uint64_t i = 0; i < count; ++i) {
+                fill(out, sizeof(program), program);
+            }
+        });
+    }
+}
+
+
+static void runVm(Microbench &bench, const std::string &name, randomx_vm *vm)
+{
+    if (!vm) {
+        return;
+    }
+
+    uint8_t blob[kBlobSize];
+    uint8_t hash[32];
+    uint64_t tempHash[8];
+
+    fillBlobs(blob, kBlobSize, 1);
+    randomx_calculate_hash_first(vm, tempHash, blob, kBlobSize);
+
+    bench.run(name, 1, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            ++*reinterpret_cast<uint32_t *>(blob + kNonceOffset);
+            randomx_calculate_hash_next(vm, tempHash, blob, kBlobSize, hash);
+        }
+    });
+
+    randomx_destroy_vm(vm);
+}
+#endif
+
+
+class StratumListener : public IClientListener
+{
+public:
+    StratumListener() = default;
+
+protected:
+    inline void onClose(IClient *, int) override                                                   {}
+    inline void onJobReceived(IClient *, const Job &, const rapidjson::Value &) override           {}
+    inline void onLogin(IClient *, rapidjson::Document &, rapidjson::Value &) override             {}
+    inline void onLoginSuccess(IClient *) override                                                 {}
+    inline void onResultAccepted(IClient *, const SubmitResult &, const char *) override           {}
+    inline void onVerifyAlgorithm(const IClient *, const Algorithm &, bool *ok) override           { *ok = true; }
+};
+
+
+class SubmitListener : public StratumListener
+{
+public:
+    SubmitListener() = default;
+
+    inline const std::vector<int64_t> &accepted() const { return m_accepted; }
+    inline const std::vector<int64_t> &rejected() const { return m_rejected; }
+
+protected:
+    inline void onResultAccepted(IClient *, const SubmitResult &result, const char *error) override { (error ? m_rejected : m_accepted).push_back(result.seq); }
+
+private:
+    std::vector<int64_t> m_accepted;
+    std::vector<int64_t> m_rejected;
+};
+
+
+class CountingLog : public ILogBackend
+{
+public:
+    CountingLog() = default;
+
+    inline uint64_t lines() const { return m_lines.load(std::memory_order_acquire); }
+
+protected:
+    inline void print(uint64_t, int, const char *, size_t, size_t, bool colors) override
+    {
+        if (colors) {
+            m_lines.fetch_add(1, std::memory_order_release);
+        }
+    }
+
+private:
+    std::atomic<uint64_t> m_lines{ 0 };
+};
+
+
+class StratumClient : public Client
+{
+public:
+    inline StratumClient(IClientListener *listener) : Client(0, "", listener) { setRpcId("4d7a2f9c-81e5-4b1a-9f3e-6c0d2b8a7e51"); }
+
+    using Client::close;
+    using Client::hasExtension;
+    using Client::rpcId;
+    using Client::sequence;
+    using Client::submit;
+
+    inline size_t format(const JobResult &result, std::vector<char> &buf)   { return writeSubmit(result, buf, 0); }
+    inline void feed(char *line, size_t size)                               { onLine(line, size); }
+    inline void setConnected()                                              { m_state = ConnectedState; }
+};
+
+
+// Submit line as the generic JSON-RPC path writes it, the reference for the client's direct formatter.
+static std::string submitJson(const StratumClient &client, const JobResult &result)
+{
+    using namespace rapidjson;
+
+    char nonce[9];
+    char data[65];
+    char signature[129];
+
+    Cvt::toHex(nonce, sizeof(nonce), reinterpret_cast<const uint8_t *>(&result.nonce), sizeof(uint32_t));
+    Cvt::toHex(data, sizeof(data), result.result(), 32);
+
+    Document doc(kObjectType);
+    auto &allocator = doc.GetAllocator();
+
+    Value params(kObjectType);
+    params.AddMember("id",     StringRef(client.rpcId().data()), allocator);
+    params.AddMember("job_id", StringRef(result.jobId.data()), allocator);
+    params.AddMember("nonce",  StringRef(nonce), allocator);
+    params.AddMember("result", StringRef(data), allocator);
+
+    if (result.minerSignature()) {
+        Cvt::toHex(signature, sizeof(signature), result.minerSignature(), 64);
+        params.AddMember("sig", StringRef(signature), allocator);
+    }
+
+    if (client.hasExtension(IClient::EXT_ALGO) && result.algorithm.isValid()) {
+        params.AddMember("algo", StringRef(result.algorithm.name()), allocator);
+    }
+
+    JsonRequest::create(doc, client.sequence(), "submit", params);
+
+    StringBuffer buffer(nullptr, 512);
+    Writer<StringBuffer> writer(buffer);
+    doc.Accept(writer);
+
+    return std::string(buffer.GetString(), buffer.GetSize()) + "\n";
+}
+
+
+} // namespace xmrig
+
+
+void xmrig::microbench::argon2(Microbench &bench)
+{
+#   ifdef XMRIG_ALGO_ARGON2
+    if (!bench.isEnabled("argon2")) {
+        return;
+    }
+
+    xmrig::argon2::Impl::select(String());
+
+    struct Params
+    {
+        Algorithm::Id algorithm;
+        uint32_t t_cost;
+        uint32_t m_cost;
+    };
+
+    static const Params params[] = {
+        { Algorithm::AR2_CHUKWA,    3, 512  },
+        { Algorithm::AR2_CHUKWA_V2, 4, 1024 },
+        { Algorithm::AR2_WRKZ,      4, 256  }
+    };
+
+    for (const auto &p : params) {
+        const Algorithm algorithm(p.algorithm);
+        if (!bench.isEnabled(algorithm.name())) {
+            continue;
+        }
+
+        VirtualMemory memory(algorithm.l3(), bench.isHugePages(), false, false);
+
+        uint8_t blob[kBlobSize];
+        uint8_t hash[32];
+
+        fillBlobs(blob, kBlobSize, 1);
+
+        bench.run(algorithm.name(), 1, [&](uint64_t count) {
+            for (uint64_t i = 0; i < count; ++i) {
+                ++*reinterpret_cast<uint32_t *>(blob + kNonceOffset);
+                argon2id_hash_raw_ex(p.t_cost, p.m_cost, 1, blob, kBlobSize, blob, 16, hash, 32, memory.scratchpad());
+            }
+        });
+    }
+#   endif
+}
+
+
+void xmrig::microbench::cn(Microbench &bench)
+{
+    if (!bench.isEnabled("cn")) {
+        return;
+    }
+
+    static const char *names[CnHash::AV_MAX] = {
+        "auto", "single", "double", "single-soft", "double-soft", "triple", "quad", "penta", "triple-soft", "quad-soft", "penta-soft"
+    };
+
+    static const uint32_t ways[CnHash::AV_MAX] = { 1, 1, 2, 1, 2, 3, 4, 5, 3, 4, 5 };
+
+    const auto assembly = Cpu::info()->assembly();
+    const auto algorithms = Algorithm::all([](const Algorithm &algo) { return algo.isCN(); });
+
+    for (const auto &algorithm : algorithms) {
+        for (int av = CnHash::AV_SINGLE; av < CnHash::AV_MAX; ++av) {
+            const std::string name = std::string(algorithm.name()) + "/" + names[av];
+            if (!bench.isEnabled(name)) {
+                continue;
+            }
+
+            const auto fn = CnHash::fn(algorithm, static_cast<CnHash::AlgoVariant>(av), assembly);
+            if (!fn) {
+                continue;
+            }
+
+            const uint32_t n = ways[av];
+            VirtualMemory memory(algorithm.l3() * n, bench.isHugePages(), false, false);
+
+            cryptonight_ctx *ctx[5] = {};
+            CnCtx::create(ctx, memory.scratchpad(), algorithm.l3(), n);
+
+            uint8_t blobs[kBlobSize * 5];
+            uint8_t hash[32 * 5];
+
+            fillBlobs(blobs, kBlobSize, n);
+
+            bench.run(name, n, [&](uint64_t count) {
+                for (uint64_t i = 0; i < count; ++i) {
+                    for (uint32_t j = 0; j < n; ++j) {
+                        ++*reinterpret_cast<uint32_t *>(blobs + j * kBlobSize + kNonceOffset);
+                    }
+
+                    fn(blobs, kBlobSize, hash, ctx, kHeight);
+                }
+            });
+
+            CnCtx::release(ctx, n);
+        }
+    }
+}
+
+
+void xmrig::microbench::ghostrider(Microbench &bench)
+{
+#   ifdef XMRIG_ALGO_GHOSTRIDER
+    if (!bench.isEnabled("ghostrider")) {
+        return;
+    }
+
+    constexpr uint32_t N     = 8;
+    constexpr size_t size    = 1U << 21;
+
+    VirtualMemory memory(size * N, bench.isHugePages(), false, false);
+
+    cryptonight_ctx *ctx[N] = {};
+    CnCtx::create(ctx, memory.scratchpad(), size, N);
+
+    uint8_t blob[80];
+    uint8_t hash[32 * N];
+
+    fillBlobs(blob, sizeof(blob), 1);
+
+    bench.run("ghostrider/hash-octa", N, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            ++*reinterpret_cast<uint32_t *>(blob + 76);
+            xmrig::ghostrider::hash_octa(blob, sizeof(blob), hash, ctx, nullptr, false);
+        }
+    });
+
+    CnCtx::release(ctx, N);
+#   endif
+}
+
+
+void xmrig::microbench::hashrate(Microbench &bench)
+{
+    if (!bench.isEnabled("hashrate")) {
+        return;
+    }
+
+    // One tick of a 192 thread backend is a sample for every thread plus the total.
+    constexpr size_t threads = 192;
+    Hashrate hashrate(threads);
+    uint64_t ts = 1000000;
+
+    auto tick = [&hashrate, &ts]() {
+        ts += 500;
+
+        uint64_t total = 0;
+        for (size_t i = 0; i < threads; ++i) {
+            const uint64_t value = ts * (i + 1) / 100;
+            hashrate.add(i, value, ts);
+            total += value;
+        }
+
+        hashrate.add(total, ts);
+    };
+
+    // Fill the 15 minute window first, so reads don't take the shortcut of an incomplete window.
+    for (size_t i = 0; i < Hashrate::LargeInterval / 500 + 4; ++i) {
+        tick();
+    }
+
+    bench.run("hashrate/tick/threads=192", threads, [&tick](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            tick();
+        }
+    });
+
+    bench.run("hashrate/read/threads=192", threads, [&hashrate](uint64_t count) {
+        volatile double sink = 0.0;
+
+        for (uint64_t i = 0; i < count; ++i) {
+            for (size_t t = 0; t < threads; ++t) {
+                sink = sink + hashrate.calc(t, Hashrate::ShortInterval).second + hashrate.calc(t, Hashrate::MediumInterval).second + hashrate.calc(t, Hashrate::LargeInterval).second;
+            }
+        }
+    });
+
+#   ifdef XMRIG_FEATURE_API
+    // Percentiles and jitter are sorted out only here, when the API asks for "hashrate_stats".
+    bench.run("hashrate/stats/threads=192", threads, [&hashrate](uint64_t count) {
+        rapidjson::Document doc;
+
+        for (uint64_t i = 0; i < count; ++i) {
+            for (size_t t = 0; t < threads; ++t) {
+                hashrate.statsToJSON(t, doc);
+            }
+        }
+    });
+#   endif
+}
+
+
+void xmrig::microbench::jobSwitch(Microbench &bench)
+{
+    if (!bench.isEnabled("job-switch")) {
+        return;
+    }
+
+    constexpr size_t threads    = 64;
+    constexpr double timestamps = 2.0;
+
+    bench.run("job-switch/timestamp", 1, [](uint64_t count) {
+        volatile double sink = 0.0;
+
+        for (uint64_t i = 0; i < count; ++i) {
+            sink = sink + Chrono::highResolutionMSecs();
+        }
+    });
+
+    Job job(false, Algorithm::CN_R, "");
+    std::vector<JobSwitch::Probe> probes(threads);
+
+    JobSwitch::setWorkers(Nonce::CPU, threads);
+
+    // Whole instrumentation cost of one job switch: dispatch, then every worker consumes the job and reports its first hash.
+    const double ns = bench.run("job-switch/switch/threads=64", threads, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            JobSwitch::dispatch(job);
+            Nonce::touch(Nonce::CPU);
+
+            const uint64_t sequence = Nonce::sequence(Nonce::CPU);
+
+            for (auto &probe : probes) {
+                probe.consumed(Nonce::CPU, sequence);
+                probe.hashed();
+            }
+        }
+    });
+
+    JobSwitch::setWorkers(Nonce::CPU, 0);
+
+    // Each worker may pay for about two timestamps per switch, anything above that means the probes got heavier.
+    const double limit = threads * timestamps * JobSwitch::timerCost();
+    if (ns > limit) {
+        bench.fail("job-switch/switch/threads=64", "switch cost " + std::to_string(ns) + " ns exceeds " + std::to_string(limit) + " ns");
+    }
+}
+
+
+void xmrig::microbench::kawpow(Microbench &bench)
+{
+#   ifdef XMRIG_ALGO_KAWPOW
+    if (!bench.isEnabled("kawpow")) {
+        return;
+    }
+
+    KPCache cache;
+    uint32_t epoch = 0;
+
+    // KPCache::init() is a no-op for the current epoch, alternate between two epochs to rebuild the cache on every call.
+    bench.run("kawpow/cache-init", 1, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            epoch ^= 1;
+            cache.init(epoch);
+        }
+    });
+
+    for (const auto &test : kawpow_program_output) {
+        const std::string source = KPProgram::source(kawpow_cl, test.period);
+
+        uint64_t fnv = 0xcbf29ce484222325ULL;
+        for (const char c : source) {
+            fnv = (fnv ^ static_cast<uint8_t>(c)) * 0x100000001b3ULL;
+        }
+
+        if (source.size() != test.size || fnv != test.fnv) {
+            bench.fail("kawpow/program", "kernel source mismatch at period " + std::to_string(test.period));
+        }
+    }
+
+    uint64_t period      = 0;
+    volatile size_t sink = 0;
+
+    // Per period kernel source generation, runs on the GPU runners' background builder for every prefetched period.
+    bench.run("kawpow/program", 1, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            sink = sink + KPProgram::source(kawpow_cl, ++period).size();
+        }
+    });
+
+    if (!bench.isEnabled("kawpow/hash/light") || !cache.init(0)) {
+        return;
+    }
+
+    // Same known answers as the CPU worker self-test, the benchmark is meaningless if the hash is wrong.
+    for (const auto &test : kawpow_test_output) {
+        uint32_t output[8];
+        uint32_t mix_hash[8];
+
+        KPHash::calculate(cache, test.height, kawpow_test_header, kawpow_test_nonce, output, mix_hash);
+
+        if (memcmp(output, test.output, sizeof(output)) != 0 || memcmp(mix_hash, test.mix_hash, sizeof(mix_hash)) != 0) {
+            bench.fail("kawpow/hash/light", "known answer mismatch at height " + std::to_string(test.height));
+
+            return;
+        }
+    }
+
+    uint64_t nonce = kawpow_test_nonce;
+
+    bench.run("kawpow/hash/light", 1, [&](uint64_t count) {
+        uint32_t output[8];
+        uint32_t mix_hash[8];
+
+        for (uint64_t i = 0; i < count; ++i) {
+            KPHash::calculate(cache, kawpow_test_output[0].height, kawpow_test_header, ++nonce, output, mix_hash);
+            sink = sink + output[0];
+        }
+    });
+#   endif
+}
+
+
+void xmrig::microbench::log(Microbench &bench)
+{
+    if (!bench.isEnabled("log")) {
+        return;
+    }
+
+    auto backend = new CountingLog();
+
+    Log::init();
+    Log::add(backend);
+
+    // Time spent by the calling thread only, lines are written out in background.
+    bench.run("log/call", 1, [](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            LOG_INFO("%s " GREEN_BOLD("accepted") " (%" PRIu64 "/%u) diff " WHITE_BOLD("%" PRIu64) " " BLACK_BOLD("(%u ms)"), "cpu", i, 0U, i * 1000, 25U);
+        }
+    });
+
+    std::vector<uint32_t> threads = { 1, 4, std::max(std::thread::hardware_concurrency(), 1U) };
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+    // A typical worker thread message, measured until every line has reached the backend.
+    for (const uint32_t n : threads) {
+        bench.run("log/print/threads=" + std::to_string(n), 1, [n, backend](uint64_t count) {
+            const uint64_t expected = backend->lines() + count;
+
+            std::vector<std::thread> workers;
+            workers.reserve(n);
+
+            for (uint32_t t = 0; t < n; ++t) {
+                const uint64_t share = count / n + (t == 0 ? count % n : 0);
+
+                workers.emplace_back([share, t]() {
+                    for (uint64_t i = 0; i < share; ++i) {
+                        LOG_INFO("%s " GREEN_BOLD("accepted") " (%" PRIu64 "/%u) diff " WHITE_BOLD("%" PRIu64) " " BLACK_BOLD("(%u ms)"), "cpu", i, t, i * 1000, 25U);
+                    }
+                });
+            }
+
+            for (auto &worker : workers) {
+                worker.join();
+            }
+
+            while (backend->lines() < expected) {
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    Log::destroy();
+}
+
+
+void xmrig::microbench::nonce(Microbench &bench)
+{
+    if (!bench.isEnabled("nonce")) {
+        return;
+    }
+
+    std::vector<uint32_t> threads = { 1, 2, 4, std::max(std::thread::hardware_concurrency(), 1U) };
+    std::sort(threads.begin(), threads.end());
+    threads.erase(std::unique(threads.begin(), threads.end()), threads.end());
+
+    for (const uint32_t n : threads) {
+        bench.run("nonce/next/threads=" + std::to_string(n), 1, [n](uint64_t count) {
+            Nonce::reset(0);
+
+            std::vector<std::thread> workers;
+            workers.reserve(n);
+
+            for (uint32_t t = 0; t < n; ++t) {
+                const uint64_t share = count / n + (t == 0 ? count % n : 0);
+
+                workers.emplace_back([share]() {
+                    uint32_t nonce[2] = {};
+
+                    for (uint64_t i = 0; i < share; ++i) {
+                        Nonce::next(0, nonce, 1, 0xFFFFFFFFULL);
+                    }
+                });
+            }
+
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        });
+    }
+
+    // CPU worker sized reservations with a 64 bit nonce, served from per NUMA node blocks; threads alternate between two nodes.
+    for (const uint32_t n : threads) {
+        bench.run("nonce/reserve/threads=" + std::to_string(n), 1, [n](uint64_t count) {
+            Nonce::reset(0);
+
+            std::vector<std::thread> workers;
+            workers.reserve(n);
+
+            for (uint32_t t = 0; t < n; ++t) {
+                const uint64_t share = count / n + (t == 0 ? count % n : 0);
+
+                workers.emplace_back([share, t]() {
+                    uint32_t nonce[2] = {};
+
+                    Nonce::setNode(t % 2);
+
+                    for (uint64_t i = 0; i < share; ++i) {
+                        Nonce::next(0, nonce, 32768, 0xFFFFFFFFFFFFULL);
+                    }
+                });
+            }
+
+            for (auto &worker : workers) {
+                worker.join();
+            }
+        });
+    }
+
+    Nonce::reset(0);
+}
+
+
+void xmrig::microbench::rx(Microbench &bench)
+{
+#   ifdef XMRIG_ALGO_RANDOMX
+    if (!bench.isEnabled("rx")) {
+        return;
+    }
+
+    RxAlgo::apply(Algorithm::RX_0);
+
+    RxCache cache(bench.isHugePages(), 0);
+    if (!cache.get()) {
+        return;
+    }
+
+    cache.init(Buffer(32, 0x5a));
+
+    VirtualMemory scratchpad(Algorithm::l3(Algorithm::RX_0), bench.isHugePages(), false, false);
+
+    // Scratchpad hash/fill and program generation kernels, one case per available implementation.
+    if (Cpu::info()->hasAES()) {
+        const size_t size = Algorithm::l3(Algorithm::RX_0);
+
+        runAes(bench, "aes", scratchpad.scratchpad(), size, &hashAndFillAes1Rx4<0, 2>, &hashAes1Rx4<false>, &fillAes4Rx4<false>);
+
+#       ifdef XMRIG_VAES
+        if (Cpu::info()->hasVAES()) {
+            runAes(bench, "vaes256", scratchpad.scratchpad(), size, &hashAndFillAes1Rx4_vaes256, &hashAes1Rx4_vaes256, &fillAes4Rx4_vaes256);
+        }
+
+        if (Cpu::info()->hasVAES() && Cpu::info()->has(ICpuInfo::FLAG_AVX512F)) {
+            runAes(bench, "vaes512", scratchpad.scratchpad(), size, &hashAndFillAes1Rx4_vaes512, nullptr, nullptr);
+        }
+#       endif
+    }
+
+    runVm(bench, "rx/0/light/interpreted", createVm(RANDOMX_FLAG_DEFAULT, cache.get(), nullptr, scratchpad.scratchpad()));
+
+    if (cache.isJIT()) {
+        runVm(bench, "rx/0/light/jit", createVm(RANDOMX_FLAG_JIT, cache.get(), nullptr, scratchpad.scratchpad()));
+    }
+
+    if (bench.isEnabled("rx/0/dataset-init")) {
+        constexpr uint32_t items = 8192;
+
+        VirtualMemory memory(items * RANDOMX_DATASET_ITEM_SIZE, bench.isHugePages(), false, false);
+        randomx_dataset *dataset = randomx_create_dataset(memory.raw());
+
+        bench.run("rx/0/dataset-init", items, [&](uint64_t count) {
+            for (uint64_t i = 0; i < count; ++i) {
+                randomx_init_dataset(dataset, cache.get(), 0, items);
+            }
+        });
+
+        randomx_release_dataset(dataset);
+    }
+
+    if (!bench.isFull() || !bench.isEnabled("rx/0/full")) {
+        return;
+    }
+
+    VirtualMemory memory(RxDataset::maxSize(), bench.isHugePages(), false, false);
+    randomx_dataset *dataset = randomx_create_dataset(memory.raw());
+    if (!dataset) {
+        return;
+    }
+
+    const uint64_t total = randomx_dataset_item_count();
+    const uint32_t n     = std::max(std::thread::hardware_concurrency(), 1U);
+
+    std::vector<std::thread> threads;
+    threads.reserve(n);
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint64_t a = (total * i) / n;
+        const uint64_t b = (total * (i + 1)) / n;
+
+        threads.emplace_back([&cache, dataset, a, b]() { randomx_init_dataset(dataset, cache.get(), a, b - a); });
+    }
+
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    runVm(bench, "rx/0/full/interpreted", createVm(RANDOMX_FLAG_FULL_MEM, nullptr, dataset, scratchpad.scratchpad()));
+    runVm(bench, "rx/0/full/jit", createVm(RANDOMX_FLAG_FULL_MEM | RANDOMX_FLAG_JIT, nullptr, dataset, scratchpad.scratchpad()));
+
+    randomx_release_dataset(dataset);
+#   endif
+}
+
+
+void xmrig::microbench::stratum(Microbench &bench)
+{
+    if (!bench.isEnabled("stratum")) {
+        return;
+    }
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    static const char *algo = "rx/0";
+#   else
+    static const char *algo = "cn/r";
+#   endif
+
+    // Typical RandomX job notification, the job id changes every time so each line is accepted as a new job.
+    const std::string format = std::string("{\"jsonrpc\":\"2.0\",\"method\":\"job\",\"params\":{\"blob\":\"") +
+                               std::string(kBlobSize * 2, 'e') +
+                               "\",\"job_id\":\"%" PRIu64 "\",\"target\":\"b88d0600\",\"algo\":\"%s\",\"height\":3000000,\"seed_hash\":\"" +
+                               std::string(64, '5') +
+                               "\"}}";
+
+    StratumListener listener;
+    StratumClient client(&listener);
+
+    {
+        // Direct formatting must match the generic path byte for byte: plain and escaped ids, miner signature, "algo" extension.
+        StratumClient escaped(&listener);
+        std::string login = std::string("{\"id\":1,\"jsonrpc\":\"2.0\",\"error\":null,\"result\":{\"id\":\"rig \\\"7\\\"\\\\a\\tb\\u0001\\u001f\u00e9\",\"job\":{\"blob\":\"") +
+                            std::string(kBlobSize * 2, 'e') +
+                            "\",\"job_id\":\"1\",\"target\":\"b88d0600\",\"algo\":\"" + algo + "\",\"height\":3000000,\"seed_hash\":\"" +
+                            std::string(64, '5') +
+                            "\"},\"extensions\":[\"algo\"],\"status\":\"OK\"}}";
+
+        escaped.feed(&login[0], login.size());
+
+        if (!escaped.hasExtension(IClient::EXT_ALGO)) {
+            bench.fail("stratum/submit/direct", "login response was not accepted");
+        }
+
+        Job job(false, Algorithm(algo), "");
+        uint8_t hash[32];
+        uint8_t signature[64];
+        memset(hash, 0x3c, sizeof(hash));
+        memset(signature, 0xa7, sizeof(signature));
+
+        // The last id is too long for the worst case estimate and takes the rapidjson fallback.
+        for (const std::string &jobId : { std::string("829371649207154"), std::string("job \"\\\x02\n\x7f\xc3\xa9/end"), std::string(3000, 'j') }) {
+            job.setId(jobId.c_str());
+
+            for (StratumClient *c : { &client, &escaped }) {
+                for (const JobResult &result : { JobResult(job, 0x1234abcd, hash), JobResult(job, 0xfedc, hash, nullptr, nullptr, signature) }) {
+                    std::vector<char> buf;
+                    const size_t size = c->format(result, buf);
+
+                    if (std::string(buf.data(), size) != submitJson(*c, result)) {
+                        bench.fail("stratum/submit/direct", "submit line differs from rapidjson output: " + std::string(buf.data(), size));
+                    }
+                }
+            }
+        }
+    }
+
+    {
+        // Shares of one event loop pass share a batch, responses come back in any order and whatever is still pending on close fails.
+        SubmitListener results;
+        StratumClient batch(&results);
+        batch.setConnected();
+
+        Job job(false, Algorithm(algo), batch.rpcId());
+        job.setId("829371649207154");
+        job.setTarget("b88d0600");
+
+        uint8_t hash[32];
+        memset(hash, 0x11, sizeof(hash));
+
+        int64_t ids[6];
+        for (size_t i = 0; i < 6; ++i) {
+            ids[i] = batch.submit(JobResult(job, static_cast<uint32_t>(i), hash));
+
+            if (ids[i] < 0 || (i > 0 && ids[i] != ids[i - 1] + 1)) {
+                bench.fail("stratum/submit/batch", "batched submits did not get consecutive ids");
+            }
+        }
+
+        for (size_t i : { 3, 1, 5, 4, 2 }) {
+            std::string response = "{\"id\":" + std::to_string(ids[i]) + ",\"jsonrpc\":\"2.0\"," +
+                                   (i % 2 ? "\"error\":null,\"result\":{\"status\":\"OK\"}}" : "\"error\":{\"code\":-1,\"message\":\"Low difficulty share\"}}");
+
+            batch.feed(&response[0], response.size());
+        }
+
+        batch.close();
+
+        if (results.accepted() != std::vector<int64_t>{ ids[3], ids[1], ids[5] } || results.rejected() != std::vector<int64_t>{ ids[4], ids[2], ids[0] }) {
+            bench.fail("stratum/submit/batch", "submit results were not matched to their ids");
+        }
+    }
+
+    char line[1024];
+    uint64_t id = 0;
+
+    bench.run("stratum/parse/job", 1, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            const int size = snprintf(line, sizeof(line), format.c_str(), ++id, algo);
+
+            client.feed(line, static_cast<size_t>(size));
+        }
+    });
+
+    Job job(false, Algorithm(algo), "");
+    job.setId("829371649207154");
+
+    uint8_t hash[32];
+    memset(hash, 0x5a, sizeof(hash));
+
+    const JobResult result(job, 0x1234abcd, hash);
+    std::vector<char> sendBuf(1024);
+    int64_t sequence   = 0;
+    volatile size_t sink = 0;
+
+    // Share submission through the generic JSON-RPC send path: document, writer, copy into the send buffer.
+    bench.run("stratum/submit/json", 1, [&](uint64_t count) {
+        using namespace rapidjson;
+
+        char nonce[9];
+        char data[65];
+
+        for (uint64_t i = 0; i < count; ++i) {
+            Cvt::toHex(nonce, sizeof(nonce), reinterpret_cast<const uint8_t *>(&result.nonce), sizeof(uint32_t));
+            Cvt::toHex(data, sizeof(data), result.result(), 32);
+
+            Document doc(kObjectType);
+            auto &allocator = doc.GetAllocator();
+
+            Value params(kObjectType);
+            params.AddMember("id",     StringRef("4d7a2f9c-81e5-4b1a-9f3e-6c0d2b8a7e51"), allocator);
+            params.AddMember("job_id", StringRef(result.jobId.data()), allocator);
+            params.AddMember("nonce",  StringRef(nonce), allocator);
+            params.AddMember("result", StringRef(data), allocator);
+
+            JsonRequest::create(doc, ++sequence, "submit", params);
+
+            StringBuffer buffer(nullptr, 512);
+            Writer<StringBuffer> writer(buffer);
+            doc.Accept(writer);
+
+            memcpy(sendBuf.data(), buffer.GetString(), buffer.GetSize());
+            sendBuf[buffer.GetSize()] = '\n';
+            sink = sink + buffer.GetSize();
+        }
+    });
+
+    // Same line formatted directly into a byte buffer, as Client::submit() does with the pending batch.
+    bench.run("stratum/submit/direct", 1, [&](uint64_t count) {
+        for (uint64_t i = 0; i < count; ++i) {
+            sink = sink + client.format(result, sendBuf);
+        }
+    });
+}
@@ -0,0 +1,136 @@
+/* XMRig
+ * Copyright (c) 2018-2021 SChernykh   <https://github.com/SChernykh>
+ * Copyright (c) 2016-2021 XMRig       <https://github.com/xmrig>, <support@xmrig.com>
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+#include "microbench/Microbench.h"
+#include "3rdparty/rapidjson/document.h"
+#include "3rdparty/rapidjson/prettywriter.h"
+#include "3rdparty/rapidjson/stringbuffer.h"
+#include "backend/cpu/Cpu.h"
+#include "base/io/json/Json.h"
+#include "crypto/common/VirtualMemory.h"
+#include "version.h"
+
+
+static const char *kUsage = R"===(Usage: xmrig-microbench [OPTIONS]
+
+Options:
+      --filter=PREFIX   run only benchmarks with names starting with PREFIX (e.g. cn/r, rx/0/light, nonce, hashrate)
+      --time=N          time budget per benchmark in milliseconds (default: 250)
+      --full            also run full-mode RandomX VMs (allocates and initializes the 2 GB dataset)
+      --no-huge-pages   disable huge pages for benchmark memory
+      --json=FILE       write JSON results to FILE instead of stdout
+  -h, --help            display this help and exit
+)===";
+
+
+static const char *option(const char *arg, const char *name)
+{
+    const size_t size = strlen(name);
+
+    return (strncmp(arg, name, size) == 0 && arg[size] == '=') ? arg + size + 1 : nullptr;
+}
+
+
+int main(int argc, char **argv)
+{
+    using namespace xmrig;
+
+    const char *filter  = nullptr;
+    const char *json    = nullptr;
+    uint64_t budget     = 250;
+    bool full           = false;
+    bool hugePages      = true;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value;
+
+        if ((value = option(arg, "--filter"))) {
+            filter = value;
+        }
+        else if ((value = option(arg, "--time"))) {
+            budget = strtoull(value, nullptr, 10);
+        }
+        else if ((value = option(arg, "--json"))) {
+            json = value;
+        }
+        else if (strcmp(arg, "--full") == 0) {
+            full = true;
+        }
+        else if (strcmp(arg, "--no-huge-pages") == 0) {
+            hugePages = false;
+        }
+        else {
+            fputs(kUsage, (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) ? stdout : stderr);
+
+            return (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) ? 0 : 1;
+        }
+    }
+
+    if (budget == 0) {
+        fputs(kUsage, stderr);
+
+        return 1;
+    }
+
+    if (hugePages) {
+        VirtualMemory::init(0, VirtualMemory::kDefaultHugePageSize);
+    }
+
+    Microbench bench(budget, filter, full, hugePages);
+
+    microbench::cn(bench);
+    microbench::rx(bench);
+    microbench::argon2(bench);
+    microbench::kawpow(bench);
+    microbench::ghostrider(bench);
+    microbench::hashrate(bench);
+    microbench::jobSwitch(bench);
+    microbench::log(bench);
+    microbench::nonce(bench);
+    microbench::stratum(bench);
+
+    using namespace rapidjson;
+    Document doc(kObjectType);
+    auto &allocator = doc.GetAllocator();
+
+    doc.AddMember("version",    APP_VERSION, allocator);
+    doc.AddMember("cpu",        StringRef(Cpu::info()->brand()), allocator);
+    doc.AddMember("huge_pages", hugePages, allocator);
+
+    bench.toJSON(doc);
+
+    if (json) {
+        return (Json::save(json, doc) && !bench.isFailed()) ? 0 : 1;
+    }
+
+    StringBuffer buffer(nullptr, 64 * 1024);
+    PrettyWriter<StringBuffer> writer(buffer);
+    writer.SetMaxDecimalPlaces(3);
+    doc.Accept(writer);
+
+    fwrite(buffer.GetString(), 1, buffer.GetSize(), stdout);
+    fputc('\n', stdout);
+
+    return bench.isFailed() ? 1 : 0;
+}
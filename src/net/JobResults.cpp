@@ -28,11 +28,20 @@
 #include "base/io/Async.h"
 #include "base/io/log/Log.h"
 #include "base/kernel/interfaces/IAsyncListener.h"
+#include "base/kernel/interfaces/ITimerListener.h"
+#include "base/tools/Chrono.h"
 #include "base/tools/Object.h"
+#include "base/tools/Timer.h"
 #include "net/interfaces/IJobResultListener.h"
 #include "net/JobResult.h"
 
 
+#ifdef XMRIG_FEATURE_API
+#   include "3rdparty/rapidjson/document.h"
+#   include "base/api/Metrics.h"
+#endif
+
+
 #ifdef XMRIG_ALGO_RANDOMX
 #   include "crypto/randomx/randomx.h"
 #   include "crypto/rx/Rx.h"
@@ -47,7 +56,7 @@
 
 // me assume this mean all GPU backends
 #if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
-#   include "base/tools/Baton.h"
+#   include "base/tools/MpscQueue.h"
 #   include "crypto/cn/CnCtx.h"
 #   include "crypto/cn/CnHash.h"
 #   include "crypto/cn/CryptoNight.h"
@@ -55,24 +64,103 @@
 #endif
 
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <thread>
 #include <uv.h>
 
 
 namespace xmrig {
 
 
+// Results handed to the network in one pass, from the first result of the batch until the batch is drained.
+class JobBatches
+{
+public:
+    inline void open()
+    {
+        double expected = 0.0;
+        m_opened.compare_exchange_strong(expected, Chrono::highResolutionMSecs(), std::memory_order_relaxed);
+    }
+
+
+    inline void close(size_t size)
+    {
+        const double now    = Chrono::highResolutionMSecs();
+        const double opened = m_opened.exchange(0.0, std::memory_order_relaxed);
+
+        if (size == 0) {
+            return;
+        }
+
+        const double ms = opened > 0.0 ? std::max(now - opened, 0.0) : 0.0;
+
+        m_count++;
+        m_results  += size;
+        m_maxSize   = std::max<uint64_t>(m_maxSize, size);
+        m_latency  += ms;
+        m_maxMs     = std::max(m_maxMs, ms);
+    }
+
+
+#   ifdef XMRIG_FEATURE_API
+    rapidjson::Value toJSON(rapidjson::Document &doc) const
+    {
+        using namespace rapidjson;
+        auto &allocator = doc.GetAllocator();
+
+        Value out(kObjectType);
+        out.AddMember("batches",        m_count, allocator);
+        out.AddMember("results",        m_results, allocator);
+        out.AddMember("avg_size",       m_count ? static_cast<double>(m_results) / m_count : 0.0, allocator);
+        out.AddMember("max_size",       m_maxSize, allocator);
+        out.AddMember("avg_latency_ms", m_count ? m_latency / m_count : 0.0, allocator);
+        out.AddMember("max_latency_ms", m_maxMs, allocator);
+
+        return out;
+    }
+
+
+    void toMetrics(Metrics &metrics) const
+    {
+        metrics.set("xmrig_submit_batch_size", Metrics::SUMMARY, "Results handed to the network per batch.");
+        metrics.add(m_results, nullptr, "_sum");
+        metrics.add(m_count, nullptr, "_count");
+
+        metrics.set("xmrig_submit_batch_latency_seconds", Metrics::SUMMARY, "Time from the first result of a batch until the batch is submitted.");
+        metrics.add(m_latency / 1000.0, nullptr, "_sum");
+        metrics.add(m_count, nullptr, "_count");
+    }
+#   endif
+
+private:
+    double m_latency    = 0.0;
+    double m_maxMs      = 0.0;
+    std::atomic<double> m_opened{ 0.0 };
+    uint64_t m_count    = 0;
+    uint64_t m_maxSize  = 0;
+    uint64_t m_results  = 0;
+};
+
+
 #if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
+static constexpr size_t kMaxVerifyThreads = 4;
+
+
 class JobBundle
 {
 public:
-    inline JobBundle(const Job &job, uint32_t *results, size_t count, uint32_t device_index) :
+    inline JobBundle(const Job &job, uint32_t *results, size_t count, uint32_t device_index, uint32_t node) :
         job(job),
         nonces(count),
-        device_index(device_index)
+        device_index(device_index),
+        node(node),
+        ts(Chrono::highResolutionMSecs())
     {
         memcpy(nonces.data(), results, sizeof(uint32_t) * count);
     }
@@ -80,122 +168,347 @@ public:
     Job job;
     std::vector<uint32_t> nonces;
     uint32_t device_index;
+    uint32_t node;
+    double ts;
 };
 
 
-class JobBaton : public Baton<uv_work_t>
+class JobLatency
 {
 public:
-    inline JobBaton(std::list<JobBundle> &&bundles, IJobResultListener *listener, bool hwAES) :
-        hwAES(hwAES),
-        listener(listener),
-        bundles(std::move(bundles))
-    {}
-
-    const bool hwAES;
-    IJobResultListener *listener;
-    std::list<JobBundle> bundles;
-    std::vector<JobResult> results;
-    uint32_t errors = 0;
-};
+    static constexpr size_t kBuckets = 12;
 
+    inline void add(double ms)
+    {
+        size_t i = 0;
+        while (i < kBuckets - 1 && ms > kBounds[i]) {
+            ++i;
+        }
 
-static inline void checkHash(const JobBundle &bundle, std::vector<JobResult> &results, uint32_t nonce, uint8_t hash[32], uint32_t &errors)
-{
-    if (*reinterpret_cast<uint64_t*>(hash + 24) < bundle.job.target()) {
-        results.emplace_back(bundle.job, nonce, hash);
+        m_counts[i].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(static_cast<uint64_t>(ms * 1000.0), std::memory_order_relaxed);
     }
-    else {
-        LOG_ERR("%s " RED_S "GPU #%u COMPUTE ERROR", backend_tag(bundle.job.backend()), bundle.device_index);
-        errors++;
+
+    inline void addError() { m_errors.fetch_add(1, std::memory_order_relaxed); }
+
+
+#   ifdef XMRIG_FEATURE_API
+    rapidjson::Value toJSON(rapidjson::Document &doc) const
+    {
+        using namespace rapidjson;
+        auto &allocator = doc.GetAllocator();
+
+        const uint64_t count = m_count.load(std::memory_order_relaxed);
+
+        Value out(kObjectType);
+        out.AddMember("bundles",    count, allocator);
+        out.AddMember("errors",     m_errors.load(std::memory_order_relaxed), allocator);
+        out.AddMember("avg_ms",     count ? (m_sum.load(std::memory_order_relaxed) / 1000.0 / count) : 0.0, allocator);
+
+        Value bounds(kArrayType);
+        Value counts(kArrayType);
+
+        for (size_t i = 0; i < kBuckets; ++i) {
+            if (i < kBuckets - 1) {
+                bounds.PushBack(kBounds[i], allocator);
+            }
+
+            counts.PushBack(m_counts[i].load(std::memory_order_relaxed), allocator);
+        }
+
+        out.AddMember("latency_ms", bounds, allocator);
+        out.AddMember("histogram",  counts, allocator);
+
+        return out;
     }
-}
 
 
-static void getResults(JobBundle &bundle, std::vector<JobResult> &results, uint32_t &errors, bool hwAES)
-{
-    const auto &algorithm = bundle.job.algorithm();
-    auto memory           = new VirtualMemory(algorithm.l3(), false, false, false);
-    alignas(16) uint8_t hash[32]{ 0 };
+    void toMetrics(Metrics &metrics) const
+    {
+        metrics.set("xmrig_gpu_verification_errors_total", Metrics::COUNTER, "GPU results that failed CPU verification.");
+        metrics.add(m_errors.load(std::memory_order_relaxed));
 
-    if (algorithm.family() == Algorithm::RANDOM_X) {
-#       ifdef XMRIG_ALGO_RANDOMX
-        RxDataset *dataset = Rx::dataset(bundle.job, 0);
-        if (dataset == nullptr) {
-            errors += bundle.nonces.size();
-            delete memory;
+        metrics.set("xmrig_gpu_verification_latency_seconds", Metrics::HISTOGRAM, "Time from GPU result to the end of CPU verification.");
 
-            return;
+        char labels[32];
+        uint64_t total = 0;
+
+        for (size_t i = 0; i < kBuckets; ++i) {
+            total += m_counts[i].load(std::memory_order_relaxed);
+
+            if (i < kBuckets - 1) {
+                snprintf(labels, sizeof(labels), "le=\"%g\"", kBounds[i] / 1000.0);
+            }
+            else {
+                snprintf(labels, sizeof(labels), "le=\"+Inf\"");
+            }
+
+            metrics.add(total, labels, "_bucket");
         }
 
-        auto vm = RxVm::create(dataset, memory->scratchpad(), !hwAES, Assembly::NONE, 0);
+        metrics.add(m_sum.load(std::memory_order_relaxed) / 1e6, nullptr, "_sum");
+        metrics.add(total, nullptr, "_count");
+    }
+#   endif
+
+private:
+    static constexpr double kBounds[kBuckets - 1] = { 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000 };
+
+    std::atomic<uint64_t> m_counts[kBuckets]{};
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<uint64_t> m_errors{ 0 };
+    std::atomic<uint64_t> m_sum{ 0 };
+};
+
 
-        for (uint32_t nonce : bundle.nonces) {
-            *bundle.job.nonce() = nonce;
+constexpr double JobLatency::kBounds[];
+
+
+// Persistent GPU results verification thread, keeps scratchpad, CN context and RandomX VM between bundles
+class JobVerifier
+{
+public:
+    XMRIG_DISABLE_COPY_MOVE_DEFAULT(JobVerifier)
+
+    inline JobVerifier(MpscQueue<JobResult> &results, JobBatches &batches, JobLatency &latency, const std::shared_ptr<Async> &async, bool hwAES) :
+        m_hwAES(hwAES),
+        m_batches(batches),
+        m_latency(latency),
+        m_results(results),
+        m_async(async)
+    {
+        m_thread = std::thread(&JobVerifier::run, this);
+    }
 
-            randomx_calculate_hash(vm, bundle.job.blob(), bundle.job.size(), hash);
 
-            checkHash(bundle, results, nonce, hash, errors);
+    inline ~JobVerifier()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
         }
 
-        RxVm::destroy(vm);
+        m_cv.notify_one();
+        m_thread.join();
+
+#       ifdef XMRIG_ALGO_RANDOMX
+        RxVm::destroy(m_vm);
 #       endif
+
+        if (m_ctx[0]) {
+            CnCtx::release(m_ctx, 1);
+        }
+
+        delete m_memory;
     }
-    else if (algorithm.family() == Algorithm::ARGON2) {
-        errors += bundle.nonces.size(); // TODO ARGON2
+
+
+    inline void add(JobBundle &&bundle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_bundles.emplace_back(std::move(bundle));
+        }
+
+        m_cv.notify_one();
     }
-    else if (algorithm.family() == Algorithm::KAWPOW) {
-#       ifdef XMRIG_ALGO_KAWPOW
-        for (uint32_t nonce : bundle.nonces) {
-            *bundle.job.nonce() = nonce;
 
-            uint8_t header_hash[32];
-            uint64_t full_nonce;
-            memcpy(header_hash, bundle.job.blob(), sizeof(header_hash));
-            memcpy(&full_nonce, bundle.job.blob() + sizeof(header_hash), sizeof(full_nonce));
 
-            uint32_t output[8];
-            uint32_t mix_hash[8];
+private:
+    void run()
+    {
+        std::list<JobBundle> bundles;
+
+        while (true) {
             {
-                std::lock_guard<std::mutex> lock(KPCache::s_cacheMutex);
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this] { return !m_running || !m_bundles.empty(); });
 
-                KPCache::s_cache.init(bundle.job.height() / KPHash::EPOCH_LENGTH);
-                KPHash::calculate(KPCache::s_cache, bundle.job.height(), header_hash, full_nonce, output, mix_hash);
-            }
+                if (!m_running) {
+                    break;
+                }
 
-            for (size_t i = 0; i < sizeof(hash); ++i) {
-                hash[i] = ((uint8_t*)output)[sizeof(hash) - 1 - i];
+                m_bundles.swap(bundles);
             }
 
-            if (*reinterpret_cast<uint64_t*>(hash + 24) < bundle.job.target()) {
-                results.emplace_back(bundle.job, full_nonce, (uint8_t*)output, bundle.job.blob(), (uint8_t*)mix_hash);
+            for (JobBundle &bundle : bundles) {
+                verify(bundle);
+
+                m_latency.add(Chrono::highResolutionMSecs() - bundle.ts);
             }
-            else {
-                LOG_ERR("%s " RED_S "GPU #%u COMPUTE ERROR", backend_tag(bundle.job.backend()), bundle.device_index);
-                ++errors;
+
+            bundles.clear();
+            m_async->send();
+        }
+    }
+
+
+    inline void checkHash(const JobBundle &bundle, uint32_t nonce, uint8_t hash[32])
+    {
+        if (*reinterpret_cast<uint64_t*>(hash + 24) < bundle.job.target()) {
+            m_batches.open();
+            m_results.push(JobResult(bundle.job, nonce, hash));
+        }
+        else {
+            computeError(bundle);
+        }
+    }
+
+
+    inline void computeError(const JobBundle &bundle)
+    {
+        LOG_ERR("%s " RED_S "GPU #%u COMPUTE ERROR", backend_tag(bundle.job.backend()), bundle.device_index);
+
+        m_latency.addError();
+    }
+
+
+    uint8_t *scratchpad(const Algorithm &algorithm)
+    {
+        if (!m_memory || m_memory->size() < algorithm.l3()) {
+            if (m_ctx[0]) {
+                CnCtx::release(m_ctx, 1);
+                m_ctx[0] = nullptr;
             }
+
+#           ifdef XMRIG_ALGO_RANDOMX
+            RxVm::destroy(m_vm);
+            m_vm = nullptr;
+#           endif
+
+            delete m_memory;
+            m_memory = new VirtualMemory(algorithm.l3(), false, false, false);
         }
-#       endif
+
+        return m_memory->scratchpad();
     }
-    else {
-        cryptonight_ctx *ctx[1];
-        CnCtx::create(ctx, memory->scratchpad(), memory->size(), 1);
 
-        for (uint32_t nonce : bundle.nonces) {
-            *bundle.job.nonce() = nonce;
 
-            CnHash::fn(algorithm, hwAES ? CnHash::AV_SINGLE : CnHash::AV_SINGLE_SOFT, Assembly::NONE)(bundle.job.blob(), bundle.job.size(), hash, ctx, bundle.job.height());
+    void verify(JobBundle &bundle)
+    {
+        const auto &algorithm = bundle.job.algorithm();
+        alignas(16) uint8_t hash[32]{ 0 };
+
+        if (algorithm.family() == Algorithm::RANDOM_X) {
+#           ifdef XMRIG_ALGO_RANDOMX
+            RxDataset *dataset = Rx::acquire(bundle.job, bundle.node);
+            if (dataset == nullptr) {
+                for (size_t i = 0; i < bundle.nonces.size(); ++i) {
+                    m_latency.addError();
+                }
+
+                return;
+            }
+
+            uint8_t *memory = scratchpad(algorithm);
+
+            if (!m_vm || dataset != m_dataset || algorithm != m_rxAlgorithm || bundle.job.seed() != m_seed) {
+                RxVm::destroy(m_vm);
+
+                m_vm          = RxVm::create(dataset, memory, !m_hwAES, Assembly::NONE, 0);
+                m_dataset     = dataset;
+                m_rxAlgorithm = algorithm;
+                m_seed        = bundle.job.seed();
+            }
+
+            for (uint32_t nonce : bundle.nonces) {
+                *bundle.job.nonce() = nonce;
+
+                randomx_calculate_hash(m_vm, bundle.job.blob(), bundle.job.size(), hash);
+
+                checkHash(bundle, nonce, hash);
+            }
+
+            // The VM is kept for the next bundle, it is recreated above if the storage was initialized for another seed meanwhile.
+            Rx::release(dataset);
+#           endif
+        }
+        else if (algorithm.family() == Algorithm::ARGON2) {
+            for (size_t i = 0; i < bundle.nonces.size(); ++i) {
+                m_latency.addError(); // TODO ARGON2
+            }
+        }
+        else if (algorithm.family() == Algorithm::KAWPOW) {
+#           ifdef XMRIG_ALGO_KAWPOW
+            uint8_t header_hash[32];
+            memcpy(header_hash, bundle.job.blob(), sizeof(header_hash));
+
+            const auto cache = KPCache::get(bundle.job.height() / KPHash::EPOCH_LENGTH);
+            if (!cache) {
+                for (size_t i = 0; i < bundle.nonces.size(); ++i) {
+                    m_latency.addError();
+                }
+
+                return;
+            }
+
+            for (uint32_t nonce : bundle.nonces) {
+                *bundle.job.nonce() = nonce;
+
+                uint64_t full_nonce;
+                memcpy(&full_nonce, bundle.job.blob() + sizeof(header_hash), sizeof(full_nonce));
+
+                uint32_t output[8];
+                uint32_t mix_hash[8];
+                KPHash::calculate(*cache, bundle.job.height(), header_hash, full_nonce, output, mix_hash);
+
+                for (size_t i = 0; i < sizeof(hash); ++i) {
+                    hash[i] = ((uint8_t*)output)[sizeof(hash) - 1 - i];
+                }
+
+                if (*reinterpret_cast<uint64_t*>(hash + 24) < bundle.job.target()) {
+                    m_batches.open();
+                    m_results.push(JobResult(bundle.job, full_nonce, (uint8_t*)output, bundle.job.blob(), (uint8_t*)mix_hash));
+                }
+                else {
+                    computeError(bundle);
+                }
+            }
+#           endif
+        }
+        else {
+            uint8_t *memory = scratchpad(algorithm);
+
+            if (!m_ctx[0]) {
+                CnCtx::create(m_ctx, memory, m_memory->size(), 1);
+            }
+
+            for (uint32_t nonce : bundle.nonces) {
+                *bundle.job.nonce() = nonce;
 
-            checkHash(bundle, results, nonce, hash, errors);
+                CnHash::fn(algorithm, m_hwAES ? CnHash::AV_SINGLE : CnHash::AV_SINGLE_SOFT, Assembly::NONE)(bundle.job.blob(), bundle.job.size(), hash, m_ctx, bundle.job.height());
+
+                checkHash(bundle, nonce, hash);
+            }
         }
     }
 
-    delete memory;
-}
+
+    bool m_running = true;
+    const bool m_hwAES;
+    cryptonight_ctx *m_ctx[1]{};
+    JobBatches &m_batches;
+    JobLatency &m_latency;
+    MpscQueue<JobResult> &m_results;
+    std::condition_variable m_cv;
+    std::list<JobBundle> m_bundles;
+    std::mutex m_mutex;
+    std::shared_ptr<Async> m_async;
+    std::thread m_thread;
+    VirtualMemory *m_memory = nullptr;
+
+#   ifdef XMRIG_ALGO_RANDOMX
+    Algorithm m_rxAlgorithm;
+    Buffer m_seed;
+    randomx_vm *m_vm        = nullptr;
+    RxDataset *m_dataset    = nullptr;
+#   endif
+};
 #endif
 
 
-class JobResultsPrivate : public IAsyncListener
+class JobResultsPrivate : public IAsyncListener, public ITimerListener
 {
 public:
     XMRIG_DISABLE_COPY_MOVE_DEFAULT(JobResultsPrivate)
@@ -205,100 +518,135 @@ public:
         m_listener(listener)
     {
         m_async = std::make_shared<Async>(this);
+        m_timer = new Timer(this);
     }
 
 
-    ~JobResultsPrivate() override = default;
+    ~JobResultsPrivate() override
+    {
+        delete m_timer;
+
+#       if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
+        for (auto verifier : m_verifiers) {
+            delete verifier;
+        }
+#       endif
+    }
 
 
     inline void submit(const JobResult &result)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
+        m_batches.open();
         m_results.push_back(result);
 
         m_async->send();
     }
 
 
+    inline void setDelay(uint32_t delay) { m_delay = delay; }
+
+
 #   if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
-    inline void submit(const Job &job, uint32_t *results, size_t count, uint32_t device_index)
+    inline void submit(const Job &job, uint32_t *results, size_t count, uint32_t device_index, uint32_t node)
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_bundles.emplace_back(job, results, count, device_index);
+        JobVerifier *verifier = nullptr;
 
-        m_async->send();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (m_verifiers.empty()) {
+                const size_t threads = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1U), kMaxVerifyThreads);
+
+                for (size_t i = 0; i < threads; ++i) {
+                    m_verifiers.emplace_back(new JobVerifier(m_verified, m_batches, m_latency, m_async, m_hwAES));
+                }
+            }
+
+            // Results from the same device always go to the same thread, so they are verified and submitted in order
+            verifier = m_verifiers[device_index % m_verifiers.size()];
+        }
+
+        verifier->add(JobBundle(job, results, count, device_index, node));
     }
-#   endif
 
 
-protected:
-    inline void onAsync() override  { submit(); }
+#   ifdef XMRIG_FEATURE_API
+    inline rapidjson::Value toJSON(rapidjson::Document &doc) const { return m_latency.toJSON(doc); }
+#   endif
+#   endif
 
 
-private:
-#   if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
-    inline void submit()
+#   ifdef XMRIG_FEATURE_API
+    inline rapidjson::Value batchesToJSON(rapidjson::Document &doc) const { return m_batches.toJSON(doc); }
+
+    inline void toMetrics(Metrics &metrics) const
     {
-        std::list<JobBundle> bundles;
-        std::list<JobResult> results;
+        m_batches.toMetrics(metrics);
 
-        m_mutex.lock();
-        m_bundles.swap(bundles);
-        m_results.swap(results);
-        m_mutex.unlock();
+#       if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
+        m_latency.toMetrics(metrics);
+#       endif
+    }
+#   endif
 
-        for (const auto &result : results) {
-            m_listener->onJobResult(result);
-        }
 
-        if (bundles.empty()) {
-            return;
-        }
+protected:
+    inline void onTimer(const Timer *) override { submit(); }
 
-        auto baton = new JobBaton(std::move(bundles), m_listener, m_hwAES);
 
-        uv_queue_work(uv_default_loop(), &baton->req,
-            [](uv_work_t *req) {
-                auto baton = static_cast<JobBaton*>(req->data);
+    inline void onAsync() override
+    {
+        // With a delay results that arrive in a burst are collected and handed to the network together.
+        if (m_delay == 0) {
+            return submit();
+        }
 
-                for (JobBundle &bundle : baton->bundles) {
-                    getResults(bundle, baton->results, baton->errors, baton->hwAES);
-                }
-            },
-            [](uv_work_t *req, int) {
-                auto baton = static_cast<JobBaton*>(req->data);
+        if (!m_waiting) {
+            m_waiting = true;
+            m_timer->singleShot(m_delay);
+        }
+    }
 
-                for (const auto &result : baton->results) {
-                    baton->listener->onJobResult(result);
-                }
 
-                delete baton;
-            }
-        );
-    }
-#   else
+private:
     inline void submit()
     {
         std::list<JobResult> results;
 
+        m_waiting = false;
+
         m_mutex.lock();
         m_results.swap(results);
         m_mutex.unlock();
 
+        size_t count = results.size();
+
         for (const auto &result : results) {
             m_listener->onJobResult(result);
         }
+
+#       if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
+        count += m_verified.consume([this](JobResult &&result) { m_listener->onJobResult(result); });
+#       endif
+
+        m_batches.close(count);
     }
-#   endif
 
+    bool m_waiting      = false;
     const bool m_hwAES;
     IJobResultListener *m_listener;
+    JobBatches m_batches;
     std::list<JobResult> m_results;
     std::mutex m_mutex;
     std::shared_ptr<Async> m_async;
+    Timer *m_timer      = nullptr;
+    uint32_t m_delay    = 0;
 
 #   if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
-    std::list<JobBundle> m_bundles;
+    JobLatency m_latency;
+    MpscQueue<JobResult> m_verified;
+    std::vector<JobVerifier *> m_verifiers;
 #   endif
 };
 
@@ -315,6 +663,14 @@ void xmrig::JobResults::done(const Job &job)
 }
 
 
+void xmrig::JobResults::setDelay(uint32_t delay)
+{
+    if (handler) {
+        handler->setDelay(delay);
+    }
+}
+
+
 void xmrig::JobResults::setListener(IJobResultListener *listener, bool hwAES)
 {
     assert(handler == nullptr);
@@ -356,10 +712,34 @@ void xmrig::JobResults::submit(const JobResult &result)
 
 
 #if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
-void xmrig::JobResults::submit(const Job &job, uint32_t *results, size_t count, uint32_t device_index)
+void xmrig::JobResults::submit(const Job &job, uint32_t *results, size_t count, uint32_t device_index, uint32_t node)
+{
+    if (handler) {
+        handler->submit(job, results, count, device_index, node);
+    }
+}
+
+
+#ifdef XMRIG_FEATURE_API
+rapidjson::Value xmrig::JobResults::toJSON(rapidjson::Document &doc)
+{
+    return handler ? handler->toJSON(doc) : rapidjson::Value(rapidjson::kNullType);
+}
+#endif
+#endif
+
+
+#ifdef XMRIG_FEATURE_API
+rapidjson::Value xmrig::JobResults::batchesToJSON(rapidjson::Document &doc)
+{
+    return handler ? handler->batchesToJSON(doc) : rapidjson::Value(rapidjson::kNullType);
+}
+
+
+void xmrig::JobResults::toMetrics(Metrics &metrics)
 {
     if (handler) {
-        handler->submit(job, results, count, device_index);
+        handler->toMetrics(metrics);
     }
 }
 #endif
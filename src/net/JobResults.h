@@ -31,18 +31,23 @@
 #include <cstdint>
 
 
+#include "3rdparty/rapidjson/fwd.h"
+
+
 namespace xmrig {
 
 
 class IJobResultListener;
 class Job;
 class JobResult;
+class Metrics;
 
 
 class JobResults
 {
 public:
     static void done(const Job &job);
+    static void setDelay(uint32_t delay);
     static void setListener(IJobResultListener *listener, bool hwAES);
     static void stop();
     static void submit(const Job &job, uint32_t nonce, const uint8_t *result);
@@ -50,7 +55,16 @@ public:
     static void submit(const JobResult &result);
 
 #   if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
-    static void submit(const Job &job, uint32_t *results, size_t count, uint32_t device_index);
+    static void submit(const Job &job, uint32_t *results, size_t count, uint32_t device_index, uint32_t node);
+
+#   ifdef XMRIG_FEATURE_API
+    static rapidjson::Value toJSON(rapidjson::Document &doc);
+#   endif
+#   endif
+
+#   ifdef XMRIG_FEATURE_API
+    static rapidjson::Value batchesToJSON(rapidjson::Document &doc);
+    static void toMetrics(Metrics &metrics);
 #   endif
 };
 
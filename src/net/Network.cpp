@@ -61,6 +61,7 @@ xmrig::Network::Network(Controller *controller) :
     m_controller(controller)
 {
     JobResults::setListener(this, controller->config()->cpu().isHwAES());
+    JobResults::setDelay(controller->config()->pools().submitDelay());
     controller->addListener(this);
 
 #   ifdef XMRIG_FEATURE_API
@@ -149,6 +150,8 @@ void xmrig::Network::onActive(IStrategy *strategy, IClient *client)
 
 void xmrig::Network::onConfigChanged(Config *config, Config *previousConfig)
 {
+    JobResults::setDelay(config->pools().submitDelay());
+
     if (config->pools() == previousConfig->pools() || !config->pools().active()) {
         return;
     }
@@ -250,6 +253,13 @@ void xmrig::Network::onVerifyAlgorithm(IStrategy *, const IClient *, const Algor
 
 
 #ifdef XMRIG_FEATURE_API
+void xmrig::Network::onMetrics(Metrics &metrics)
+{
+    m_state->toMetrics(metrics, m_strategy);
+    JobResults::toMetrics(metrics);
+}
+
+
 void xmrig::Network::onRequest(IApiRequest &request)
 {
     if (request.type() == IApiRequest::REQ_SUMMARY) {
@@ -322,7 +332,7 @@ void xmrig::Network::getConnection(rapidjson::Value &reply, rapidjson::Document
     auto &allocator = doc.GetAllocator();
 
     reply.AddMember("algo",         m_state->algorithm().toJSON(), allocator);
-    reply.AddMember("connection",   m_state->getConnection(doc, version), allocator);
+    reply.AddMember("connection",   m_state->getConnection(doc, version, m_strategy), allocator);
 }
 
 
@@ -332,5 +342,10 @@ void xmrig::Network::getResults(rapidjson::Value &reply, rapidjson::Document &do
     auto &allocator = doc.GetAllocator();
 
     reply.AddMember("results", m_state->getResults(doc, version), allocator);
+    reply["results"].AddMember("batches", JobResults::batchesToJSON(doc), allocator);
+
+#   if defined(XMRIG_FEATURE_OPENCL) || defined(XMRIG_FEATURE_CUDA) || defined(XMRIG_FEATURE_VULKAN)
+    reply["results"].AddMember("verification", JobResults::toJSON(doc), allocator);
+#   endif
 }
 #endif
@@ -67,6 +67,7 @@ protected:
     void onVerifyAlgorithm(IStrategy *strategy, const  IClient *client, const Algorithm &algorithm, bool *ok) override;
 
 #   ifdef XMRIG_FEATURE_API
+    void onMetrics(Metrics &metrics) override;
     void onRequest(IApiRequest &request) override;
 #   endif
 
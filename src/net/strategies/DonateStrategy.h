@@ -52,6 +52,7 @@ protected:
     inline void onJobReceived(IClient *client, const Job &job, const rapidjson::Value &params) override                { setJob(client, job, params); }
     inline void onResultAccepted(IClient *client, const SubmitResult &result, const char *error) override              { setResult(client, result, error); }
     inline void onResultAccepted(IStrategy *, IClient *client, const SubmitResult &result, const char *error) override { setResult(client, result, error); }
+    inline void forEachClient(const ClientVisitor &visitor) const override                                             { m_strategy->forEachClient(visitor); }
     inline void resume() override                                                                                      {}
 
     int64_t submit(const JobResult &result) override;